@@ -1,4 +1,5 @@
 #include "ICs.h"
+#include "group.h"
 
 bool row_is_inside_ic(IC* ic, uint row) {
     uint min_row, max_row;
@@ -47,6 +48,7 @@ bool try_to_move_ic(ICList list, IC* ic, int32 d_column, int32 d_row) {
     }
 
     // NOTE(erick): No collisions. We can move the IC.
+    record_placement_change(list, ic);
     ic->location.column += d_column;
     ic->location.row += d_row;
     return true;
@@ -54,7 +56,11 @@ bool try_to_move_ic(ICList list, IC* ic, int32 d_column, int32 d_row) {
 
 void move_selection(ICList list, Selection* selection, int32 d_column, int32 d_row) {
     if(selection->state == SELECTING) {
-        bool success = try_to_move_ic(list, selection->selected_ic, d_column, d_row);
+        // NOTE(erick): A selected member of the group takes the group along.
+        ICGroup* group = &selection->group;
+        bool success = group_contains(group, selection->selected_ic) ?
+            try_to_move_group(list, group, d_column, d_row) :
+            try_to_move_ic(list, selection->selected_ic, d_column, d_row);
         if(!success) {
             return;
         }
@@ -79,13 +85,16 @@ void try_to_select_ic(ICList list, Selection* selection) {
         if(row_is_inside_ic(ic, selection->row)) {
             selection->selected_ic = ic;
             selection->state = SELECTING;
+            selection->highlighted_pin = 0;
 
             return;
         }
     }
 }
 
-void rotate_ic(IC* ic) {
+void rotate_ic(ICList list, IC* ic) {
+    record_placement_change(list, ic);
+
     if(ic->location.orientation == UP) {
         ic->location.orientation = DOWN;
         ic->location.row += (ic->n_pins / 2 - 1);
@@ -106,20 +115,27 @@ uint count_outside_ics(ICList ic_list) {
     return count;
 }
 
-bool move_outside_ic_in(ICList ic_list, uint which, uint row, uint column) {
-    IC* to_move = NULL;
+IC* nth_outside_ic(ICList ic_list, uint which) {
     for(usize ic_index = 0; ic_index < ic_list.count; ic_index++) {
         IC* current_ic = ic_list.data + ic_index;
         if(current_ic->location.column == 0) {
             if(which == 0) {
-                to_move = current_ic;
-                break;
+                return current_ic;
             } else { which--; }
         }
     }
 
+    return NULL;
+}
+
+bool move_outside_ic_in(ICList ic_list, uint which, uint row, uint column) {
+    IC* to_move = nth_outside_ic(ic_list, which);
     if(!to_move) { return false; }
 
+    return move_ic_in(ic_list, to_move, row, column);
+}
+
+bool move_ic_in(ICList ic_list, IC* to_move, uint row, uint column) {
     to_move->location.row = 0;
     // to_move->location.column = 0; NOTE(erick): Already is zero!!
     to_move->location.orientation = UP;
@@ -127,6 +143,27 @@ bool move_outside_ic_in(ICList ic_list, uint which, uint row, uint column) {
     return try_to_move_ic(ic_list, to_move, column, row);
 }
 
-void put_ic_outside(IC* ic) {
+void put_ic_outside(ICList list, IC* ic) {
+    record_placement_change(list, ic);
     ic->location.column = 0;
 }
+
+// NOTE(erick): Must be called before the location changes.
+void record_placement_change(ICList list, IC* ic) {
+    PlacementJournal* journal = list.journal;
+    if(!journal) { return; }
+
+    if(journal->count == journal->capacity) {
+        journal->capacity = journal->capacity ? journal->capacity * 2 : 64;
+        journal->changes = realloc(journal->changes,
+                                   journal->capacity * sizeof(PlacementChange));
+    }
+
+    PlacementChange change = {.ic = ic, .old_location = ic->location};
+    journal->changes[journal->count] = change;
+    journal->count++;
+}
+
+void clear_placement_journal(PlacementJournal* journal) {
+    journal->count = 0;
+}
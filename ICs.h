@@ -2,21 +2,8 @@
 #define ICS_H 1
 
 #include <stdlib.h>
-#include <stdint.h>
-#include <stdbool.h>
-
-typedef intptr_t isize;
-typedef int8_t   int8;
-typedef int16_t  int16;
-typedef int32_t  int32;
-typedef int64_t  int64;
-
-typedef size_t       usize;
-typedef uint8_t      uint8;
-typedef uint16_t     uint16;
-typedef uint32_t     uint32;
-typedef uint64_t     uint64;
-typedef unsigned int uint;
+
+#include "types.h"
 
 typedef enum {
     UP,
@@ -58,13 +45,33 @@ typedef struct {
     Pin* pins;
     uint n_pins;
 
+    // NOTE(erick): Identifies the IC in the project file. See assign_ic_ids.
+    uint64 id;
+
     BreadboardLocation location;
 } IC;
 
+// NOTE(erick): Every change of an IC location is appended to the journal
+//  (when the list has one) so whoever caches something derived from the
+//  placement only needs to update what changed.
+typedef struct {
+    IC* ic;
+    BreadboardLocation old_location;
+} PlacementChange;
+
+typedef struct {
+    PlacementChange* changes;
+    usize count;
+    usize capacity;
+} PlacementJournal;
+
 typedef struct {
     IC* data;
     usize count;
     usize capacity;
+
+    // NOTE(erick): May be NULL.
+    PlacementJournal* journal;
 } ICList;
 
 typedef enum {
@@ -72,12 +79,30 @@ typedef enum {
     SELECTING,
 } SelectionState;
 
+// NOTE(erick): ICs on the board that move together. See group.h.
+typedef struct {
+    IC** ics;
+    usize count;
+    usize capacity;
+} ICGroup;
+
 typedef struct {
     IC* selected_ic;
 
     SelectionState state;
     uint row;
     uint column;
+
+    // NOTE(erick): Pin of the selected IC whose net is highlighted, counting
+    //  from 1. 0 for none.
+    uint highlighted_pin;
+
+    ICGroup group;
+    // NOTE(erick): Corner of the rectangle being added to the group. The
+    //  other one is the selection.
+    bool has_anchor;
+    uint anchor_row;
+    uint anchor_column;
 } Selection;
 
 typedef struct _Connections {
@@ -101,9 +126,14 @@ bool row_is_inside_ic(IC*, uint);
 bool try_to_move_ic(ICList, IC*, int32, int32);
 void move_selection(ICList, Selection*, int32, int32);
 void try_to_select_ic(ICList, Selection*);
-void rotate_ic(IC*);
+void rotate_ic(ICList, IC*);
 uint count_outside_ics(ICList);
+IC* nth_outside_ic(ICList, uint);
 bool move_outside_ic_in(ICList, uint, uint, uint);
-void put_ic_outside(IC*);
+bool move_ic_in(ICList, IC*, uint, uint);
+void put_ic_outside(ICList, IC*);
+
+void record_placement_change(ICList, IC*);
+void clear_placement_journal(PlacementJournal*);
 
 #endif
@@ -0,0 +1,327 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "atlas.h"
+#include "profiler.h"
+
+// NOTE(erick): Empty space around every glyph, so linear filtering never
+//  samples a neighbour.
+#define GLYPH_PADDING 1
+
+// NOTE(erick): A generous guess of the area the whole glyph set needs, in
+//  squared line heights.
+#define GLYPH_SET_AREA 96
+
+// NOTE(erick): renderer may be NULL, then only the coverage is kept.
+void init_glyph_atlas(GlyphAtlas* atlas, SDL_Renderer* renderer, TTF_Font* font) {
+    memset(atlas, 0, sizeof(GlyphAtlas));
+    if(!font) { return; }
+
+    atlas->line_skip = TTF_FontLineSkip(font);
+    atlas->size = ATLAS_SIZE;
+    while(atlas->size * atlas->size < GLYPH_SET_AREA * atlas->line_skip * atlas->line_skip) {
+        atlas->size *= 2;
+    }
+
+    if(renderer) {
+        atlas->texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888,
+                                           SDL_TEXTUREACCESS_STATIC,
+                                           atlas->size, atlas->size);
+        if(!atlas->texture) {
+            fprintf(stderr, "Failed to create glyph atlas: %s\n", SDL_GetError());
+        } else {
+            SDL_SetTextureBlendMode(atlas->texture, SDL_BLENDMODE_BLEND);
+
+            // NOTE(erick): The texture starts with garbage. Clearing it once
+            //  means the padding around the glyphs is transparent.
+            void* zeros = calloc(atlas->size * atlas->size, 4);
+            SDL_UpdateTexture(atlas->texture, NULL, zeros, atlas->size * 4);
+            free(zeros);
+        }
+    }
+
+    atlas->coverage = (uint8*) calloc(atlas->size * atlas->size, 1);
+
+    atlas->font = font;
+    atlas->shelf_x = GLYPH_PADDING;
+    atlas->shelf_y = GLYPH_PADDING;
+}
+
+void free_glyph_atlas(GlyphAtlas* atlas) {
+    if(atlas->texture) { SDL_DestroyTexture(atlas->texture); }
+    free(atlas->coverage);
+    memset(atlas, 0, sizeof(GlyphAtlas));
+}
+
+static bool is_atlas_glyph(char c) {
+    return c >= ATLAS_FIRST_GLYPH && c <= ATLAS_LAST_GLYPH;
+}
+
+static bool cache_glyph(GlyphAtlas* atlas, char c) {
+    AtlasGlyph* glyph = atlas->glyphs + (c - ATLAS_FIRST_GLYPH);
+    if(glyph->cached) { return true; }
+
+    int min_x, max_x, min_y, max_y, advance;
+    if(TTF_GlyphMetrics(atlas->font, c, &min_x, &max_x, &min_y, &max_y, &advance) != 0) {
+        return false;
+    }
+
+    SDL_Color white = {.r = 0xff, .g = 0xff, .b = 0xff, .a = 0xff};
+    SDL_Surface* rendered = TTF_RenderGlyph_Blended(atlas->font, c, white);
+    if(!rendered) { return false; }
+    profile_count(PROFILE_TEXT_RASTERIZATIONS);
+
+    SDL_Surface* surf = SDL_ConvertSurfaceFormat(rendered, SDL_PIXELFORMAT_ARGB8888, 0);
+    SDL_FreeSurface(rendered);
+    if(!surf) { return false; }
+
+    if(atlas->shelf_x + surf->w + GLYPH_PADDING > atlas->size) {
+        atlas->shelf_x = GLYPH_PADDING;
+        atlas->shelf_y += atlas->shelf_h + GLYPH_PADDING;
+        atlas->shelf_h = 0;
+    }
+
+    if(atlas->shelf_y + surf->h + GLYPH_PADDING > atlas->size) {
+        fprintf(stderr, "Glyph atlas is full.\n");
+        SDL_FreeSurface(surf);
+        return false;
+    }
+
+    glyph->rect.x = atlas->shelf_x;
+    glyph->rect.y = atlas->shelf_y;
+    glyph->rect.w = surf->w;
+    glyph->rect.h = surf->h;
+    // NOTE(erick): SDL_ttf moves the glyph right when it starts before the pen.
+    glyph->offset_x = min_x < 0 ? min_x : 0;
+    glyph->advance = advance;
+    glyph->cached = true;
+
+    if(atlas->texture) {
+        SDL_UpdateTexture(atlas->texture, &glyph->rect, surf->pixels, surf->pitch);
+    }
+
+    for(int y = 0; y < surf->h; y++) {
+        uint32* src = (uint32*) ((uint8*) surf->pixels + y * surf->pitch);
+        uint8* dest = atlas->coverage + (glyph->rect.y + y) * atlas->size + glyph->rect.x;
+
+        for(int x = 0; x < surf->w; x++) {
+            dest[x] = (uint8) (src[x] >> 24);
+        }
+    }
+
+    SDL_FreeSurface(surf);
+
+    atlas->shelf_x += glyph->rect.w + GLYPH_PADDING;
+    if(glyph->rect.h > atlas->shelf_h) { atlas->shelf_h = glyph->rect.h; }
+
+    return true;
+}
+
+// NOTE(erick): Returns false if some glyph can't be drawn from the atlas.
+bool cache_glyphs(GlyphAtlas* atlas, char* text) {
+    if(!atlas->coverage) { return false; }
+
+    for(char* c = text; *c; c++) {
+        if(*c == '\n') { continue; }
+        if(!is_atlas_glyph(*c)) { return false; }
+        if(!cache_glyph(atlas, *c)) { return false; }
+    }
+
+    return true;
+}
+
+// NOTE(erick): Size of the text as SDL_ttf would render it. Lines are
+//  separated by '\n'.
+void measure_text(GlyphAtlas* atlas, char* text, int* w, int* h) {
+    *w = 0;
+    *h = 0;
+    if(!atlas->font) { return; }
+
+    char line[1024];
+    char* line_begin = text;
+    uint n_lines = 0;
+    while(true) {
+        char* line_end = strchr(line_begin, '\n');
+        usize len = line_end ? (usize) (line_end - line_begin) : strlen(line_begin);
+        if(len >= sizeof(line)) { len = sizeof(line) - 1; }
+
+        memcpy(line, line_begin, len);
+        line[len] = '\0';
+
+        int line_w = 0, line_h = 0;
+        TTF_SizeText(atlas->font, line, &line_w, &line_h);
+        if(line_w > *w) { *w = line_w; }
+        n_lines++;
+
+        if(!line_end) { break; }
+        line_begin = line_end + 1;
+    }
+
+    *h = (n_lines - 1) * atlas->line_skip + TTF_FontHeight(atlas->font);
+}
+
+// NOTE(erick): Renders the text on its own, for the glyphs the atlas can't
+//  hold. Lines are separated by '\n' and laid out as measure_text measures
+//  them. The surface is ARGB8888, NULL on errors.
+SDL_Surface* render_text_surface(GlyphAtlas* atlas, char* text, SDL_Color color) {
+    int w, h;
+    measure_text(atlas, text, &w, &h);
+    if(!w || !h) { return NULL; }
+
+    SDL_Surface* result = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32,
+                                                         SDL_PIXELFORMAT_ARGB8888);
+    if(!result) { return NULL; }
+    SDL_FillRect(result, NULL, 0);
+
+    char line[1024];
+    char* line_begin = text;
+    int line_y = 0;
+    while(true) {
+        char* line_end = strchr(line_begin, '\n');
+        usize len = line_end ? (usize) (line_end - line_begin) : strlen(line_begin);
+        if(len >= sizeof(line)) { len = sizeof(line) - 1; }
+
+        memcpy(line, line_begin, len);
+        line[len] = '\0';
+
+        if(len) {
+            SDL_Surface* line_surf = TTF_RenderText_Blended(atlas->font, line, color);
+            if(!line_surf) {
+                SDL_FreeSurface(result);
+                return NULL;
+            }
+            profile_count(PROFILE_TEXT_RASTERIZATIONS);
+
+            // NOTE(erick): Copied as is, lines never overlap.
+            SDL_SetSurfaceBlendMode(line_surf, SDL_BLENDMODE_NONE);
+            SDL_Rect line_rect = {.x = 0, .y = line_y, .w = line_surf->w, .h = line_surf->h};
+            SDL_BlitSurface(line_surf, NULL, result, &line_rect);
+            SDL_FreeSurface(line_surf);
+        }
+
+        if(!line_end) { break; }
+        line_begin = line_end + 1;
+        line_y += atlas->line_skip;
+    }
+
+    return result;
+}
+
+static void push_quad(GlyphVertices* out, SDL_FPoint p0, SDL_FPoint p1,
+                      SDL_FPoint uv0, SDL_FPoint uv1, SDL_Color color) {
+    if(out->n_vertices + 4 > out->vertices_capacity) {
+        out->vertices_capacity = out->vertices_capacity ? out->vertices_capacity * 2 : 1024;
+        out->vertices = realloc(out->vertices, out->vertices_capacity * sizeof(SDL_Vertex));
+    }
+
+    if(out->n_indices + 6 > out->indices_capacity) {
+        out->indices_capacity = out->indices_capacity ? out->indices_capacity * 2 : 1536;
+        out->indices = realloc(out->indices, out->indices_capacity * sizeof(int));
+    }
+
+    int first = out->n_vertices;
+    SDL_Vertex* v = out->vertices + first;
+
+    v[0].position.x = p0.x; v[0].position.y = p0.y;
+    v[0].tex_coord.x = uv0.x; v[0].tex_coord.y = uv0.y;
+
+    v[1].position.x = p1.x; v[1].position.y = p0.y;
+    v[1].tex_coord.x = uv1.x; v[1].tex_coord.y = uv0.y;
+
+    v[2].position.x = p1.x; v[2].position.y = p1.y;
+    v[2].tex_coord.x = uv1.x; v[2].tex_coord.y = uv1.y;
+
+    v[3].position.x = p0.x; v[3].position.y = p1.y;
+    v[3].tex_coord.x = uv0.x; v[3].tex_coord.y = uv1.y;
+
+    for(uint i = 0; i < 4; i++) { v[i].color = color; }
+    out->n_vertices += 4;
+
+    int* index = out->indices + out->n_indices;
+    index[0] = first + 0;
+    index[1] = first + 1;
+    index[2] = first + 2;
+    index[3] = first + 0;
+    index[4] = first + 2;
+    index[5] = first + 3;
+    out->n_indices += 6;
+}
+
+// NOTE(erick): The text is stretched to dest, which is in target coordinates.
+//  Only rotations of 0 and 180 degrees (around the center of dest) are
+//  supported, those are the only ones we use. cache_glyphs must have
+//  succeeded for this text.
+void append_text_vertices(GlyphAtlas* atlas, char* text, SDL_Rect dest,
+                          double rotation, SDL_Color color, GlyphVertices* out) {
+    int text_w, text_h;
+    measure_text(atlas, text, &text_w, &text_h);
+    if(!text_w || !text_h) { return; }
+
+    float scale_x = (float) dest.w / text_w;
+    float scale_y = (float) dest.h / text_h;
+    bool flip = rotation > 90.0 && rotation < 270.0;
+
+    float center_x = dest.x + dest.w / 2.0f;
+    float center_y = dest.y + dest.h / 2.0f;
+
+    int pen_x = 0;
+    int pen_y = 0;
+    char previous = 0;
+    for(char* c = text; *c; c++) {
+        if(*c == '\n') {
+            pen_x = 0;
+            pen_y += atlas->line_skip;
+            previous = 0;
+            continue;
+        }
+
+        AtlasGlyph* glyph = atlas->glyphs + (*c - ATLAS_FIRST_GLYPH);
+        if(previous) {
+            pen_x += TTF_GetFontKerningSizeGlyphs(atlas->font, previous, *c);
+        }
+
+        SDL_FPoint p0 = {.x = dest.x + (pen_x + glyph->offset_x) * scale_x,
+                         .y = dest.y + pen_y * scale_y};
+        SDL_FPoint p1 = {.x = p0.x + glyph->rect.w * scale_x,
+                         .y = p0.y + glyph->rect.h * scale_y};
+        SDL_FPoint uv0 = {.x = (float) glyph->rect.x / atlas->size,
+                          .y = (float) glyph->rect.y / atlas->size};
+        SDL_FPoint uv1 = {.x = (float) (glyph->rect.x + glyph->rect.w) / atlas->size,
+                          .y = (float) (glyph->rect.y + glyph->rect.h) / atlas->size};
+
+        if(flip) {
+            // NOTE(erick): Rotating by 180 degrees swaps the corners.
+            SDL_FPoint rotated0 = {.x = 2 * center_x - p1.x, .y = 2 * center_y - p1.y};
+            SDL_FPoint rotated1 = {.x = 2 * center_x - p0.x, .y = 2 * center_y - p0.y};
+            SDL_FPoint swapped0 = uv1;
+            SDL_FPoint swapped1 = uv0;
+
+            push_quad(out, rotated0, rotated1, swapped0, swapped1, color);
+        } else {
+            push_quad(out, p0, p1, uv0, uv1, color);
+        }
+
+        pen_x += glyph->advance;
+        previous = *c;
+    }
+}
+
+void submit_glyph_vertices(GlyphAtlas* atlas, SDL_Renderer* renderer,
+                           GlyphVertices* vertices) {
+    if(vertices->n_indices) {
+        SDL_RenderGeometry(renderer, atlas->texture, vertices->vertices,
+                           vertices->n_vertices, vertices->indices,
+                           vertices->n_indices);
+        profile_count(PROFILE_DRAW_CALLS);
+    }
+
+    vertices->n_vertices = 0;
+    vertices->n_indices = 0;
+}
+
+void free_glyph_vertices(GlyphVertices* vertices) {
+    free(vertices->vertices);
+    free(vertices->indices);
+    memset(vertices, 0, sizeof(GlyphVertices));
+}
@@ -0,0 +1,69 @@
+#ifndef ATLAS_H
+#define ATLAS_H 1
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+
+#include "ICs.h"
+
+// NOTE(erick): One texture per font holding every glyph we have drawn so far.
+//  Glyphs are rasterized in white the first time they are needed and text is
+//  drawn as quads colored by their vertices, so one glyph serves every color.
+//  Only printable ASCII goes in the atlas. Atlases are ATLAS_SIZE wide, or
+//  larger for fonts too big to fit every glyph in that (print fonts).
+#define ATLAS_SIZE 1024
+#define ATLAS_FIRST_GLYPH ' '
+#define ATLAS_LAST_GLYPH  '~'
+#define ATLAS_N_GLYPHS (ATLAS_LAST_GLYPH - ATLAS_FIRST_GLYPH + 1)
+
+typedef struct {
+    bool cached;
+    // NOTE(erick): Where the glyph is in the atlas. The glyph is as tall as a
+    //  line of text and starts at the pen position plus offset_x.
+    SDL_Rect rect;
+    int offset_x;
+    int advance;
+} AtlasGlyph;
+
+typedef struct {
+    TTF_Font* font;
+    // NOTE(erick): NULL when there is no renderer (e.g. the software renderer).
+    SDL_Texture* texture;
+    // NOTE(erick): Alpha of every atlas pixel, size * size bytes, for drawing
+    //  without the GPU.
+    uint8* coverage;
+    int size;
+
+    AtlasGlyph glyphs[ATLAS_N_GLYPHS];
+
+    // NOTE(erick): Glyphs are packed in shelves, left to right.
+    int shelf_x;
+    int shelf_y;
+    int shelf_h;
+
+    int line_skip;
+} GlyphAtlas;
+
+typedef struct {
+    SDL_Vertex* vertices;
+    int n_vertices;
+    int vertices_capacity;
+
+    int* indices;
+    int n_indices;
+    int indices_capacity;
+} GlyphVertices;
+
+void init_glyph_atlas(GlyphAtlas*, SDL_Renderer*, TTF_Font*);
+void free_glyph_atlas(GlyphAtlas*);
+
+bool cache_glyphs(GlyphAtlas*, char*);
+void measure_text(GlyphAtlas*, char*, int*, int*);
+SDL_Surface* render_text_surface(GlyphAtlas*, char*, SDL_Color);
+
+void append_text_vertices(GlyphAtlas*, char*, SDL_Rect, double, SDL_Color,
+                          GlyphVertices*);
+void submit_glyph_vertices(GlyphAtlas*, SDL_Renderer*, GlyphVertices*);
+void free_glyph_vertices(GlyphVertices*);
+
+#endif
@@ -0,0 +1,187 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "batch.h"
+#include "profiler.h"
+
+static bool same_color(SDL_Color a, SDL_Color b) {
+    return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+}
+
+static RectBucket* find_bucket(RenderBatch* batch, BatchLayer layer, SDL_Color color) {
+    RectBucket* buckets = batch->buckets[layer];
+    uint n_buckets = batch->n_buckets[layer];
+
+    for(uint i = 0; i < n_buckets; i++) {
+        if(same_color(buckets[i].color, color)) { return buckets + i; }
+    }
+
+    if(n_buckets == BATCH_MAX_COLORS) { return NULL; }
+
+    // NOTE(erick): Buckets are reused, rects may already be allocated.
+    RectBucket* result = buckets + n_buckets;
+    result->color = color;
+    result->count = 0;
+    batch->n_buckets[layer]++;
+
+    return result;
+}
+
+void batch_rect(RenderBatch* batch, SDL_Renderer* renderer, BatchLayer layer,
+                SDL_Color color, SDL_Rect rect) {
+    RectBucket* bucket = find_bucket(batch, layer, color);
+    if(!bucket) {
+        // NOTE(erick): Too many colors in this layer. Drawing what we have
+        //  keeps the order right. Without a renderer there is nowhere to draw.
+        if(!renderer) {
+            fprintf(stderr, "Too many colors in batch layer (%d).\n", layer);
+            return;
+        }
+
+        flush_batch(batch, renderer);
+        bucket = find_bucket(batch, layer, color);
+    }
+
+    if(bucket->count == bucket->capacity) {
+        bucket->capacity = bucket->capacity ? bucket->capacity * 2 : 256;
+        bucket->rects = realloc(bucket->rects, bucket->capacity * sizeof(SDL_Rect));
+    }
+
+    bucket->rects[bucket->count] = rect;
+    bucket->count++;
+}
+
+static usize copy_to_arena(RenderBatch* batch, char* text) {
+    usize len = strlen(text) + 1;
+    while(batch->arena_used + len > batch->arena_capacity) {
+        batch->arena_capacity = batch->arena_capacity ? batch->arena_capacity * 2 : 4096;
+        batch->text_arena = realloc(batch->text_arena, batch->arena_capacity);
+    }
+
+    usize result = batch->arena_used;
+    memcpy(batch->text_arena + result, text, len);
+    batch->arena_used += len;
+
+    return result;
+}
+
+// NOTE(erick): dest is in target coordinates. The text is copied, the caller
+//  may reuse its buffer.
+void batch_text(RenderBatch* batch, GlyphAtlas* atlas, SDL_Color color, char* text,
+                SDL_Rect dest, double rotation) {
+    if(!atlas->font) { return; }
+
+    if(batch->n_texts == batch->texts_capacity) {
+        batch->texts_capacity = batch->texts_capacity ? batch->texts_capacity * 2 : 256;
+        batch->texts = realloc(batch->texts, batch->texts_capacity * sizeof(BatchedText));
+    }
+
+    BatchedText* batched = batch->texts + batch->n_texts;
+    batched->atlas = atlas;
+    batched->color = color;
+    batched->text_offset = copy_to_arena(batch, text);
+    batched->dest = dest;
+    batched->rotation = rotation;
+
+    batch->n_texts++;
+}
+
+// NOTE(erick): The slow path, for text with glyphs the atlas doesn't have.
+//  Lines are broken at '\n' like the atlas path does.
+static void draw_text_texture(BatchedText* batched, char* text, SDL_Renderer* renderer) {
+    SDL_Surface* text_surf = render_text_surface(batched->atlas, text, batched->color);
+    if(!text_surf) { return; }
+
+    SDL_Texture* text_texture = SDL_CreateTextureFromSurface(renderer, text_surf);
+    SDL_FreeSurface(text_surf);
+    profile_count(PROFILE_TEXTURE_CREATIONS);
+
+    SDL_RenderCopyEx(renderer, text_texture, NULL, &batched->dest, batched->rotation,
+                     NULL, SDL_FLIP_NONE);
+    profile_count(PROFILE_DRAW_CALLS);
+
+    SDL_DestroyTexture(text_texture);
+}
+
+static int compare_texts(const void* a, const void* b) {
+    const BatchedText* ta = (const BatchedText*) a;
+    const BatchedText* tb = (const BatchedText*) b;
+
+    if(ta->atlas != tb->atlas) { return ta->atlas < tb->atlas ? -1 : 1; }
+    return (ta->text_offset > tb->text_offset) - (ta->text_offset < tb->text_offset);
+}
+
+void flush_batch(RenderBatch* batch, SDL_Renderer* renderer) {
+    for(uint layer = 0; layer < BATCH_LAYER_COUNT; layer++) {
+        for(uint i = 0; i < batch->n_buckets[layer]; i++) {
+            RectBucket* bucket = batch->buckets[layer] + i;
+            if(!bucket->count) { continue; }
+
+            SDL_Color c = bucket->color;
+            SDL_SetRenderDrawColor(renderer, c.r, c.g, c.b, c.a);
+            SDL_RenderFillRects(renderer, bucket->rects, (int) bucket->count);
+            profile_count(PROFILE_DRAW_CALLS);
+        }
+    }
+
+    // NOTE(erick): Text never overlaps, so we are free to group it by atlas.
+    qsort(batch->texts, batch->n_texts, sizeof(BatchedText), compare_texts);
+
+    GlyphVertices* vertices = &batch->glyph_vertices;
+    for(usize i = 0; i < batch->n_texts; i++) {
+        BatchedText* batched = batch->texts + i;
+        char* text = batch->text_arena + batched->text_offset;
+
+        if(batched->atlas->texture && cache_glyphs(batched->atlas, text)) {
+            append_text_vertices(batched->atlas, text, batched->dest,
+                                 batched->rotation, batched->color, vertices);
+        } else {
+            draw_text_texture(batched, text, renderer);
+        }
+
+        bool last_of_atlas = i + 1 == batch->n_texts ||
+            batch->texts[i + 1].atlas != batched->atlas;
+        if(last_of_atlas) {
+            submit_glyph_vertices(batched->atlas, renderer, vertices);
+        }
+    }
+
+    clear_batch(batch);
+}
+
+void clear_batch(RenderBatch* batch) {
+    for(uint layer = 0; layer < BATCH_LAYER_COUNT; layer++) {
+        for(uint i = 0; i < batch->n_buckets[layer]; i++) {
+            batch->buckets[layer][i].count = 0;
+        }
+        batch->n_buckets[layer] = 0;
+    }
+
+    batch->n_texts = 0;
+    batch->arena_used = 0;
+}
+
+void free_batch(RenderBatch* batch) {
+    for(uint layer = 0; layer < BATCH_LAYER_COUNT; layer++) {
+        for(uint i = 0; i < BATCH_MAX_COLORS; i++) {
+            free(batch->buckets[layer][i].rects);
+            batch->buckets[layer][i].rects = NULL;
+            batch->buckets[layer][i].capacity = 0;
+            batch->buckets[layer][i].count = 0;
+        }
+        batch->n_buckets[layer] = 0;
+    }
+
+    free(batch->texts);
+    batch->texts = NULL;
+    batch->n_texts = 0;
+    batch->texts_capacity = 0;
+
+    free(batch->text_arena);
+    batch->text_arena = NULL;
+    batch->arena_used = 0;
+    batch->arena_capacity = 0;
+
+    free_glyph_vertices(&batch->glyph_vertices);
+}
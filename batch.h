@@ -0,0 +1,67 @@
+#ifndef BATCH_H
+#define BATCH_H 1
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+
+#include "ICs.h"
+#include "atlas.h"
+
+// NOTE(erick): Rects are collected per layer and per color and submitted with
+//  one SDL_RenderFillRects per bucket, so the number of draw calls depends on
+//  the number of colors, not on the number of ICs. Layers are drawn in order.
+//  Rects of different colors in the same layer must not overlap, since the
+//  order between buckets is not kept.
+typedef enum {
+    // NOTE(erick): Grid lines and IC outlines.
+    BATCH_LAYER_LINES,
+    BATCH_LAYER_IC_INSIDE,
+    BATCH_LAYER_IC_MARK,
+
+    BATCH_LAYER_COUNT,
+} BatchLayer;
+
+#define BATCH_MAX_COLORS 8
+
+typedef struct {
+    SDL_Color color;
+    SDL_Rect* rects;
+    usize count;
+    usize capacity;
+} RectBucket;
+
+typedef struct {
+    GlyphAtlas* atlas;
+    SDL_Color color;
+    // NOTE(erick): Offset into the text arena of the batch.
+    usize text_offset;
+    SDL_Rect dest;
+    double rotation;
+} BatchedText;
+
+// NOTE(erick): Memory is kept between flushes, so after the first frames a
+//  batch does no allocations.
+typedef struct {
+    RectBucket buckets[BATCH_LAYER_COUNT][BATCH_MAX_COLORS];
+    uint n_buckets[BATCH_LAYER_COUNT];
+
+    // NOTE(erick): Text is drawn after every rect, one SDL_RenderGeometry per
+    //  atlas. Text that can't come from an atlas is drawn on its own.
+    BatchedText* texts;
+    usize n_texts;
+    usize texts_capacity;
+
+    char* text_arena;
+    usize arena_used;
+    usize arena_capacity;
+
+    GlyphVertices glyph_vertices;
+} RenderBatch;
+
+void batch_rect(RenderBatch*, SDL_Renderer*, BatchLayer, SDL_Color, SDL_Rect);
+void batch_text(RenderBatch*, GlyphAtlas*, SDL_Color, char*, SDL_Rect, double);
+void flush_batch(RenderBatch*, SDL_Renderer*);
+void clear_batch(RenderBatch*);
+void free_batch(RenderBatch*);
+
+#endif
@@ -0,0 +1,304 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+#include "bread_placer.h"
+#include "draw.h"
+#include "workload.h"
+
+// NOTE(erick): Every benchmark prints one JSON object per line to stdout so
+//  results can be appended to a file and compared across versions. Progress
+//  and warnings go to stderr.
+
+#ifndef BENCH_REVISION
+#define BENCH_REVISION "unknown"
+#endif
+
+// NOTE(erick): Each measurement is repeated until it takes at least this long.
+#define MIN_BENCH_SECONDS 0.25
+
+static double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (double) ts.tv_sec + (double) ts.tv_nsec / 1e9;
+}
+
+static uint64 rng_state = 0x9e3779b97f4a7c15ull;
+
+static uint32 next_random() {
+    // NOTE(erick): xorshift64*. We want the same sequence on every run.
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+
+    return (uint32) ((rng_state * 0x2545f4914f6cdd1dull) >> 32);
+}
+
+static Workload generated_workload(uint n_ics, float occupancy) {
+    WorkloadParams params = default_workload_params();
+    params.n_ics = n_ics;
+    params.occupancy = occupancy;
+
+    return generate_workload(&params);
+}
+
+// NOTE(erick): The generated files are always valid.
+static ICList read_generated_list(FILE* file) {
+    ProjectContext context = new_project_context(stderr);
+
+    ICList result;
+    int error = read_ic_list_file(&context, file, &result);
+    if(error) { exit(error); }
+
+    return result;
+}
+
+static void bench_parse(uint n_ics) {
+    FILE* file = tmpfile();
+    if(!file) {
+        fprintf(stderr, "Could not create temporary file.\n");
+        exit(1);
+    }
+
+    Workload workload = generated_workload(n_ics, 0.0f);
+    write_ics_list(file, &workload);
+    free_workload(&workload);
+    long file_size = ftell(file);
+
+    uint iterations = 0;
+    double begin = now_seconds();
+    double elapsed;
+    do {
+        rewind(file);
+        ICList list = read_generated_list(file);
+        free_ic_list(&list);
+
+        iterations++;
+        elapsed = now_seconds() - begin;
+    } while(elapsed < MIN_BENCH_SECONDS);
+
+    fclose(file);
+
+    double per_iteration = elapsed / iterations;
+    printf("{\"benchmark\":\"parse_ic_list_file\",\"revision\":\"%s\","
+           "\"ics\":%u,\"bytes\":%ld,\"iterations\":%u,"
+           "\"seconds_per_iteration\":%.9f,\"ics_per_second\":%.1f,"
+           "\"megabytes_per_second\":%.3f}\n",
+           BENCH_REVISION, n_ics, file_size, iterations, per_iteration,
+           n_ics / per_iteration, file_size / per_iteration / 1e6);
+}
+
+// NOTE(erick): Goes through the parser so the ICs are exactly what the editor
+//  would see, then applies the generated placement.
+static ICList generated_list(uint n_ics, float occupancy, uint* placed) {
+    Workload workload = generated_workload(n_ics, occupancy);
+
+    FILE* file = tmpfile();
+    write_ics_list(file, &workload);
+    rewind(file);
+
+    ICList result = read_generated_list(file);
+    fclose(file);
+
+    place_workload(&workload, result);
+    *placed = workload.n_placed;
+    free_workload(&workload);
+
+    return result;
+}
+
+static void bench_placement(uint n_ics, float density) {
+    uint placed;
+    ICList list = generated_list(n_ics, density, &placed);
+    if(!placed) {
+        free_ic_list(&list);
+        return;
+    }
+
+    IC** placed_ics = (IC**) malloc(placed * sizeof(IC*));
+    uint placed_index = 0;
+    for(usize ic_index = 0; ic_index < list.count; ic_index++) {
+        if(list.data[ic_index].location.column) {
+            placed_ics[placed_index++] = list.data + ic_index;
+        }
+    }
+
+    uint64 operations = 0;
+    uint64 successes = 0;
+    double begin = now_seconds();
+    double elapsed;
+    do {
+        for(uint i = 0; i < 1024; i++) {
+            IC* ic = placed_ics[next_random() % placed];
+            int32 d_column = (int32) (next_random() % 3) - 1;
+            int32 d_row = (int32) (next_random() % 3) - 1;
+
+            successes += try_to_move_ic(list, ic, d_column, d_row);
+        }
+
+        operations += 1024;
+        elapsed = now_seconds() - begin;
+    } while(elapsed < MIN_BENCH_SECONDS);
+
+    printf("{\"benchmark\":\"try_to_move_ic\",\"revision\":\"%s\","
+           "\"ics\":%u,\"placed\":%u,\"density\":%.2f,\"operations\":%llu,"
+           "\"successes\":%llu,\"operations_per_second\":%.1f}\n",
+           BENCH_REVISION, n_ics, placed, density,
+           (unsigned long long) operations, (unsigned long long) successes,
+           operations / elapsed);
+
+    operations = 0;
+    successes = 0;
+    begin = now_seconds();
+    do {
+        for(uint i = 0; i < 1024; i++) {
+            Selection selection = {.row = 1 + next_random() % 64,
+                                   .column = 1 + next_random() % 3};
+            try_to_select_ic(list, &selection);
+
+            successes += (selection.state == SELECTING);
+        }
+
+        operations += 1024;
+        elapsed = now_seconds() - begin;
+    } while(elapsed < MIN_BENCH_SECONDS);
+
+    printf("{\"benchmark\":\"try_to_select_ic\",\"revision\":\"%s\","
+           "\"ics\":%u,\"placed\":%u,\"density\":%.2f,\"operations\":%llu,"
+           "\"successes\":%llu,\"operations_per_second\":%.1f}\n",
+           BENCH_REVISION, n_ics, placed, density,
+           (unsigned long long) operations, (unsigned long long) successes,
+           operations / elapsed);
+
+    free(placed_ics);
+    free_ic_list(&list);
+}
+
+// NOTE(erick): When zoomed, the view sits in the middle of the sheet at 1:1,
+//  which is what the zoomed editing cost looks like. Every tile is dirtied on
+//  every frame, so this measures drawing, not the tile cache.
+static void bench_render(DrawData* dd, uint n_ics, bool zoomed) {
+    uint placed;
+    ICList list = generated_list(n_ics, 1.0f, &placed);
+
+    dd->zoom_origin.x = (CANVAS_WIDTH - dd->width) / 2;
+    dd->zoom_origin.y = (CANVAS_HEIGHT - dd->height) / 2;
+    set_zoom(dd, zoomed ? 1.0f : fit_zoom(dd));
+
+    uint frames = 0;
+    double begin = now_seconds();
+    double elapsed;
+    do {
+        invalidate_canvas(&dd->canvas);
+        update_canvas_tiles(dd, list);
+        draw_canvas_to_framebuffer(dd);
+        swap_buffers(dd);
+
+        frames++;
+        elapsed = now_seconds() - begin;
+    } while(elapsed < MIN_BENCH_SECONDS);
+
+    printf("{\"benchmark\":\"%s\",\"revision\":\"%s\","
+           "\"ics\":%u,\"placed\":%u,\"canvas_width\":%d,\"canvas_height\":%d,"
+           "\"frames\":%u,\"seconds_per_frame\":%.9f}\n",
+           zoomed ? "render_zoomed_view" : "render_full_sheet",
+           BENCH_REVISION, n_ics, placed, CANVAS_WIDTH, CANVAS_HEIGHT,
+           frames, elapsed / frames);
+
+    free_ic_list(&list);
+}
+
+static uint64 hash_pixels(SoftCanvas* canvas) {
+    // NOTE(erick): FNV-1a.
+    uint64 hash = 0xcbf29ce484222325ull;
+    for(int y = 0; y < canvas->height; y++) {
+        uint8* row = canvas->pixels + y * canvas->pitch;
+        for(int x = 0; x < canvas->width * 4; x++) {
+            hash = (hash ^ row[x]) * 0x100000001b3ull;
+        }
+    }
+
+    return hash;
+}
+
+// NOTE(erick): The export path. The first two frames are hashed, they must
+//  match for the output to be deterministic.
+static void bench_soft_render(DrawData* dd, uint n_ics) {
+    uint placed;
+    ICList list = generated_list(n_ics, 1.0f, &placed);
+    SoftCanvas canvas = new_soft_canvas(CANVAS_WIDTH, CANVAS_HEIGHT);
+
+    uint64 hashes[2] = {0};
+    uint frames = 0;
+    double elapsed = 0;
+    do {
+        double begin = now_seconds();
+        render_sheet_soft(dd, list, &canvas, 0);
+        elapsed += now_seconds() - begin;
+
+        if(frames < 2) { hashes[frames] = hash_pixels(&canvas); }
+        frames++;
+    } while(elapsed < MIN_BENCH_SECONDS);
+
+    printf("{\"benchmark\":\"render_soft_sheet\",\"revision\":\"%s\","
+           "\"ics\":%u,\"placed\":%u,\"canvas_width\":%d,\"canvas_height\":%d,"
+           "\"threads\":%u,\"frames\":%u,\"seconds_per_frame\":%.9f,"
+           "\"deterministic\":%s}\n",
+           BENCH_REVISION, n_ics, placed, CANVAS_WIDTH, CANVAS_HEIGHT,
+           soft_render_threads(), frames, elapsed / frames,
+           hashes[0] == hashes[1] ? "true" : "false");
+
+    free_soft_canvas(&canvas);
+    free_ic_list(&list);
+}
+
+int main(int args_count, char** args_values) {
+    bool skip_render = false;
+    for(int arg_index = 1; arg_index < args_count; arg_index++) {
+        if(strcmp(args_values[arg_index], "--no-render") == 0) {
+            skip_render = true;
+        } else {
+            fprintf(stderr, "Usage: %s [--no-render]\n", args_values[0]);
+            exit(1);
+        }
+    }
+
+    static const uint parse_sizes[] = {10, 1000, 100000};
+    for(uint i = 0; i < sizeof(parse_sizes) / sizeof(parse_sizes[0]); i++) {
+        fprintf(stderr, "parse_ic_list_file: %u ICs\n", parse_sizes[i]);
+        bench_parse(parse_sizes[i]);
+    }
+
+    static const float densities[] = {0.25f, 0.5f, 0.75f, 1.0f};
+    static const uint placement_sizes[] = {100, 10000};
+    for(uint i = 0; i < sizeof(placement_sizes) / sizeof(placement_sizes[0]); i++) {
+        for(uint j = 0; j < sizeof(densities) / sizeof(densities[0]); j++) {
+            fprintf(stderr, "placement: %u ICs, density %.2f\n",
+                    placement_sizes[i], densities[j]);
+            bench_placement(placement_sizes[i], densities[j]);
+        }
+    }
+
+    if(!skip_render) {
+        DrawData dd = init_headless_SDL(1920, 1080);
+        if(!dd.clear_sans) {
+            fprintf(stderr, "Warning: fonts not found in the working directory. "
+                    "Text will not be rendered.\n");
+        }
+
+        fprintf(stderr, "render: full sheet\n");
+        bench_render(&dd, 100, false);
+
+        fprintf(stderr, "render: zoomed view\n");
+        bench_render(&dd, 100, true);
+
+        fprintf(stderr, "render: software sheet\n");
+        bench_soft_render(&dd, 100);
+    }
+
+    return 0;
+}
@@ -0,0 +1,217 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "bread_placer.h"
+#include "workload.h"
+
+// NOTE(erick): Mutation fuzzer for read_ic_list_file. Inputs start as valid
+//  generated lists and get corrupted a little. Every input is parsed in a child
+//  process, which exits with the error the parser returned: exiting with any
+//  code is fine, dying from a signal is a crash.
+
+static uint64 rng_state;
+
+static uint32 next_random() {
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+
+    return (uint32) ((rng_state * 0x2545f4914f6cdd1dull) >> 32);
+}
+
+typedef struct {
+    char* data;
+    usize size;
+    usize capacity;
+} Buffer;
+
+static void reserve(Buffer* buffer, usize size) {
+    if(size <= buffer->capacity) { return; }
+
+    while(buffer->capacity < size) { buffer->capacity = buffer->capacity * 2 + 64; }
+    buffer->data = realloc(buffer->data, buffer->capacity);
+}
+
+static void insert_bytes(Buffer* buffer, usize at, const char* bytes, usize count) {
+    reserve(buffer, buffer->size + count);
+    memmove(buffer->data + at + count, buffer->data + at, buffer->size - at);
+    memcpy(buffer->data + at, bytes, count);
+    buffer->size += count;
+}
+
+static void remove_bytes(Buffer* buffer, usize at, usize count) {
+    if(at + count > buffer->size) { count = buffer->size - at; }
+
+    memmove(buffer->data + at, buffer->data + at + count, buffer->size - at - count);
+    buffer->size -= count;
+}
+
+static usize random_line_start(Buffer* buffer) {
+    if(!buffer->size) { return 0; }
+
+    usize at = next_random() % buffer->size;
+    while(at && buffer->data[at - 1] != '\n') { at--; }
+
+    return at;
+}
+
+static usize line_length(Buffer* buffer, usize at) {
+    usize end = at;
+    while(end < buffer->size && buffer->data[end] != '\n') { end++; }
+
+    return end - at + (end < buffer->size);
+}
+
+static const char* interesting_lines[] = {
+    "IC 0\n", "IC -4\n", "IC 99999\n", "IC\n", "IC 7\n", "Pins\n", "Name\n",
+    "Code\n", "*0 ZERO\n", "#65535 HIGH\n", "*-1 NEGATIVE\n", "* \n", "#\n",
+    "\n", "*1\n", "Name  \n", "*1 VCC\n", "#2 GND\n", "*3 N.C.\n",
+};
+
+static void mutate(Buffer* buffer) {
+    uint n_mutations = 1 + next_random() % 4;
+
+    for(uint i = 0; i < n_mutations; i++) {
+        switch(next_random() % 6) {
+        case 0: {
+            // NOTE(erick): Flip a byte.
+            if(!buffer->size) { break; }
+            buffer->data[next_random() % buffer->size] = (char) next_random();
+        } break;
+
+        case 1: {
+            usize at = random_line_start(buffer);
+            remove_bytes(buffer, at, line_length(buffer, at));
+        } break;
+
+        case 2: {
+            usize at = random_line_start(buffer);
+            usize length = line_length(buffer, at);
+            char* copy = (char*) malloc(length);
+            memcpy(copy, buffer->data + at, length);
+            insert_bytes(buffer, at, copy, length);
+            free(copy);
+        } break;
+
+        case 3: {
+            const char* line = interesting_lines[next_random() %
+                                                 (sizeof(interesting_lines) /
+                                                  sizeof(interesting_lines[0]))];
+            insert_bytes(buffer, random_line_start(buffer), line, strlen(line));
+        } break;
+
+        case 4: {
+            // NOTE(erick): A line that does not fit the parser's buffer.
+            usize length = 200 + next_random() % 400;
+            char* line = (char*) malloc(length + 1);
+            line[0] = '*';
+            memset(line + 1, 'A', length - 1);
+            line[length] = '\n';
+            insert_bytes(buffer, random_line_start(buffer), line, length + 1);
+            free(line);
+        } break;
+
+        case 5: {
+            buffer->size = next_random() % (buffer->size + 1);
+        } break;
+        }
+    }
+}
+
+static int run_parser(FILE* input) {
+    fflush(NULL);
+
+    pid_t pid = fork();
+    if(pid == 0) {
+        // NOTE(erick): The parser's error messages are expected, drop them.
+        ProjectContext context = new_project_context(NULL);
+
+        rewind(input);
+        ICList list;
+        int error = read_ic_list_file(&context, input, &list);
+        if(!error) { free_ic_list(&list); }
+        _exit(error);
+    }
+
+    int status;
+    waitpid(pid, &status, 0);
+
+    return status;
+}
+
+int main(int args_count, char** args_values) {
+    uint iterations = 1000;
+    uint64 seed = 1;
+
+    for(int arg_index = 1; arg_index < args_count; arg_index++) {
+        char* arg = args_values[arg_index];
+
+        if(strcmp(arg, "--iterations") == 0 && arg_index + 1 < args_count) {
+            iterations = (uint) strtoul(args_values[++arg_index], NULL, 10);
+        } else if(strcmp(arg, "--seed") == 0 && arg_index + 1 < args_count) {
+            seed = strtoull(args_values[++arg_index], NULL, 10);
+        } else {
+            fprintf(stderr, "Usage: %s [--iterations n] [--seed n]\n", args_values[0]);
+            exit(1);
+        }
+    }
+
+    rng_state = seed * 0x9e3779b97f4a7c15ull + 1;
+
+    uint crashes = 0;
+    uint rejected = 0;
+    Buffer buffer = {};
+
+    for(uint iteration = 0; iteration < iterations; iteration++) {
+        WorkloadParams params = default_workload_params();
+        params.n_ics = 1 + next_random() % 8;
+        params.seed = seed + iteration;
+
+        Workload workload = generate_workload(&params);
+
+        FILE* input = tmpfile();
+        write_ics_list(input, &workload);
+        free_workload(&workload);
+
+        buffer.size = (usize) ftell(input);
+        reserve(&buffer, buffer.size);
+        rewind(input);
+        fread(buffer.data, 1, buffer.size, input);
+        fclose(input);
+
+        mutate(&buffer);
+
+        input = tmpfile();
+        fwrite(buffer.data, 1, buffer.size, input);
+
+        int status = run_parser(input);
+        fclose(input);
+
+        if(WIFSIGNALED(status)) {
+            char filename[64];
+            sprintf(filename, "fuzz_crash_%u.ics_list", iteration);
+
+            FILE* crash_file = fopen(filename, "w");
+            if(crash_file) {
+                fwrite(buffer.data, 1, buffer.size, crash_file);
+                fclose(crash_file);
+            }
+
+            fprintf(stderr, "Crash (signal %d) at iteration %u. Input saved to [%s]\n",
+                    WTERMSIG(status), iteration, filename);
+            crashes++;
+        } else if(WEXITSTATUS(status) != 0) {
+            rejected++;
+        }
+    }
+
+    printf("{\"fuzzer\":\"parse_ic_list_file\",\"iterations\":%u,"
+           "\"rejected\":%u,\"crashes\":%u}\n", iterations, rejected, crashes);
+
+    free(buffer.data);
+    return crashes ? 1 : 0;
+}
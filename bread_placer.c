@@ -6,35 +6,27 @@
 #include <assert.h>
 
 #include "bread_placer.h"
-#include "draw.h"
 
 // TODO(erick): Error codes.
-// TODO(erick): Velocity control in zoom mode.
-// TODO(erick): Viewport must focus on selection when zoomed in.
-
-#define PAN_INCREMENT 10
-
-//
-// Globals
-//
-static const char* prj_extension = ".icprj";
-static const char* ics_extension = ".ics_list";
 
 //
 // Macros
 //
 #define sizeof_array(array) (sizeof(array)/sizeof(array[0]))
 
-void report_ic_error(IC* ic) {
-    fprintf(stderr, "*Error on IC*\n");
-    fprintf(stderr, "\t # pins: %d\n", ic->n_pins);
+#define BOARD_COLUMNS 3
+#define BOARD_ROWS 64
+
+void report_ic_error(ProjectContext* context, IC* ic) {
+    context_message(context, "*Error on IC*\n");
+    context_message(context, "\t # pins: %d\n", ic->n_pins);
 
     if(ic->name) {
-        fprintf(stderr, "\t Name: %s\n", ic->name);
+        context_message(context, "\t Name: %s\n", ic->name);
     }
 
     if(ic->code) {
-        fprintf(stderr, "\t Code: %s\n", ic->code);
+        context_message(context, "\t Code: %s\n", ic->code);
     }
 }
 
@@ -44,6 +36,7 @@ ICList new_ICList() {
     result.capacity = 16;
     result.data = (IC*) malloc(result.capacity * sizeof(IC));
     result.count = 0;
+    result.journal = NULL;
 
     return result;
 }
@@ -71,19 +64,19 @@ char* string_after_first_space(char* string) {
     return result;
 }
 
-void validate_ic(IC ic) {
+bool validate_ic(ProjectContext* context, IC ic) {
     bool valid = true;
     for(uint i = 0; i < ic.n_pins; i++) {
         if(!ic.pins[i].label) {
             // If this is our first error.
-            if(valid) { report_ic_error(&ic); }
+            if(valid) { report_ic_error(context, &ic); }
 
-            fprintf(stderr, "Pin_%02d was not assigned\n", i + 1);
+            context_error(context, 2, "Pin_%02d was not assigned\n", i + 1);
             valid = false;
         }
     }
 
-    if(!valid) { exit(2); }
+    return valid;
 }
 
 void trim_end(char* string) {
@@ -112,31 +105,32 @@ PinType pin_type(char* label) {
     return NON_SPECIAL;
 }
 
-void assign_pin(IC* ic, uint pin_number, bool goes_outside, char* label) {
+bool assign_pin(ProjectContext* context, IC* ic, uint pin_number, bool goes_outside,
+                char* label) {
     if(!label) {
-        report_ic_error(ic);
-        fprintf(stderr, "Null reference for pin [%d] label\n", pin_number);
-        exit(3);
+        report_ic_error(context, ic);
+        context_error(context, 3, "Null reference for pin [%d] label\n", pin_number);
+        return false;
     }
 
     if(strlen(label) == 0) {
-        report_ic_error(ic);
-        fprintf(stderr, "Zero length label for pin [%d]\n", pin_number);
-        exit(3);
+        report_ic_error(context, ic);
+        context_error(context, 3, "Zero length label for pin [%d]\n", pin_number);
+        return false;
     }
 
-    if(pin_number > ic->n_pins) {
-        report_ic_error(ic);
-        fprintf(stderr, "The IC has only (%d) pins. Pin [%d] is out-of-range\n",
-                ic->n_pins, pin_number);
-        exit(3);
+    if(pin_number == 0 || pin_number > ic->n_pins) {
+        report_ic_error(context, ic);
+        context_error(context, 3, "The IC has only (%d) pins. Pin [%d] is out-of-range\n",
+                      ic->n_pins, pin_number);
+        return false;
     }
 
     uint index = pin_number - 1;
     if(ic->pins[index].label != NULL) {
-        report_ic_error(ic);
-        fprintf(stderr, "Pin [%d] is already assigned\n", pin_number);
-        exit(3);
+        report_ic_error(context, ic);
+        context_error(context, 3, "Pin [%d] is already assigned\n", pin_number);
+        return false;
     }
 
     Pin current_pin = {.label = label,
@@ -144,10 +138,14 @@ void assign_pin(IC* ic, uint pin_number, bool goes_outside, char* label) {
                        .type = pin_type(label)};
 
     ic->pins[index] = current_pin;
+    return true;
 }
 
-ICList parse_ic_list_file(FILE* input_file) {
+// NOTE(erick): Returns 0, or the exit code of the error after reporting it.
+//  Nothing is added to the list on errors.
+int read_ic_list_file(ProjectContext* context, FILE* input_file, ICList* result) {
     ICList ic_list = new_ICList();
+    int error = 0;
 
     // FIXME(erick): This should not be fixed.
     char __line[256];
@@ -155,26 +153,37 @@ ICList parse_ic_list_file(FILE* input_file) {
     bool is_reading_pins = false;
 
     IC current_ic;
-    while(!feof(input_file) && fgets(__line, sizeof_array(__line), input_file)) {
+    while(!error && !feof(input_file) && fgets(__line, sizeof_array(__line), input_file)) {
         char* line = __line;
         trim_end(line);
 
         if(!is_reading_ic) {
             if(string_begins_with(line, "IC")) {
+                int n_pins = atoi(string_after_first_space(line));
+                if(n_pins <= 0) {
+                    error = context_error(context, 2, "Invalid number of pins at: [%s]\n",
+                                          line);
+                    break;
+                }
+
                 is_reading_ic = true;
 
-                // BUG(erick): Check if there is a number!!!
-                current_ic.n_pins = atoi(string_after_first_space(line));
+                current_ic.n_pins = n_pins;
                 current_ic.pins = (Pin*) calloc(current_ic.n_pins, sizeof(Pin));
                 current_ic.name = NULL;
                 current_ic.code = NULL;
+                current_ic.id = 0;
+
+                current_ic.location.column = 0;
+                current_ic.location.row = 0;
+                current_ic.location.orientation = UP;
             }
         } else {
             if(strlen(line) == 0) {
                 is_reading_ic = false;
                 is_reading_pins = false;
 
-                validate_ic(current_ic);
+                if(!validate_ic(context, current_ic)) { free_ic(&current_ic); error = 2; break; }
                 add_to_ic_list(&ic_list, current_ic);
                 continue;
             }
@@ -197,9 +206,9 @@ ICList parse_ic_list_file(FILE* input_file) {
                 char* current_label;
 
                 if(*line != '#' && *line != '*') {
-                    fprintf(stderr, "Parser is reading pins."
-                            " Lines must begin with '#' or '*'\n");
-                    exit(2);
+                    error = context_error(context, 2, "Parser is reading pins."
+                                          " Lines must begin with '#' or '*'\n");
+                    break;
                 }
 
                 current_goes_outside = (*line == '#');
@@ -208,59 +217,198 @@ ICList parse_ic_list_file(FILE* input_file) {
                 int read = sscanf(line, "%d ", &current_pin);
                 current_label = cpystr(string_after_first_space(line));
 
-                if(!read) {
-                    fprintf(stderr, "No number found at: [#%s]\n", line);
+                if(read != 1) {
+                    error = context_error(context, 2, "No number found at: [#%s]\n", line);
+                    free(current_label);
+                    break;
                 }
 
-                assign_pin(&current_ic, current_pin, current_goes_outside,
-                           current_label);
+                if(!assign_pin(context, &current_ic, current_pin, current_goes_outside,
+                               current_label)) {
+                    free(current_label);
+                    error = 3;
+                    break;
+                }
             }
         }
     }
 
     // Finishing last IC.
-    if(is_reading_ic) {
+    if(!error && is_reading_ic) {
         is_reading_ic = false;
         is_reading_pins = false;
 
-        validate_ic(current_ic);
-        add_to_ic_list(&ic_list, current_ic);
+        if(validate_ic(context, current_ic)) {
+            add_to_ic_list(&ic_list, current_ic);
+        } else {
+            free_ic(&current_ic);
+            error = 2;
+        }
+    }
+
+    if(error) {
+        // NOTE(erick): The IC being read when the error was found is not on
+        //  the list yet.
+        if(is_reading_ic) { free_ic(&current_ic); }
+        free_ic_list(&ic_list);
+        return error;
+    }
+
+    assign_ic_ids(&ic_list);
+    *result = ic_list;
+    return 0;
+}
+
+// NOTE(erick): FNV-1a. A NULL string hashes like an empty one.
+static uint64 hash_string(uint64 hash, char* string) {
+    if(!string) { string = ""; }
+
+    for(; *string; string++) {
+        hash ^= (uint8) *string;
+        hash *= 0x100000001b3ull;
+    }
+
+    hash ^= '\n';
+    hash *= 0x100000001b3ull;
+    return hash;
+}
+
+static uint64 hash_uint(uint64 hash, uint64 value) {
+    for(uint i = 0; i < 8; i++) {
+        hash ^= (uint8) (value >> (8 * i));
+        hash *= 0x100000001b3ull;
+    }
+
+    return hash;
+}
+
+// NOTE(erick): Open addressing map from a 64 bit key to a list index.
+typedef struct {
+    uint64* keys;
+    uint32* values;
+    bool* used;
+    usize capacity;
+} IdMap;
+
+static IdMap new_id_map(usize count) {
+    IdMap map;
+
+    // NOTE(erick): At most half full.
+    map.capacity = 16;
+    while(map.capacity < 2 * count) { map.capacity *= 2; }
+
+    map.keys = (uint64*) malloc(map.capacity * sizeof(uint64));
+    map.values = (uint32*) malloc(map.capacity * sizeof(uint32));
+    map.used = (bool*) calloc(map.capacity, sizeof(bool));
+
+    return map;
+}
+
+static usize id_map_slot(IdMap* map, uint64 key) {
+    usize mask = map->capacity - 1;
+    usize slot = (usize) (key ^ (key >> 32)) & mask;
+    while(map->used[slot] && map->keys[slot] != key) { slot = (slot + 1) & mask; }
+
+    return slot;
+}
+
+static void free_id_map(IdMap* map) {
+    free(map->keys);
+    free(map->values);
+    free(map->used);
+}
+
+// NOTE(erick): The id of an IC is a hash of its name, its code and its number
+//  of pins, so it survives the IC moving around the ics_list file and its
+//  labels being edited. ICs that are the same on all three are told apart by
+//  how many of them come before.
+void assign_ic_ids(ICList* list) {
+    IdMap seen = new_id_map(list->count);
+
+    for(usize ic_index = 0; ic_index < list->count; ic_index++) {
+        IC* ic = list->data + ic_index;
+
+        uint64 key = hash_string(0xcbf29ce484222325ull, ic->name);
+        key = hash_string(key, ic->code);
+        key = hash_uint(key, ic->n_pins);
+
+        usize slot = id_map_slot(&seen, key);
+        if(seen.used[slot]) {
+            ic->id = hash_uint(key, seen.values[slot]);
+            seen.values[slot]++;
+        } else {
+            ic->id = key;
+            seen.used[slot] = true;
+            seen.keys[slot] = key;
+            seen.values[slot] = 1;
+        }
     }
 
-    return ic_list;
+    free_id_map(&seen);
 }
 
-void save_project_file(char* project_filename, ICList* breadboard) {
+// NOTE(erick): Returns 0, or the exit code of the error after reporting it.
+int save_project_file(ProjectContext* context, char* project_filename,
+                      ICList* breadboard) {
     FILE* prj_file = fopen(project_filename, "w");
     if(!prj_file) {
-        fprintf(stderr, "Could not open project file [%s] to write the project data.\n",
-               project_filename);
-        exit(4);
+        return context_error(context, 4, "Could not open project file [%s] to write"
+                             " the project data.\n", project_filename);
     }
 
     for(uint ic_index = 0; ic_index < breadboard->count; ic_index++) {
         IC* ic = breadboard->data + ic_index;
         BreadboardLocation location = ic->location;
 
-        fprintf(prj_file, "%d: {%d, %d, %d}\n", ic_index, location.column,
-                location.row, location.orientation);
+        fprintf(prj_file, "@%016llx: {%d, %d, %d}\n", (unsigned long long) ic->id,
+                location.column, location.row, location.orientation);
     }
 
     fclose(prj_file);
+    return 0;
+}
+
+// NOTE(erick): Outside (column 0) any row goes, it is not used. On the board
+//  every pin must be.
+static bool is_valid_location(IC* ic, uint column, uint row, uint orientation) {
+    if(column > BOARD_COLUMNS || (orientation != UP && orientation != DOWN)) { return false; }
+    if(column == 0) { return true; }
+
+    uint height = ic->n_pins / 2;
+    if(orientation == UP) { return row >= 1 && row + height - 1 <= BOARD_ROWS; }
+    return row <= BOARD_ROWS && row >= height;
 }
 
-void read_project_file(char* project_filename, ICList* breadboard) {
+// NOTE(erick): Lines start with the id of the IC, after an '@'. Old project
+//  files start them with the index of the IC on the list instead, which is
+//  still read. Returns 0, or the exit code of the error after reporting it.
+//  The ICs before the line with the error were already moved.
+int read_project_file(ProjectContext* context, char* project_filename,
+                      ICList* breadboard) {
     FILE* prj_file = fopen(project_filename, "r");
     if(!prj_file) {
-        fprintf(stderr, "Could not open project file [%s] to read the project data.\n",
-               project_filename);
-        exit(4);
+        return context_error(context, 4, "Could not open project file [%s] to read"
+                             " the project data.\n", project_filename);
     }
 
+    IdMap ids = new_id_map(breadboard->count);
+    for(usize ic_index = 0; ic_index < breadboard->count; ic_index++) {
+        uint64 id = breadboard->data[ic_index].id;
+        usize slot = id_map_slot(&ids, id);
+
+        ids.used[slot] = true;
+        ids.keys[slot] = id;
+        ids.values[slot] = ic_index;
+    }
+
+    bool* is_in_project = (bool*) calloc(breadboard->count + 1, sizeof(bool));
+    uint n_orphans = 0;
+    int error = 0;
+
     // FIXME(erick): This should not be fixed.
     uint line_number = 0;
     char __line[256];
-    while(!feof(prj_file) && fgets(__line, sizeof_array(__line), prj_file)) {
+    while(!error && !feof(prj_file) && fgets(__line, sizeof_array(__line), prj_file)) {
         char* line = __line;
         trim_end(line);
         line_number++;
@@ -270,29 +418,79 @@ void read_project_file(char* project_filename, ICList* breadboard) {
         uint row;
         uint orientation;
 
-        int read = sscanf(line, "%d: {%d, %d, %d}", &ic_index, &column,
-                          &row, &orientation);
-        if(read != 4) {
-            fprintf(stderr, "Invalid line in project file. Ignoring.\n\t%d: %s\n",
-                    line_number, line);
-            continue;
-        }
+        if(*line == '@') {
+            unsigned long long id;
+            int read = sscanf(line, "@%llx: {%d, %d, %d}", &id, &column,
+                              &row, &orientation);
+            if(read != 4) {
+                context_message(context, "Invalid line in project file. Ignoring.\n"
+                                "\t%d: %s\n", line_number, line);
+                continue;
+            }
 
-        if(ic_index >= breadboard->count) {
-            fprintf(stderr, "Invalid IC index [%d] at line (%d) of project file.\n",
-                    ic_index, line_number);
-            exit(4);
+            usize slot = id_map_slot(&ids, id);
+            if(!ids.used[slot]) {
+                context_message(context, "No IC with id [%016llx] at line (%d) of"
+                                " project file. Ignoring.\n", id, line_number);
+                n_orphans++;
+                continue;
+            }
+
+            ic_index = ids.values[slot];
+        } else {
+            int read = sscanf(line, "%d: {%d, %d, %d}", &ic_index, &column,
+                              &row, &orientation);
+            if(read != 4) {
+                context_message(context, "Invalid line in project file. Ignoring.\n"
+                                "\t%d: %s\n", line_number, line);
+                continue;
+            }
+
+            if(ic_index >= breadboard->count) {
+                error = context_error(context, 4, "Invalid IC index [%d] at line (%d)"
+                                      " of project file.\n", ic_index, line_number);
+                break;
+            }
         }
 
         IC* ic = breadboard->data + ic_index;
+        if(!is_valid_location(ic, column, row, orientation)) {
+            error = context_error(context, 4, "Invalid location {%d, %d, %d} at line (%d)"
+                                  " of project file.\n", column, row, orientation,
+                                  line_number);
+            break;
+        }
+
         BreadboardLocation* location = &ic->location;
 
         location->column = column;
         location->row = row;
         location->orientation = orientation;
+        is_in_project[ic_index] = true;
     }
 
+    if(n_orphans) {
+        bool one = n_orphans == 1;
+        context_message(context, "%u IC%s of the project file %s no longer in the"
+                        " ics_list file. %s dropped when the project is saved.\n",
+                        n_orphans, one ? "" : "s", one ? "is" : "are",
+                        one ? "It is" : "They are");
+    }
+
+    for(usize ic_index = 0; !error && ic_index < breadboard->count; ic_index++) {
+        if(is_in_project[ic_index]) { continue; }
+
+        IC* ic = breadboard->data + ic_index;
+        context_message(context, "IC [%s] (%s) is not in the project file."
+                        " It starts outside.\n",
+                        ic->name ? ic->name : "", ic->code ? ic->code : "");
+    }
+
+    free(is_in_project);
+    free_id_map(&ids);
     fclose(prj_file);
+
+    return error;
 }
 
 char* extension(char* filename) {
@@ -315,262 +513,23 @@ char* str_n_alloc_cpy(char* str, usize len) {
     return result;
 }
 
-static void move_point(Vec2* point, int32 dx, int32 dy, int32 window_w, int32 window_h) {
-    point->x += dx;
-    point->y += dy;
-
-    if(point->x < 0) {
-        point->x = 0;
+void free_ic(IC* ic) {
+    for(uint pin_index = 0; pin_index < ic->n_pins; pin_index++) {
+        free(ic->pins[pin_index].label);
     }
 
-    if(point->y < 0) {
-        point->y = 0;
-    }
-
-    if(point->x +  window_w >= CANVAS_WIDTH) {
-        point->x = CANVAS_WIDTH - window_w;
-    }
-
-    if(point->y +  window_h >= CANVAS_HEIGHT) {
-        point->y = CANVAS_HEIGHT - window_h;
-    }
-}
-
-static uint dec_mod(uint value, uint mod) {
-    if(value == 0) { return mod - 1; }
-
-    return value - 1;
-}
-
-static uint inc_mod(uint value, uint mod) {
-    if(value + 1 == mod) { return 0; }
-
-    return value + 1;
+    free(ic->pins);
+    free(ic->name);
+    free(ic->code);
 }
 
-
-int main(int args_count, char** args_values) {
-    if(args_count != 2) {
-        fprintf(stderr, "Usage: %s (ics__list_file | prj_file)\n", args_values[0]);
-        exit(1);
+void free_ic_list(ICList* list) {
+    for(usize ic_index = 0; ic_index < list->count; ic_index++) {
+        free_ic(list->data + ic_index);
     }
 
-    char* project_name;
-    char* ics_list_filename;
-    char* project_filename;
-    char* bmp_filename;
-
-    char* input_filename = args_values[1];
-    char* input_extension = extension(input_filename);
-    usize input_extension_len = strlen(input_extension);
-
-    bool should_read_prj_file;
-
-    if(input_extension == input_filename) {
-        fprintf(stderr, "The input file must have an extension\n");
-        exit(2);
-    }
-
-    project_name = str_n_alloc_cpy(input_filename,
-                                   strlen(input_filename) -
-                                   input_extension_len);
-    usize project_name_len = strlen(project_name);
-
-    // NOTE(erick): A project file was passed.
-    if(strcmp(input_extension, prj_extension) == 0) {
-        project_filename = input_filename;
-        should_read_prj_file = true;
-
-        usize ics_extension_len = strlen(ics_extension);
-        ics_list_filename = (char*) malloc(project_name_len +
-                                           ics_extension_len + 1);
-
-        strcpy(ics_list_filename, project_name);
-        strcat(ics_list_filename, ics_extension);
-
-    // NOTE(erick): A ics_list file was passed.
-    } else if(strcmp(input_extension, ics_extension) == 0) {
-        ics_list_filename = input_filename;
-        should_read_prj_file = false;
-
-        usize prj_extension_len = strlen(prj_extension);
-        project_filename = (char*) malloc(prj_extension_len +
-                                                project_name_len + 1);
-
-        strcpy(project_filename, project_name);
-        strcat(project_filename, prj_extension);
-    } else {
-        fprintf(stderr, "You must pass either a project file or a ics_list file\n");
-        exit(2);
-    }
-
-    bmp_filename = (char*) malloc(strlen(project_name) + strlen(".bmp") + 1);
-    sprintf(bmp_filename, "%s.bmp", project_name);
-
-    FILE* ics_list_file = fopen(ics_list_filename, "r");
-    if(!ics_list_file) {
-        fprintf(stderr, "Could not open ics_list file [%s] to read the ics data.\n",
-                ics_list_filename);
-        exit(3);
-    }
-
-    ICList ic_list = parse_ic_list_file(ics_list_file);
-    fclose(ics_list_file);
-
-    if(should_read_prj_file) {
-        read_project_file(project_filename, &ic_list);
-    }
-
-    Selection selection = {.row = 1, .column = 1};
-    DrawData dd = init_SDL();
-    bool is_running = true;
-
-    uint32 old_ticks = SDL_GetTicks();
-    while(is_running) {
-        uint32 new_ticks = SDL_GetTicks();
-        uint32 delta_ticks = new_ticks - old_ticks;
-        old_ticks = new_ticks;
-        dd.dt = (float) delta_ticks / 1000.0;
-
-        SDL_Event e;
-        while(SDL_PollEvent(&e)) {
-            if(e.type == SDL_QUIT) {
-                is_running = false;
-
-            } else if(e.type == SDL_KEYDOWN) {
-                switch (e.key.keysym.sym) {
-                case SDLK_ESCAPE: // Fall-through
-                case SDLK_q:
-                    is_running = false;
-                    break;
-                case SDLK_z:
-                    dd.zoomed_in = !dd.zoomed_in;
-                    break;
-                case SDLK_p:
-                    dd.display_debug_info = !dd.display_debug_info;
-                    break;
-                case SDLK_w:
-                    move_point(&dd.zoom_origin, 0, -1 * PAN_INCREMENT,
-                               dd.width, dd.height);
-                    break;
-                case SDLK_s:
-                    move_point(&dd.zoom_origin, 0, 1 * PAN_INCREMENT,
-                               dd.width, dd.height);
-                    break;
-                case SDLK_a:
-                    move_point(&dd.zoom_origin, -1 * PAN_INCREMENT, 0,
-                               dd.width, dd.height);
-                    break;
-                case SDLK_d:
-                    move_point(&dd.zoom_origin, 1 * PAN_INCREMENT, 0,
-                               dd.width, dd.height);
-                    break;
-                case SDLK_LEFT:
-                    if(!dd.is_selecting_outside_ic) {
-                        move_selection(ic_list, &selection, -1, 0);
-                    }
-                    break;
-                case SDLK_RIGHT:
-                    if(!dd.is_selecting_outside_ic) {
-                        move_selection(ic_list, &selection, 1, 0);
-                    }
-                    break;
-                case SDLK_UP:
-                    if(!dd.is_selecting_outside_ic) {
-                        move_selection(ic_list, &selection, 0, -1);
-                    } else {
-                        dd.outside_ic_selected = dec_mod(dd.outside_ic_selected,
-                                                         count_outside_ics(ic_list));
-                    }
-                    break;
-                case SDLK_DOWN:
-                    if(!dd.is_selecting_outside_ic) {
-                        move_selection(ic_list, &selection, 0, 1);
-                    } else {
-                        dd.outside_ic_selected = inc_mod(dd.outside_ic_selected,
-                                                         count_outside_ics(ic_list));
-                    }
-                    break;
-                case SDLK_r:
-                    if(selection.state == SELECTING) {
-                        rotate_ic(selection.selected_ic);
-                    }
-                    break;
-                case SDLK_BACKSPACE: // Fall-through
-                case SDLK_DELETE:
-                    if(selection.state == SELECTING) {
-                        put_ic_outside(selection.selected_ic);
-                        selection.state = HOVERING;
-                    }
-                    break;
-                case SDLK_i:
-                    if(count_outside_ics(ic_list)) {
-                        dd.is_selecting_outside_ic = true;
-                        dd.outside_ic_selected = 0;
-                    }
-                    break;
-                case SDLK_SPACE: // Fall-through
-                case SDLK_RETURN:
-                    if(dd.is_selecting_outside_ic) {
-                        dd.is_selecting_outside_ic = false;
-                        bool success = move_outside_ic_in(ic_list,
-                                                          dd.outside_ic_selected,
-                                                          selection.row,
-                                                          selection.column);
-                        if(success) {
-                            try_to_select_ic(ic_list, &selection);
-                        }
-
-                    } else {
-                        if(selection.state == HOVERING) {
-                            try_to_select_ic(ic_list, &selection);
-                        } else {
-                            selection.state = HOVERING;
-                            selection.selected_ic = NULL;
-                        }
-                    }
-
-                    break;
-                default:
-                    printf("Key pressed: %d\n", e.key.keysym.sym);
-                }
-            }
-        }
-
-
-        prepare_canvas(&dd);
-        draw_grid(&dd);
-        draw_numbers(&dd);
-        draw_ics(&dd, ic_list);
-        draw_selection(&dd, selection);
-
-        draw_canvas_to_framebuffer(&dd);
-
-        if(dd.is_selecting_outside_ic) {
-            draw_outside_ics_list(&dd, ic_list, dd.outside_ic_selected);
-        }
-
-        if(dd.display_debug_info) {
-            draw_debug_info(&dd);
-        }
-
-        draw_outside_ics_count(&dd, ic_list);
-
-        swap_buffers(&dd);
-    }
-
-    draw_saving_screen(&dd);
-    swap_buffers(&dd);
-
-    // NOTE(erick): Drawing to canvas to emit a clean image (i.e. without selector
-    //  and ratsnest).
-    prepare_canvas(&dd);
-    draw_grid(&dd);
-    draw_numbers(&dd);
-    draw_ics(&dd, ic_list);
-
-    save_image(&dd, bmp_filename);
-    save_project_file(project_filename, &ic_list);
-
-    return 0;
+    free(list->data);
+    list->data = NULL;
+    list->count = 0;
+    list->capacity = 0;
 }
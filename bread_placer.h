@@ -1,31 +1,28 @@
 #ifndef BREAD_PLACER_H
 #define BREAD_PLACER_H 1
 
-#include "ICs.h"
-
-typedef intptr_t isize;
-typedef int8_t   int8;
-typedef int16_t  int16;
-typedef int32_t  int32;
-typedef int64_t  int64;
+#include <stdio.h>
 
-typedef size_t       usize;
-typedef uint8_t      uint8;
-typedef uint16_t     uint16;
-typedef uint32_t     uint32;
-typedef uint64_t     uint64;
-typedef unsigned int uint;
+#include "ICs.h"
+#include "context.h"
 
 ICList new_ICList();
 void add_to_ic_list(ICList*, IC);
 bool string_begins_with(char*, char*);
 char* string_after_first_space(char*);
-void report_ic_error(IC*);
-void validate_ic(IC);
+void report_ic_error(ProjectContext*, IC*);
+bool validate_ic(ProjectContext*, IC);
 void trim_end(char*);
 char* cpystr(char*);
 PinType pin_type(char*);
-void assign_pin(IC*, uint, bool, char*);
-ICList parse_ic_list_file(FILE*);
+bool assign_pin(ProjectContext*, IC*, uint, bool, char*);
+int read_ic_list_file(ProjectContext*, FILE*, ICList*);
+void free_ic(IC*);
+void free_ic_list(ICList*);
+void assign_ic_ids(ICList*);
+int save_project_file(ProjectContext*, char*, ICList*);
+int read_project_file(ProjectContext*, char*, ICList*);
+char* extension(char*);
+char* str_n_alloc_cpy(char*, usize);
 
 #endif
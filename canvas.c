@@ -0,0 +1,181 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "draw.h"
+#include "canvas.h"
+
+void init_tiled_canvas(TiledCanvas* canvas) {
+    for(int level = 0; level < TILE_LEVELS; level++) {
+        int tile_span = TILE_SIZE << level;
+        canvas->columns[level] = (CANVAS_WIDTH + tile_span - 1) / tile_span;
+        canvas->rows[level] = (CANVAS_HEIGHT + tile_span - 1) / tile_span;
+
+        int n_tiles = canvas->columns[level] * canvas->rows[level];
+        canvas->tiles[level] = (Tile*) malloc(n_tiles * sizeof(Tile));
+        for(int i = 0; i < n_tiles; i++) {
+            canvas->tiles[level][i].slot = -1;
+            canvas->tiles[level][i].dirty = true;
+        }
+    }
+
+    // NOTE(erick): Textures are created the first time a slot is needed.
+    for(uint i = 0; i < TILE_POOL_SIZE; i++) {
+        canvas->slots[i].texture = NULL;
+        canvas->slots[i].level = -1;
+        canvas->slots[i].last_used = 0;
+    }
+
+    canvas->frame = 0;
+}
+
+void free_tiled_canvas(TiledCanvas* canvas) {
+    for(int level = 0; level < TILE_LEVELS; level++) {
+        free(canvas->tiles[level]);
+        canvas->tiles[level] = NULL;
+    }
+
+    for(uint i = 0; i < TILE_POOL_SIZE; i++) {
+        if(canvas->slots[i].texture) {
+            SDL_DestroyTexture(canvas->slots[i].texture);
+            canvas->slots[i].texture = NULL;
+        }
+        canvas->slots[i].level = -1;
+    }
+}
+
+// NOTE(erick): The most detailed level we need: its resolution is never lower
+//  than the screen's, so the GPU only ever shrinks a tile by less than half.
+int tile_level_for_zoom(float zoom) {
+    int level = 0;
+    while(level + 1 < TILE_LEVELS && zoom * (1 << (level + 1)) <= 1.0f) {
+        level++;
+    }
+
+    return level;
+}
+
+float tile_level_scale(int level) {
+    return 1.0f / (1 << level);
+}
+
+// NOTE(erick): Canvas area covered by a tile, clipped to the canvas.
+SDL_Rect tile_canvas_rect(int level, int tile_x, int tile_y) {
+    int tile_span = TILE_SIZE << level;
+
+    SDL_Rect result = {.x = tile_x * tile_span, .y = tile_y * tile_span,
+                       .w = tile_span, .h = tile_span};
+
+    if(result.x + result.w > CANVAS_WIDTH)  { result.w = CANVAS_WIDTH - result.x; }
+    if(result.y + result.h > CANVAS_HEIGHT) { result.h = CANVAS_HEIGHT - result.y; }
+
+    return result;
+}
+
+// NOTE(erick): Range of tiles (x, y, columns, rows) of a level that intersect
+//  the given canvas area. May be empty.
+SDL_Rect visible_tiles(TiledCanvas* canvas, int level, SDL_Rect area) {
+    int tile_span = TILE_SIZE << level;
+
+    int x0 = area.x < 0 ? 0 : area.x / tile_span;
+    int y0 = area.y < 0 ? 0 : area.y / tile_span;
+    int x1 = (area.x + area.w - 1) / tile_span;
+    int y1 = (area.y + area.h - 1) / tile_span;
+
+    if(x1 >= canvas->columns[level]) { x1 = canvas->columns[level] - 1; }
+    if(y1 >= canvas->rows[level])    { y1 = canvas->rows[level] - 1; }
+
+    SDL_Rect result = {.x = x0, .y = y0, .w = x1 - x0 + 1, .h = y1 - y0 + 1};
+    if(area.x + area.w <= 0 || result.w < 0) { result.w = 0; }
+    if(area.y + area.h <= 0 || result.h < 0) { result.h = 0; }
+
+    return result;
+}
+
+void begin_tiles_frame(TiledCanvas* canvas) {
+    canvas->frame++;
+}
+
+static Tile* get_tile(TiledCanvas* canvas, int level, int tile_x, int tile_y) {
+    return canvas->tiles[level] + tile_y * canvas->columns[level] + tile_x;
+}
+
+// NOTE(erick): Least recently used slot that was not used in this frame, or -1.
+static int find_free_slot(TiledCanvas* canvas) {
+    int result = -1;
+    for(int i = 0; i < TILE_POOL_SIZE; i++) {
+        TileSlot* slot = canvas->slots + i;
+        if(slot->level < 0) { return i; }
+        if(slot->last_used == canvas->frame) { continue; }
+
+        if(result < 0 || slot->last_used < canvas->slots[result].last_used) {
+            result = i;
+        }
+    }
+
+    return result;
+}
+
+// NOTE(erick): Returns the texture of the tile, or NULL if the pool is
+//  exhausted. needs_render is set when its contents are stale.
+SDL_Texture* acquire_tile(TiledCanvas* canvas, SDL_Renderer* renderer,
+                          int level, int tile_x, int tile_y, bool* needs_render) {
+    Tile* tile = get_tile(canvas, level, tile_x, tile_y);
+
+    if(tile->slot < 0) {
+        int slot_index = find_free_slot(canvas);
+        if(slot_index < 0) { return NULL; }
+
+        TileSlot* slot = canvas->slots + slot_index;
+        if(slot->level >= 0) {
+            get_tile(canvas, slot->level, slot->tile_x, slot->tile_y)->slot = -1;
+        }
+
+        if(!slot->texture) {
+            slot->texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32,
+                                              SDL_TEXTUREACCESS_TARGET,
+                                              TILE_SIZE, TILE_SIZE);
+            if(!slot->texture) {
+                fprintf(stderr, "Failed to create tile texture: %s\n", SDL_GetError());
+                return NULL;
+            }
+        }
+
+        slot->level = level;
+        slot->tile_x = tile_x;
+        slot->tile_y = tile_y;
+
+        tile->slot = slot_index;
+        tile->dirty = true;
+    }
+
+    TileSlot* slot = canvas->slots + tile->slot;
+    slot->last_used = canvas->frame;
+
+    *needs_render = tile->dirty;
+    return slot->texture;
+}
+
+void mark_tile_clean(TiledCanvas* canvas, int level, int tile_x, int tile_y) {
+    get_tile(canvas, level, tile_x, tile_y)->dirty = false;
+}
+
+void invalidate_canvas(TiledCanvas* canvas) {
+    for(int level = 0; level < TILE_LEVELS; level++) {
+        int n_tiles = canvas->columns[level] * canvas->rows[level];
+        for(int i = 0; i < n_tiles; i++) {
+            canvas->tiles[level][i].dirty = true;
+        }
+    }
+}
+
+void invalidate_canvas_rect(TiledCanvas* canvas, SDL_Rect area) {
+    for(int level = 0; level < TILE_LEVELS; level++) {
+        SDL_Rect range = visible_tiles(canvas, level, area);
+
+        for(int tile_y = range.y; tile_y < range.y + range.h; tile_y++) {
+            for(int tile_x = range.x; tile_x < range.x + range.w; tile_x++) {
+                get_tile(canvas, level, tile_x, tile_y)->dirty = true;
+            }
+        }
+    }
+}
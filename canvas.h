@@ -0,0 +1,61 @@
+#ifndef CANVAS_H
+#define CANVAS_H 1
+
+#include <SDL2/SDL.h>
+
+#include "ICs.h"
+
+// NOTE(erick): The canvas is split in square tiles so we never need a texture
+//  larger than TILE_SIZE (some drivers can't do 2480x3508). Level 0 is the
+//  canvas at full resolution, every next level has half the resolution, so a
+//  tile of level n covers (TILE_SIZE << n) canvas pixels on each side.
+#define TILE_SIZE   512
+#define TILE_LEVELS 4
+
+// NOTE(erick): Textures shared by all levels. This is the GPU memory bound:
+//  TILE_POOL_SIZE * TILE_SIZE * TILE_SIZE * 4 bytes. It must hold every tile
+//  of level 0 (5 * 7 tiles), which is the most we ever show in a frame.
+#define TILE_POOL_SIZE 40
+
+typedef struct {
+    // NOTE(erick): Index in the pool or -1 when the tile is not resident.
+    int slot;
+    bool dirty;
+} Tile;
+
+typedef struct {
+    SDL_Texture* texture;
+
+    // NOTE(erick): The tile using this texture. level is -1 when it is free.
+    int level;
+    int tile_x;
+    int tile_y;
+
+    uint64 last_used;
+} TileSlot;
+
+typedef struct {
+    Tile* tiles[TILE_LEVELS];
+    int columns[TILE_LEVELS];
+    int rows[TILE_LEVELS];
+
+    TileSlot slots[TILE_POOL_SIZE];
+    uint64 frame;
+} TiledCanvas;
+
+void init_tiled_canvas(TiledCanvas*);
+void free_tiled_canvas(TiledCanvas*);
+
+int tile_level_for_zoom(float);
+float tile_level_scale(int);
+SDL_Rect tile_canvas_rect(int, int, int);
+SDL_Rect visible_tiles(TiledCanvas*, int, SDL_Rect);
+
+void begin_tiles_frame(TiledCanvas*);
+SDL_Texture* acquire_tile(TiledCanvas*, SDL_Renderer*, int, int, int, bool*);
+void mark_tile_clean(TiledCanvas*, int, int, int);
+
+void invalidate_canvas(TiledCanvas*);
+void invalidate_canvas_rect(TiledCanvas*, SDL_Rect);
+
+#endif
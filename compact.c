@@ -0,0 +1,143 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "compact.h"
+
+#define COMPACT_COLUMNS 3
+#define COMPACT_ROWS 64
+
+static uint ic_height(IC* ic) {
+    return ic->n_pins / 2;
+}
+
+static uint first_row(IC* ic) {
+    if(ic->location.orientation == UP) { return ic->location.row; }
+    return ic->location.row - (ic_height(ic) - 1);
+}
+
+static int compare_by_first_row(const void* a, const void* b) {
+    IC* ic_a = *(IC**) a;
+    IC* ic_b = *(IC**) b;
+
+    if(ic_a->location.column != ic_b->location.column) {
+        return ic_a->location.column < ic_b->location.column ? -1 : 1;
+    }
+
+    uint row_a = first_row(ic_a);
+    uint row_b = first_row(ic_b);
+    if(row_a != row_b) { return row_a < row_b ? -1 : 1; }
+
+    // NOTE(erick): Only overlapping ICs get here. Keep the list order.
+    return ic_a < ic_b ? -1 : (ic_a > ic_b);
+}
+
+// NOTE(erick): Tallest first. Equal heights keep the list order, which is the
+//  order the outside list is drawn in.
+static int compare_by_height(const void* a, const void* b) {
+    IC* ic_a = *(IC**) a;
+    IC* ic_b = *(IC**) b;
+
+    if(ic_height(ic_a) != ic_height(ic_b)) {
+        return ic_height(ic_a) > ic_height(ic_b) ? -1 : 1;
+    }
+
+    return ic_a < ic_b ? -1 : (ic_a > ic_b);
+}
+
+static bool move_to_first_row(ICList list, IC* ic, uint column, uint row) {
+    uint new_row = ic->location.orientation == UP ? row : row + ic_height(ic) - 1;
+    if(ic->location.column == column && ic->location.row == new_row) { return false; }
+
+    record_placement_change(list, ic);
+    ic->location.column = column;
+    ic->location.row = new_row;
+    return true;
+}
+
+Compaction compact_board(ICList ic_list) {
+    Compaction result = {};
+
+    IC** placed = (IC**) malloc((ic_list.count + 1) * sizeof(IC*));
+    IC** outside = (IC**) malloc((ic_list.count + 1) * sizeof(IC*));
+    usize n_placed = 0;
+    usize n_outside = 0;
+
+    for(usize ic_index = 0; ic_index < ic_list.count; ic_index++) {
+        IC* ic = ic_list.data + ic_index;
+
+        // NOTE(erick): Columns past the board only come from broken project
+        //  files. Those ICs go outside too.
+        if(ic->location.column == 0 || ic->location.column > COMPACT_COLUMNS) {
+            if(ic->location.column) { put_ic_outside(ic_list, ic); }
+            outside[n_outside++] = ic;
+        } else {
+            placed[n_placed++] = ic;
+        }
+    }
+
+    qsort(placed, n_placed, sizeof(IC*), compare_by_first_row);
+    qsort(outside, n_outside, sizeof(IC*), compare_by_height);
+
+    // NOTE(erick): After sliding, the free rows of a column are a single run
+    //  from next_row[column] to the last row.
+    uint next_row[COMPACT_COLUMNS + 1] = {0, 1, 1, 1};
+    for(usize i = 0; i < n_placed; i++) {
+        IC* ic = placed[i];
+        uint column = ic->location.column;
+
+        // NOTE(erick): An IC that no longer fits (only possible if the project
+        //  had overlapping ICs) goes outside.
+        if(next_row[column] + ic_height(ic) - 1 > COMPACT_ROWS) {
+            put_ic_outside(ic_list, ic);
+            outside[n_outside++] = ic;
+            continue;
+        }
+
+        result.moved += move_to_first_row(ic_list, ic, column, next_row[column]);
+        next_row[column] += ic_height(ic);
+    }
+
+    for(usize i = 0; i < n_outside; i++) {
+        IC* ic = outside[i];
+        uint height = ic_height(ic);
+
+        uint best_column = 0;
+        uint best_room = COMPACT_ROWS + 1;
+        for(uint column = 1; column <= COMPACT_COLUMNS; column++) {
+            uint room = COMPACT_ROWS + 1 - next_row[column];
+            if(room >= height && room < best_room) {
+                best_column = column;
+                best_room = room;
+            }
+        }
+
+        if(!best_column) {
+            result.still_outside++;
+            continue;
+        }
+
+        // NOTE(erick): Like move_outside_ic_in, ICs come in pointing UP.
+        record_placement_change(ic_list, ic);
+        ic->location.orientation = UP;
+        ic->location.column = best_column;
+        ic->location.row = next_row[best_column];
+
+        next_row[best_column] += height;
+        result.inserted++;
+    }
+
+    for(uint column = 1; column <= COMPACT_COLUMNS; column++) {
+        result.free_rows += COMPACT_ROWS + 1 - next_row[column];
+    }
+
+    free(placed);
+    free(outside);
+
+    return result;
+}
+
+void print_compaction_report(FILE* output, Compaction* compaction) {
+    fprintf(output, "Compaction: %u ICs moved, %u brought in, %u still outside, "
+            "%u free rows.\n", compaction->moved, compaction->inserted,
+            compaction->still_outside, compaction->free_rows);
+}
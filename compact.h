@@ -0,0 +1,24 @@
+#ifndef COMPACT_H
+#define COMPACT_H 1
+
+#include <stdio.h>
+
+#include "ICs.h"
+
+// NOTE(erick): Packs the ICs of every column towards row 1, keeping their
+//  order and orientation, and then moves outside ICs into the rows that were
+//  freed. The outside ICs go tallest first, each into the column with the
+//  least room that still fits it, so the big ones are not left out by small
+//  ones spread everywhere.
+
+typedef struct {
+    uint moved;
+    uint inserted;
+    uint still_outside;
+    uint free_rows;
+} Compaction;
+
+Compaction compact_board(ICList);
+void print_compaction_report(FILE*, Compaction*);
+
+#endif
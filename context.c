@@ -0,0 +1,40 @@
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+
+#include "context.h"
+
+ProjectContext new_project_context(FILE* messages) {
+    ProjectContext result = {};
+    result.messages = messages;
+
+    return result;
+}
+
+static void write_message(ProjectContext* context, const char* message) {
+    if(context->messages) { fputs(message, context->messages); }
+}
+
+void context_message(ProjectContext* context, const char* format, ...) {
+    char message[CONTEXT_MESSAGE_SIZE];
+
+    va_list args;
+    va_start(args, format);
+    vsnprintf(message, sizeof(message), format, args);
+    va_end(args);
+
+    write_message(context, message);
+}
+
+// NOTE(erick): Returns the error, so it can be returned right away.
+int context_error(ProjectContext* context, int error, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    vsnprintf(context->error_message, sizeof(context->error_message), format, args);
+    va_end(args);
+
+    context->error = error;
+    write_message(context, context->error_message);
+
+    return error;
+}
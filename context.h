@@ -0,0 +1,33 @@
+#ifndef CONTEXT_H
+#define CONTEXT_H 1
+
+#include <stdio.h>
+
+#include "types.h"
+
+// NOTE(erick): The core keeps no state of its own and never calls exit.
+//  Whatever a call needs besides its arguments is in a ProjectContext, so
+//  threads working on different projects, each with its own context and its
+//  own lists, may call it at the same time. Errors are returned as the exit
+//  code the editor uses for them (2 and 3 for the ics_list file, 4 for the
+//  project file) and described in the context.
+
+#define CONTEXT_MESSAGE_SIZE 512
+
+typedef struct {
+    // NOTE(erick): Every message is written with a single call, so contexts
+    //  may share a FILE. NULL drops them.
+    FILE* messages;
+
+    // NOTE(erick): The last error reported. 0 when there was none.
+    int error;
+    char error_message[CONTEXT_MESSAGE_SIZE];
+} ProjectContext;
+
+ProjectContext new_project_context(FILE*);
+void context_message(ProjectContext*, const char*, ...)
+    __attribute__((format(printf, 2, 3)));
+int context_error(ProjectContext*, int, const char*, ...)
+    __attribute__((format(printf, 3, 4)));
+
+#endif
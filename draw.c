@@ -8,6 +8,7 @@
 #include <SDL2/SDL.h>
 
 #include "draw.h"
+#include "profiler.h"
 
 typedef enum {
     LEFT,
@@ -19,9 +20,89 @@ typedef enum {
     ALIGN_RIGHT,
 } Alignmnent;
 
-static void save_texture(SDL_Renderer*, SDL_Texture*, const char *);
+#define REGULAR_FONT_FILE "ClearSans-Regular.ttf"
+#define BOLD_FONT_FILE    "ClearSans-Bold.ttf"
 
-DrawData init_SDL() {
+static void clamp_view(DrawData*);
+
+// NOTE(erick): Everything scales with the DPI, rounded the same way the
+//  DEFAULT_DPI macros are, so layout_for_dpi(DEFAULT_DPI) matches them.
+Layout layout_for_dpi(uint dpi) {
+    Layout result;
+
+    result.dpi = dpi;
+    result.canvas_width = CANVAS_WIDTH * dpi / DEFAULT_DPI;
+    result.canvas_height = CANVAS_HEIGHT * dpi / DEFAULT_DPI;
+
+    result.vertical_stride = result.canvas_height / 63;
+    result.number_cell_width = result.vertical_stride;
+
+    int remaining_space = result.canvas_width - 4 * result.number_cell_width;
+    result.text_cell_width = remaining_space / 9;
+    result.ic_cell_width = remaining_space / 9;
+
+    result.line_width = LINE_WIDTH * dpi / DEFAULT_DPI;
+    if(result.line_width < 1) { result.line_width = 1; }
+
+    result.text_font_size = TEXT_FONT_SIZE * dpi / DEFAULT_DPI;
+    result.text_padding = TEXT_PADDING * dpi / DEFAULT_DPI;
+
+    return result;
+}
+
+static void init_draw_resources(DrawData* data) {
+    // NOTE(erick): Tiles are almost always drawn scaled.
+    SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "linear");
+    init_tiled_canvas(&data->canvas);
+    data->layout = layout_for_dpi(DEFAULT_DPI);
+
+    data->text_color.r = 0x00;
+    data->text_color.b = 0x00;
+    data->text_color.g = 0x00;
+    data->text_color.a = 0xff;
+
+    data->white_color.r = 0xff;
+    data->white_color.b = 0xff;
+    data->white_color.g = 0xff;
+    data->white_color.a = 0xff;
+
+    data->black_color.r = 0x00;
+    data->black_color.b = 0x00;
+    data->black_color.g = 0x00;
+    data->black_color.a = 0xff;
+
+    data->vcc_color.r = 0xff;
+    data->vcc_color.b = 0x00;
+    data->vcc_color.g = 0x00;
+    data->vcc_color.a = 0xff;
+
+    data->gnd_color.r = 0x00;
+    data->gnd_color.b = 0x00;
+    data->gnd_color.g = 0xff;
+    data->gnd_color.a = 0xff;
+
+    data->not_connected_color.r = 0x00;
+    data->not_connected_color.b = 0xff;
+    data->not_connected_color.g = 0x00;
+    data->not_connected_color.a = 0xff;
+
+    data->clear_sans = TTF_OpenFont(REGULAR_FONT_FILE, TEXT_FONT_SIZE);
+    data->clear_sans_bold = TTF_OpenFont(BOLD_FONT_FILE, TEXT_FONT_SIZE);
+    data->outside_font = TTF_OpenFont(REGULAR_FONT_FILE, OUTSIDE_TEXT_SIZE);
+
+    init_glyph_atlas(&data->regular_atlas, data->renderer, data->clear_sans);
+    init_glyph_atlas(&data->bold_atlas, data->renderer, data->clear_sans_bold);
+    init_glyph_atlas(&data->outside_atlas, data->renderer, data->outside_font);
+}
+
+static void init_view(DrawData* data) {
+    data->zoom = fit_zoom(data);
+    clamp_view(data);
+}
+
+// NOTE(erick): The window only. Input and the view state need nothing else,
+//  so the renderer can be made later, on the thread that draws.
+DrawData init_SDL_window() {
     DrawData result = {};
 
     if(SDL_Init(SDL_INIT_EVERYTHING) != 0) {
@@ -45,176 +126,270 @@ DrawData init_SDL() {
         exit(5);
     }
 
-    result.renderer = SDL_CreateRenderer(result.window, -1,
-                                         SDL_RENDERER_ACCELERATED |
-                                         SDL_RENDERER_TARGETTEXTURE);
-    result.canvas = SDL_CreateTexture(result.renderer, SDL_PIXELFORMAT_RGBA32,
-                                      SDL_TEXTUREACCESS_TARGET,
-                                      CANVAS_WIDTH, CANVAS_HEIGHT);
+    SDL_SetWindowFullscreen(result.window, SDL_WINDOW_FULLSCREEN);
+    init_view(&result);
+
+    return result;
+}
+
+void init_SDL_renderer(DrawData* data) {
+    data->renderer = SDL_CreateRenderer(data->window, -1,
+                                        SDL_RENDERER_ACCELERATED |
+                                        SDL_RENDERER_TARGETTEXTURE);
+    if(!data->renderer) {
+        fprintf(stderr, "Failed to create renderer: %s\n", SDL_GetError());
+        exit(5);
+    }
 
     SDL_GL_SetSwapInterval(1);
-    SDL_SetWindowFullscreen(result.window, SDL_WINDOW_FULLSCREEN);
 
-    result.text_color.r = 0x00;
-    result.text_color.b = 0x00;
-    result.text_color.g = 0x00;
-    result.text_color.a = 0xff;
+    init_draw_resources(data);
+}
 
-    result.white_color.r = 0xff;
-    result.white_color.b = 0xff;
-    result.white_color.g = 0xff;
-    result.white_color.a = 0xff;
+DrawData init_SDL() {
+    DrawData result = init_SDL_window();
+    init_SDL_renderer(&result);
 
-    result.vcc_color.r = 0xff;
-    result.vcc_color.b = 0x00;
-    result.vcc_color.g = 0x00;
-    result.vcc_color.a = 0xff;
+    return result;
+}
 
-    result.gnd_color.r = 0x00;
-    result.gnd_color.b = 0x00;
-    result.gnd_color.g = 0xff;
-    result.gnd_color.a = 0xff;
+// NOTE(erick): Same as init_SDL but without a window. Everything is drawn by
+//  the software renderer into an off-screen framebuffer of the given size.
+//  This is what the benchmarks use.
+DrawData init_headless_SDL(int width, int height) {
+    DrawData result = {};
+
+    if(SDL_Init(SDL_INIT_EVENTS) != 0) {
+        fprintf(stderr, "Failed to init SDL.");
+        exit(5);
+    }
 
-    result.not_connected_color.r = 0x00;
-    result.not_connected_color.b = 0xff;
-    result.not_connected_color.g = 0x00;
-    result.not_connected_color.a = 0xff;
+    TTF_Init();
 
-    result.clear_sans = TTF_OpenFont("ClearSans-Regular.ttf", TEXT_FONT_SIZE);
-    result.clear_sans_bold = TTF_OpenFont("ClearSans-Bold.ttf", TEXT_FONT_SIZE);
-    result.outside_font = TTF_OpenFont("ClearSans-Regular.ttf", OUTSIDE_TEXT_SIZE);
+    result.width = width;
+    result.height = height;
+
+    result.framebuffer = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32,
+                                                        SDL_PIXELFORMAT_RGBA32);
+    if(!result.framebuffer) {
+        fprintf(stderr, "Failed to create framebuffer: %s\n", SDL_GetError());
+        exit(5);
+    }
+
+    result.renderer = SDL_CreateSoftwareRenderer(result.framebuffer);
+    if(!result.renderer) {
+        fprintf(stderr, "Failed to create renderer: %s\n", SDL_GetError());
+        exit(5);
+    }
+
+    init_draw_resources(&result);
+    init_view(&result);
 
     return result;
 }
 
-static SDL_Texture* text_to_texture(SDL_Renderer* renderer, TTF_Font* font,
-                                    SDL_Color color, char* text) {
-    SDL_Surface* text_surf = TTF_RenderText_Blended(font, text, color);
-    SDL_Texture* result = SDL_CreateTextureFromSurface(renderer, text_surf);
+static int floor_to_int(float value) {
+    int result = (int) value;
+    return value < result ? result - 1 : result;
+}
+
+// NOTE(erick): Maps a canvas rect to the current target. Both edges are
+//  rounded down so neighbouring tiles line up, and nothing gets thinner than
+//  a pixel.
+static SDL_Rect to_target(DrawData* data, SDL_Rect rect) {
+    float scale = data->target_scale;
+    Vec2 origin = data->target_origin;
+
+    int x0 = floor_to_int((rect.x - origin.x) * scale);
+    int y0 = floor_to_int((rect.y - origin.y) * scale);
+    int x1 = floor_to_int((rect.x + rect.w - origin.x) * scale);
+    int y1 = floor_to_int((rect.y + rect.h - origin.y) * scale);
+
+    SDL_Rect result = {.x = x0, .y = y0, .w = x1 - x0, .h = y1 - y0};
+    if(result.w < 1) { result.w = 1; }
+    if(result.h < 1) { result.h = 1; }
+
+    return result;
+}
+
+// NOTE(erick): Nothing is drawn until the batch is flushed.
+static void fill_rect(DrawData* data, BatchLayer layer, SDL_Color color,
+                      SDL_Rect rect) {
+    batch_rect(&data->batch, data->renderer, layer, color, to_target(data, rect));
+}
+
+static void frame_rect(DrawData* data, SDL_Color color, SDL_Rect rect, int border) {
+    SDL_Rect top = {rect.x, rect.y, rect.w, border};
+    SDL_Rect bottom = {rect.x, rect.y + rect.h - border, rect.w, border};
+    SDL_Rect left = {rect.x, rect.y, border, rect.h};
+    SDL_Rect right = {rect.x + rect.w - border, rect.y, border, rect.h};
+
+    fill_rect(data, BATCH_LAYER_LINES, color, top);
+    fill_rect(data, BATCH_LAYER_LINES, color, bottom);
+    fill_rect(data, BATCH_LAYER_LINES, color, left);
+    fill_rect(data, BATCH_LAYER_LINES, color, right);
+}
+
+// NOTE(erick): Where draw_text puts the text, in canvas coordinates.
+static SDL_Rect text_rect(GlyphAtlas* atlas, char* text, int x0, int y0,
+                          int padding_x, int padding_y, Alignmnent alignment) {
+    int w, h;
+    measure_text(atlas, text, &w, &h);
+
+    SDL_Rect result;
+    result.x = alignment == ALIGN_LEFT ? x0 + padding_x : x0 - w - padding_x;
+    result.y = y0 + padding_y;
+    result.w = w;
+    result.h = h;
 
-    SDL_FreeSurface(text_surf);
     return result;
 }
 
-static void draw_text(SDL_Renderer* renderer, TTF_Font* font, SDL_Color color,
+static void draw_text(DrawData* data, GlyphAtlas* atlas, SDL_Color color,
                       char* text, int x0, int y0, int padding_x, int padding_y,
                       Alignmnent alignment) {
-    SDL_Texture* text_texture = text_to_texture(renderer, font, color, text);
+    SDL_Rect dest_rect = text_rect(atlas, text, x0, y0, padding_x, padding_y, alignment);
+    if(!dest_rect.w) { return; }
 
-    int w, h;
-    SDL_QueryTexture(text_texture, NULL, NULL, &w, &h);
-    SDL_Rect dest_rect;
-    dest_rect.x = alignment == ALIGN_LEFT ? x0 + padding_x : x0 - w - padding_x;
+    batch_text(&data->batch, atlas, color, text, to_target(data, dest_rect), 0.0);
+}
+
+static bool is_visible(DrawData* data, SDL_Rect rect) {
+    return SDL_HasIntersection(&rect, &data->cull_rect);
+}
 
-    dest_rect.y = y0 + padding_y;
-    dest_rect.w = w;
-    dest_rect.h = h;
+// NOTE(erick): The first and last rows (inclusive) that touch the cull rect.
+static void visible_rows(DrawData* data, uint* first_row, uint* last_row) {
+    Layout* layout = &data->layout;
+    SDL_Rect cull = data->cull_rect;
 
-    SDL_RenderCopy(renderer, text_texture, NULL, &dest_rect);
+    int first = cull.y / layout->vertical_stride + 1;
+    int last = (cull.y + cull.h - 1) / layout->vertical_stride + 1;
 
-    SDL_DestroyTexture(text_texture);
+    *first_row = first < 1 ? 1 : first;
+    *last_row = last > 64 ? 64 : last;
 }
 
-static void draw_vertical_line_at(SDL_Renderer* renderer, int x) {
-    int x0 = x - LINE_WIDTH / 2;
+static void draw_vertical_line_at(DrawData* data, int x) {
+    Layout* layout = &data->layout;
+    int x0 = x - layout->line_width / 2;
     int y0 = 0;
-    int w = LINE_WIDTH;
-    int h = CANVAS_HEIGHT;
+    int w = layout->line_width;
+    int h = layout->canvas_height;
     SDL_Rect rect = {.x = x0, .y = y0, .w = w, .h = h};
 
-    SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0xff);
-    SDL_RenderFillRect(renderer, &rect);
+    if(!is_visible(data, rect)) { return; }
+
+    fill_rect(data, BATCH_LAYER_LINES, data->black_color, rect);
 }
 
-static void draw_horizontal_line_at(SDL_Renderer* renderer, int y) {
+static void draw_horizontal_line_at(DrawData* data, int y) {
+    Layout* layout = &data->layout;
     int x0 = 0;
-    int y0 = y - LINE_WIDTH / 2;
-    int w = CANVAS_WIDTH;
-    int h = LINE_WIDTH;
+    int y0 = y - layout->line_width / 2;
+    int w = layout->canvas_width;
+    int h = layout->line_width;
     SDL_Rect rect = {.x = x0, .y = y0, .w = w, .h = h};
 
-    SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0xff);
-    SDL_RenderFillRect(renderer, &rect);
+    fill_rect(data, BATCH_LAYER_LINES, data->black_color, rect);
 }
 
-void draw_grid(DrawData* data) {
-    SDL_Renderer* renderer = data->renderer;
-    int current_y = VERTICAL_STRIDE;
-    for(uint i = 1;
-        i < 64;
-        i++, current_y += VERTICAL_STRIDE)
+static void draw_grid(DrawData* data) {
+    Layout* layout = &data->layout;
+
+    uint first_row, last_row;
+    visible_rows(data, &first_row, &last_row);
+
+    // NOTE(erick): Line i is the bottom edge of row i. The last row has none.
+    if(last_row > 63) { last_row = 63; }
+    if(first_row > 1) { first_row--; }
+
+    int current_y = first_row * layout->vertical_stride;
+    for(uint i = first_row;
+        i <= last_row;
+        i++, current_y += layout->vertical_stride)
     {
-        draw_horizontal_line_at(renderer, current_y);
+        draw_horizontal_line_at(data, current_y);
     }
 
     // NOTE(erick): I'm too lazy to think in a loop for these.
-    int current_x = NUMBER_CELL_WIDTH;
-    draw_vertical_line_at(renderer, current_x);
+    int current_x = layout->number_cell_width;
+    draw_vertical_line_at(data, current_x);
 
-    current_x += TEXT_CELL_WIDTH;
-    draw_vertical_line_at(renderer, current_x);
+    current_x += layout->text_cell_width;
+    draw_vertical_line_at(data, current_x);
 
-    current_x += IC_CELL_WIDTH;
-    draw_vertical_line_at(renderer, current_x);
+    current_x += layout->ic_cell_width;
+    draw_vertical_line_at(data, current_x);
 
-    current_x += TEXT_CELL_WIDTH;
-    draw_vertical_line_at(renderer, current_x);
+    current_x += layout->text_cell_width;
+    draw_vertical_line_at(data, current_x);
 
-    current_x += NUMBER_CELL_WIDTH;
-    draw_vertical_line_at(renderer, current_x);
+    current_x += layout->number_cell_width;
+    draw_vertical_line_at(data, current_x);
 
-    current_x += TEXT_CELL_WIDTH;
-    draw_vertical_line_at(renderer, current_x);
+    current_x += layout->text_cell_width;
+    draw_vertical_line_at(data, current_x);
 
-    current_x += IC_CELL_WIDTH;
-    draw_vertical_line_at(renderer, current_x);
+    current_x += layout->ic_cell_width;
+    draw_vertical_line_at(data, current_x);
 
-    current_x += TEXT_CELL_WIDTH;
-    draw_vertical_line_at(renderer, current_x);
+    current_x += layout->text_cell_width;
+    draw_vertical_line_at(data, current_x);
 
-    current_x += NUMBER_CELL_WIDTH;
-    draw_vertical_line_at(renderer, current_x);
+    current_x += layout->number_cell_width;
+    draw_vertical_line_at(data, current_x);
 
-    current_x += TEXT_CELL_WIDTH;
-    draw_vertical_line_at(renderer, current_x);
+    current_x += layout->text_cell_width;
+    draw_vertical_line_at(data, current_x);
 
-    current_x += IC_CELL_WIDTH;
-    draw_vertical_line_at(renderer, current_x);
+    current_x += layout->ic_cell_width;
+    draw_vertical_line_at(data, current_x);
 
-    current_x += TEXT_CELL_WIDTH;
-    draw_vertical_line_at(renderer, current_x);
+    current_x += layout->text_cell_width;
+    draw_vertical_line_at(data, current_x);
 }
 
-void draw_numbers(DrawData* data) {
-    int horizontal_stride = 2 * TEXT_CELL_WIDTH + TEXT_CELL_WIDTH + NUMBER_CELL_WIDTH;
+static void draw_numbers(DrawData* data) {
+    Layout* layout = &data->layout;
+    int horizontal_stride = 2 * layout->text_cell_width + layout->text_cell_width +
+        layout->number_cell_width;
+
+    uint first_row, last_row;
+    visible_rows(data, &first_row, &last_row);
 
     char buffer[4];
-    int current_y = 0; //-5;
-    for(uint i = 1; i <= 64; i++, current_y += VERTICAL_STRIDE) {
+    int current_y = (first_row - 1) * layout->vertical_stride; //-5;
+    for(uint i = first_row; i <= last_row; i++, current_y += layout->vertical_stride) {
         sprintf(buffer, "%2d", i);
 
-        int current_x = NUMBER_CELL_WIDTH; //5;
+        int current_x = layout->number_cell_width; //5;
         for(uint j = 0; j < 4; j++, current_x += horizontal_stride) {
-            draw_text(data->renderer, data->clear_sans, data->text_color, buffer,
-                      current_x, current_y, 5, -5, ALIGN_RIGHT);
+            SDL_Rect cell = {.x = current_x - layout->number_cell_width, .y = current_y,
+                             .w = layout->number_cell_width, .h = layout->vertical_stride};
+            if(!is_visible(data, cell)) { continue; }
+
+            draw_text(data, &data->regular_atlas, data->text_color, buffer,
+                      current_x, current_y, layout->text_padding / 2,
+                      -layout->text_padding / 2, ALIGN_RIGHT);
         }
     }
 }
 
-static Vec2 ic_cell_coord(uint row, uint column) {
+static Vec2 ic_cell_coord(Layout* layout, uint row, uint column) {
     Vec2 result;
 
-    result.y = (row - 1) * VERTICAL_STRIDE;
+    result.y = (row - 1) * layout->vertical_stride;
     result.x = 0;
 
     // NOTE(erick): This is very ugly, cumbersome and spaghetti. But it's fun anyway.
     switch(column) {
     case 3:
-        result.x += NUMBER_CELL_WIDTH + 2 * TEXT_CELL_WIDTH + IC_CELL_WIDTH;
+        result.x += layout->number_cell_width + 2 * layout->text_cell_width + layout->ic_cell_width;
     case 2:
-        result.x += NUMBER_CELL_WIDTH + 2 * TEXT_CELL_WIDTH + IC_CELL_WIDTH;
+        result.x += layout->number_cell_width + 2 * layout->text_cell_width + layout->ic_cell_width;
     case 1:
-        result.x += NUMBER_CELL_WIDTH + TEXT_CELL_WIDTH;
+        result.x += layout->number_cell_width + layout->text_cell_width;
         break;
     default:
         fprintf(stderr, "Invalid IC column (%d).\n", column);
@@ -224,20 +399,20 @@ static Vec2 ic_cell_coord(uint row, uint column) {
     return result;
 }
 
-static Vec2 text_cell_coord(uint row, uint column, ColumnSide side) {
+static Vec2 text_cell_coord(Layout* layout, uint row, uint column, ColumnSide side) {
     Vec2 result;
 
-    result.y = (row - 1) * VERTICAL_STRIDE;
+    result.y = (row - 1) * layout->vertical_stride;
     result.x = 0;
 
     // NOTE(erick): This is very ugly, cumbersome and spaghetti. But it's fun anyway.
     switch(column) {
     case 3:
-        result.x += NUMBER_CELL_WIDTH + 2 * TEXT_CELL_WIDTH + IC_CELL_WIDTH;
+        result.x += layout->number_cell_width + 2 * layout->text_cell_width + layout->ic_cell_width;
     case 2:
-        result.x += NUMBER_CELL_WIDTH + 2 * TEXT_CELL_WIDTH + IC_CELL_WIDTH;
+        result.x += layout->number_cell_width + 2 * layout->text_cell_width + layout->ic_cell_width;
     case 1:
-        result.x += NUMBER_CELL_WIDTH;
+        result.x += layout->number_cell_width;
         break;
     default:
         fprintf(stderr, "Invalid IC column (%d).\n", column);
@@ -245,7 +420,7 @@ static Vec2 text_cell_coord(uint row, uint column, ColumnSide side) {
     }
 
     if(side == RIGHT) {
-        result.x += TEXT_CELL_WIDTH + IC_CELL_WIDTH;
+        result.x += layout->text_cell_width + layout->ic_cell_width;
     }
 
     return result;
@@ -262,24 +437,24 @@ static uint first_ic_row(IC* ic) {
     }
 }
 
-static Vec2 coord_of_ic(IC* ic, Vec2* pin_one) {
+static Vec2 coord_of_ic(Layout* layout, IC* ic, Vec2* pin_one) {
     Vec2 result;
 
     BreadboardLocation loc = ic->location;
 
     int first_row = first_ic_row(ic);
 
-    result.y = (first_row - 1) * VERTICAL_STRIDE;
+    result.y = (first_row - 1) * layout->vertical_stride;
     result.x = 0;
 
     // NOTE(erick): This is very ugly, cumbersome and spaghetti. But it's fun anyway.
     switch(loc.column) {
     case 3:
-        result.x += NUMBER_CELL_WIDTH + 2 * TEXT_CELL_WIDTH + IC_CELL_WIDTH;
+        result.x += layout->number_cell_width + 2 * layout->text_cell_width + layout->ic_cell_width;
     case 2:
-        result.x += NUMBER_CELL_WIDTH + 2 * TEXT_CELL_WIDTH + IC_CELL_WIDTH;
+        result.x += layout->number_cell_width + 2 * layout->text_cell_width + layout->ic_cell_width;
     case 1:
-        result.x += NUMBER_CELL_WIDTH + TEXT_CELL_WIDTH;
+        result.x += layout->number_cell_width + layout->text_cell_width;
         break;
     default:
         fprintf(stderr, "Invalid IC column (%d).\n", loc.column);
@@ -287,20 +462,20 @@ static Vec2 coord_of_ic(IC* ic, Vec2* pin_one) {
     }
 
     if(pin_one) {
-        pin_one->y = (loc.row - 1) * VERTICAL_STRIDE;
+        pin_one->y = (loc.row - 1) * layout->vertical_stride;
         pin_one->x = result.x;
         if(loc.orientation == DOWN) {
-            pin_one->x += IC_CELL_WIDTH - VERTICAL_STRIDE;
+            pin_one->x += layout->ic_cell_width - layout->vertical_stride;
         }
     }
 
     return result;
 }
 
-static Vec2 dimensions_of_ic(IC* ic) {
+static Vec2 dimensions_of_ic(Layout* layout, IC* ic) {
     uint ic_height = ic->n_pins / 2;
 
-    Vec2 result = {.w = IC_CELL_WIDTH, .h = ic_height * VERTICAL_STRIDE};
+    Vec2 result = {.w = layout->ic_cell_width, .h = ic_height * layout->vertical_stride};
     return result;
 }
 
@@ -314,144 +489,512 @@ static uint pin_number_no_rotation(IC* ic, uint pin) {
     }
 }
 
-void prepare_canvas(DrawData* data) {
-    // Attach the canvas;
-    SDL_SetRenderTarget(data->renderer, data->canvas);
+// NOTE(erick): Makes the tile texture the target of the drawing functions.
+static void prepare_tile(DrawData* data, SDL_Texture* texture, SDL_Rect area,
+                         float scale) {
+    data->target_origin.x = area.x;
+    data->target_origin.y = area.y;
+    data->target_scale = scale;
+    data->cull_rect = area;
+
+    SDL_SetRenderTarget(data->renderer, texture);
     SDL_SetRenderDrawColor(data->renderer, 0xff, 0xff, 0xff, 0xff);
     SDL_RenderClear(data->renderer);
 }
 
-static void draw_ic_pins(IC* ic, DrawData* data) {
-    uint current_row = first_ic_row(ic);
-    for(uint pin = 1; pin <= ic->n_pins / 2; pin++, current_row++) {
-        uint no_rotation_pin = pin_number_no_rotation(ic, pin);
-        uint pin_index = no_rotation_pin - 1;
-        Pin* p = ic->pins + pin_index;
+// NOTE(erick): Makes the screen the target of the drawing functions, with the
+//  current zoom and pan.
+static void prepare_screen(DrawData* data) {
+    data->target_origin = data->zoom_origin;
+    data->target_scale = data->zoom;
 
-        Vec2 text_coord = text_cell_coord(current_row, ic->location.column, LEFT);
-        SDL_Color color = data->text_color;
-        if(p->type == VCC) { color = data->vcc_color; }
-        if(p->type == GND) { color = data->gnd_color; }
+    data->cull_rect.x = data->zoom_origin.x;
+    data->cull_rect.y = data->zoom_origin.y;
+    data->cull_rect.w = (int) (data->width / data->zoom) + 1;
+    data->cull_rect.h = (int) (data->height / data->zoom) + 1;
 
-        TTF_Font* font = p->goes_outside ?
-            data->clear_sans_bold : data->clear_sans;
+    SDL_SetRenderTarget(data->renderer, NULL);
+}
+
+// NOTE(erick): Pins are numbered as they are drawn, down the left side and up
+//  the right one.
+static Pin* drawn_pin(IC* ic, uint pin) {
+    return ic->pins + pin_number_no_rotation(ic, pin) - 1;
+}
+
+static GlyphAtlas* pin_label_atlas(DrawData* data, Pin* p) {
+    return p->goes_outside ? &data->bold_atlas : &data->regular_atlas;
+}
 
-        draw_text(data->renderer, font, color,
-                  p->label, text_coord.x + TEXT_CELL_WIDTH,
-                  text_coord.y, TEXT_PADDING, 0, ALIGN_RIGHT);
+// NOTE(erick): Labels on the left are right aligned against the IC, so long
+//  ones run past the left of their cell. They are culled by what they cover.
+static SDL_Rect pin_label_rect(DrawData* data, IC* ic, uint pin) {
+    Layout* layout = &data->layout;
+    Pin* p = drawn_pin(ic, pin);
+    GlyphAtlas* atlas = pin_label_atlas(data, p);
+    uint half = ic->n_pins / 2;
+
+    if(pin <= half) {
+        Vec2 text_coord = text_cell_coord(layout, first_ic_row(ic) + pin - 1,
+                                          ic->location.column, LEFT);
+        return text_rect(atlas, p->label, text_coord.x + layout->text_cell_width,
+                         text_coord.y, layout->text_padding, 0, ALIGN_RIGHT);
     }
 
-    current_row--;
-    for(uint pin = ic->n_pins / 2 + 1; pin <= ic->n_pins; pin++, current_row--) {
-        uint no_rotation_pin = pin_number_no_rotation(ic, pin);
-        uint pin_index = no_rotation_pin - 1;
-        Pin* p = ic->pins + pin_index;
+    Vec2 text_coord = text_cell_coord(layout, first_ic_row(ic) + ic->n_pins - pin,
+                                      ic->location.column, RIGHT);
+    return text_rect(atlas, p->label, text_coord.x, text_coord.y, layout->text_padding,
+                     0, ALIGN_LEFT);
+}
 
-        Vec2 text_coord = text_cell_coord(current_row,
-                                          ic->location.column, RIGHT);
-        SDL_Color color = data->text_color;
-        if(p->type == VCC)            { color = data->vcc_color; }
-        if(p->type == GND)            { color = data->gnd_color; }
-        if(p->type == NOT_CONNECTED)  { color = data->not_connected_color; }
+static void draw_ic_pins(IC* ic, DrawData* data) {
+    for(uint pin = 1; pin <= ic->n_pins; pin++) {
+        Pin* p = drawn_pin(ic, pin);
 
-        TTF_Font* font = p->goes_outside ?
-            data->clear_sans_bold : data->clear_sans;
+        SDL_Rect label_rect = pin_label_rect(data, ic, pin);
+        if(!label_rect.w || !is_visible(data, label_rect)) { continue; }
 
-        draw_text(data->renderer, font, color,
-                  p->label, text_coord.x, text_coord.y, TEXT_PADDING, 0,
-                  ALIGN_LEFT);
+        SDL_Color color = data->text_color;
+        if(p->type == VCC) { color = data->vcc_color; }
+        if(p->type == GND) { color = data->gnd_color; }
+        if(p->type == NOT_CONNECTED && pin > ic->n_pins / 2) {
+            color = data->not_connected_color;
+        }
+
+        batch_text(&data->batch, pin_label_atlas(data, p), color, p->label,
+                   to_target(data, label_rect), 0.0);
     }
 }
 
-static void draw_ic_name(IC* ic, DrawData* data, SDL_Rect ic_rect) {
-    SDL_Texture* name_text = text_to_texture(data->renderer, data->clear_sans_bold,
-                                             data->text_color, ic->name);
-    SDL_Texture* code_text = text_to_texture(data->renderer, data->clear_sans,
-                                             data->text_color, ic->code);
+static void ic_name_rects(DrawData* data, IC* ic, SDL_Rect ic_rect,
+                          SDL_Rect* name_rect, SDL_Rect* code_rect) {
+    Layout* layout = &data->layout;
 
     SDL_Point center = {.x = ic_rect.x + ic_rect.w / 2,
                         .y = ic_rect.y + ic_rect.h / 2};
 
     int name_w, name_h;
-    SDL_QueryTexture(name_text, NULL, NULL, &name_w, &name_h);
-    SDL_Rect name_rect = {.x = center.x - name_w / 2,
-                          .w = name_w, .h = name_h};
+    measure_text(&data->bold_atlas, ic->name, &name_w, &name_h);
+    name_rect->x = center.x - name_w / 2;
+    name_rect->w = name_w;
+    name_rect->h = name_h;
 
     int code_w, code_h;
-    SDL_QueryTexture(code_text, NULL, NULL, &code_w, &code_h);
-    SDL_Rect code_rect = {.x = center.x - code_w / 2,
-                          .w = code_w, .h = code_h};
+    measure_text(&data->regular_atlas, ic->code, &code_w, &code_h);
+    code_rect->x = center.x - code_w / 2;
+    code_rect->w = code_w;
+    code_rect->h = code_h;
 
-    double rotation;
     if(ic->location.orientation == UP) {
-        name_rect.y = center.y - name_h - TEXT_PADDING;
-        code_rect.y = center.y + TEXT_PADDING;
-        rotation = 0.0;
+        name_rect->y = center.y - name_h - layout->text_padding;
+        code_rect->y = center.y + layout->text_padding;
     } else {
-        name_rect.y = center.y + TEXT_PADDING;
-        code_rect.y = center.y - name_h - TEXT_PADDING;
-        rotation = 180.0;
+        name_rect->y = center.y + layout->text_padding;
+        code_rect->y = center.y - name_h - layout->text_padding;
     }
+}
+
+static void draw_ic_name(IC* ic, DrawData* data, SDL_Rect ic_rect) {
+    SDL_Rect name_rect, code_rect;
+    ic_name_rects(data, ic, ic_rect, &name_rect, &code_rect);
 
-    SDL_RenderCopyEx(data->renderer, name_text, NULL, &name_rect, rotation, NULL,
-                     SDL_FLIP_NONE);
-    SDL_RenderCopyEx(data->renderer, code_text, NULL, &code_rect, rotation, NULL,
-                     SDL_FLIP_NONE);
+    double rotation = ic->location.orientation == UP ? 0.0 : 180.0;
 
-    SDL_DestroyTexture(name_text);
-    SDL_DestroyTexture(code_text);
+    if(is_visible(data, name_rect)) {
+        batch_text(&data->batch, &data->bold_atlas, data->text_color, ic->name,
+                   to_target(data, name_rect), rotation);
+    }
+    if(is_visible(data, code_rect)) {
+        batch_text(&data->batch, &data->regular_atlas, data->text_color, ic->code,
+                   to_target(data, code_rect), rotation);
+    }
 }
 
-void draw_ics(DrawData* data, ICList ic_list) {
+// NOTE(erick): Everything an IC may touch: its body, its name and the labels
+//  of its pins as measured, and a line width around them. Empty for ICs
+//  outside the board.
+SDL_Rect footprint_of_ic(DrawData* data, IC* ic) {
+    SDL_Rect result = {};
+    if(ic->location.column == 0) { return result; }
+
+    Layout* layout = &data->layout;
+    Vec2 corner = coord_of_ic(layout, ic, NULL);
+    Vec2 dimensions = dimensions_of_ic(layout, ic);
+
+    SDL_Rect body = {.x = corner.x, .y = corner.y, .w = dimensions.w, .h = dimensions.h};
+    result = body;
+
+    SDL_Rect name_rect, code_rect;
+    ic_name_rects(data, ic, body, &name_rect, &code_rect);
+    SDL_UnionRect(&result, &name_rect, &result);
+    SDL_UnionRect(&result, &code_rect, &result);
+
+    for(uint pin = 1; pin <= ic->n_pins; pin++) {
+        SDL_Rect label_rect = pin_label_rect(data, ic, pin);
+        SDL_UnionRect(&result, &label_rect, &result);
+    }
+
+    result.x -= layout->line_width;
+    result.y -= layout->line_width;
+    result.w += 2 * layout->line_width;
+    result.h += 2 * layout->line_width;
+
+    return result;
+}
+
+static void draw_ics(DrawData* data, ICList ic_list) {
+    Layout* layout = &data->layout;
+
     for(usize ic_index = 0; ic_index < ic_list.count; ic_index++) {
         IC* ic = ic_list.data + ic_index;
 
         if(ic->location.column == 0) { continue; }
+        if(!is_visible(data, footprint_of_ic(data, ic))) { continue; }
 
         Vec2 pin_one;
-        Vec2 corner = coord_of_ic(ic, &pin_one);
-        Vec2 dimensions = dimensions_of_ic(ic);
+        Vec2 corner = coord_of_ic(layout, ic, &pin_one);
+        Vec2 dimensions = dimensions_of_ic(layout, ic);
 
         SDL_Rect ic_outside = {.x = corner.x, .y = corner.y,
                                .h = dimensions.h, .w = dimensions.w};
-        SDL_Rect ic_inside = {.x = ic_outside.x + 1 * LINE_WIDTH,
-                              .y = ic_outside.y + 1 * LINE_WIDTH,
-                              .h = ic_outside.h - 2 * LINE_WIDTH,
-                              .w = ic_outside.w - 2 * LINE_WIDTH};
-        SDL_Rect pin_one_rect = {.x = pin_one.x + 2 * LINE_WIDTH,
-                                 .y = pin_one.y + 2 * LINE_WIDTH,
-                                 .h = VERTICAL_STRIDE / 2,
-                                 .w = VERTICAL_STRIDE / 2};
+        SDL_Rect ic_inside = {.x = ic_outside.x + 1 * layout->line_width,
+                              .y = ic_outside.y + 1 * layout->line_width,
+                              .h = ic_outside.h - 2 * layout->line_width,
+                              .w = ic_outside.w - 2 * layout->line_width};
+        SDL_Rect pin_one_rect = {.x = pin_one.x + 2 * layout->line_width,
+                                 .y = pin_one.y + 2 * layout->line_width,
+                                 .h = layout->vertical_stride / 2,
+                                 .w = layout->vertical_stride / 2};
+
+        fill_rect(data, BATCH_LAYER_LINES, data->black_color, ic_outside);
+        fill_rect(data, BATCH_LAYER_IC_INSIDE, data->white_color, ic_inside);
+        fill_rect(data, BATCH_LAYER_IC_MARK, data->black_color, pin_one_rect);
 
-        SDL_SetRenderDrawColor(data->renderer, 0x00, 0x00, 0x00, 0xff);
-        SDL_RenderFillRect(data->renderer, &ic_outside);
+        draw_ic_name(ic, data, ic_outside);
+        draw_ic_pins(ic, data);
+    }
+}
 
-        SDL_SetRenderDrawColor(data->renderer, 0xff, 0xff, 0xff, 0xff);
-        SDL_RenderFillRect(data->renderer, &ic_inside);
+static void render_tile(DrawData* data, ICList ic_list, SDL_Texture* texture,
+                        int level, int tile_x, int tile_y) {
+    profile_begin(PROFILE_PREPARE_CANVAS);
+    prepare_tile(data, texture, tile_canvas_rect(level, tile_x, tile_y),
+                 tile_level_scale(level));
+    profile_end(PROFILE_PREPARE_CANVAS);
 
-        SDL_SetRenderDrawColor(data->renderer, 0x00, 0x00, 0x00, 0xff);
-        SDL_RenderFillRect(data->renderer, &pin_one_rect);
+    profile_begin(PROFILE_DRAW_GRID);
+    draw_grid(data);
+    profile_end(PROFILE_DRAW_GRID);
 
-        draw_ic_name(ic, data, ic_outside);
-        draw_ic_pins(ic, data);
+    profile_begin(PROFILE_DRAW_NUMBERS);
+    draw_numbers(data);
+    profile_end(PROFILE_DRAW_NUMBERS);
+
+    profile_begin(PROFILE_DRAW_ICS);
+    draw_ics(data, ic_list);
+    profile_end(PROFILE_DRAW_ICS);
+
+    profile_begin(PROFILE_FLUSH_BATCH);
+    flush_batch(&data->batch, data->renderer);
+    profile_end(PROFILE_FLUSH_BATCH);
+
+    mark_tile_clean(&data->canvas, level, tile_x, tile_y);
+    profile_count(PROFILE_TILES_RENDERED);
+}
+
+// NOTE(erick): The canvas area on screen.
+static SDL_Rect view_rect(DrawData* data) {
+    SDL_Rect result = {.x = data->zoom_origin.x, .y = data->zoom_origin.y,
+                       .w = (int) (data->width / data->zoom) + 1,
+                       .h = (int) (data->height / data->zoom) + 1};
+    return result;
+}
+
+// NOTE(erick): Re-renders the visible tiles that are stale. Tiles that are
+//  not visible stay stale until they are.
+void update_canvas_tiles(DrawData* data, ICList ic_list) {
+    TiledCanvas* canvas = &data->canvas;
+    begin_tiles_frame(canvas);
+
+    int level = tile_level_for_zoom(data->zoom);
+    SDL_Rect range = visible_tiles(canvas, level, view_rect(data));
+
+    for(int tile_y = range.y; tile_y < range.y + range.h; tile_y++) {
+        for(int tile_x = range.x; tile_x < range.x + range.w; tile_x++) {
+            bool needs_render;
+            SDL_Texture* texture = acquire_tile(canvas, data->renderer, level,
+                                                tile_x, tile_y, &needs_render);
+            if(texture && needs_render) {
+                render_tile(data, ic_list, texture, level, tile_x, tile_y);
+            }
+        }
+    }
+
+    SDL_SetRenderTarget(data->renderer, NULL);
+}
+
+void invalidate_footprint(DrawData* data, SDL_Rect footprint) {
+    if(footprint.w <= 0 || footprint.h <= 0) { return; }
+
+    invalidate_canvas_rect(&data->canvas, footprint);
+}
+
+float fit_zoom(DrawData* data) {
+    return (float) data->height / CANVAS_HEIGHT;
+}
+
+// NOTE(erick): Keeps the sheet on screen. When the sheet is smaller than the
+//  screen it is centered.
+static void clamp_view(DrawData* data) {
+    int view_w = (int) (data->width / data->zoom);
+    int view_h = (int) (data->height / data->zoom);
+    Vec2* origin = &data->zoom_origin;
+
+    if(view_w >= CANVAS_WIDTH) {
+        origin->x = (CANVAS_WIDTH - view_w) / 2;
+    } else {
+        if(origin->x < 0) { origin->x = 0; }
+        if(origin->x + view_w > CANVAS_WIDTH) { origin->x = CANVAS_WIDTH - view_w; }
     }
+
+    if(view_h >= CANVAS_HEIGHT) {
+        origin->y = (CANVAS_HEIGHT - view_h) / 2;
+    } else {
+        if(origin->y < 0) { origin->y = 0; }
+        if(origin->y + view_h > CANVAS_HEIGHT) { origin->y = CANVAS_HEIGHT - view_h; }
+    }
+}
+
+// NOTE(erick): Zooms around the center of the screen.
+void set_zoom(DrawData* data, float zoom) {
+    float min_zoom = fit_zoom(data);
+    if(zoom < min_zoom) { zoom = min_zoom; }
+    if(zoom > MAX_ZOOM) { zoom = MAX_ZOOM; }
+
+    float center_x = data->zoom_origin.x + data->width / (2.0f * data->zoom);
+    float center_y = data->zoom_origin.y + data->height / (2.0f * data->zoom);
+
+    data->zoom = zoom;
+    data->zoom_origin.x = (int32) (center_x - data->width / (2.0f * zoom));
+    data->zoom_origin.y = (int32) (center_y - data->height / (2.0f * zoom));
+
+    clamp_view(data);
+}
+
+// NOTE(erick): dx and dy are in screen pixels.
+void pan_view(DrawData* data, int32 dx, int32 dy) {
+    int32 canvas_dx = (int32) (dx / data->zoom);
+    int32 canvas_dy = (int32) (dy / data->zoom);
+
+    // NOTE(erick): When zoomed past 1:1 a small pan must still move.
+    if(dx && !canvas_dx) { canvas_dx = dx > 0 ? 1 : -1; }
+    if(dy && !canvas_dy) { canvas_dy = dy > 0 ? 1 : -1; }
+
+    data->zoom_origin.x += canvas_dx;
+    data->zoom_origin.y += canvas_dy;
+
+    clamp_view(data);
 }
 
 void draw_selection(DrawData* data, Selection selection) {
-    Vec2 origin = ic_cell_coord(selection.row, selection.column);
+    Layout* layout = &data->layout;
+    Vec2 origin = ic_cell_coord(layout, selection.row, selection.column);
 
     SDL_Rect selection_rect = {.x = origin.x,
                                .y = origin.y,
-                               .h = VERTICAL_STRIDE,
-                               .w = IC_CELL_WIDTH};
+                               .h = layout->vertical_stride,
+                               .w = layout->ic_cell_width};
 
-    if(selection.state == HOVERING) {
-        SDL_SetRenderDrawColor(data->renderer, 0x00, 0x00, 0xbb, 0xff);
-    } else {
-        SDL_SetRenderDrawColor(data->renderer, 0xaa, 0x00, 0xbb, 0xff);
+    // NOTE(erick): The selection is not part of the sheet, it is drawn over the
+    //  tiles, so moving it never dirties them.
+    prepare_screen(data);
+
+    SDL_Color color = {.r = 0x00, .g = 0x00, .b = 0xbb, .a = 0xff};
+    if(selection.state == SELECTING) {
+        color.r = 0xaa;
+    }
+
+    fill_rect(data, BATCH_LAYER_LINES, color, selection_rect);
+    flush_batch(&data->batch, data->renderer);
+}
+
+// NOTE(erick): Frames the IC cells of every member of the group and, while
+//  its anchor is down, the rectangle that would be added to it.
+void draw_group(DrawData* data, Selection* selection) {
+    ICGroup* group = &selection->group;
+    if(!group->count && !selection->has_anchor) { return; }
+
+    Layout* layout = &data->layout;
+    prepare_screen(data);
+
+    int border = layout->line_width * 2;
+    SDL_Color member_color = {.r = 0xee, .g = 0x88, .b = 0x00, .a = 0xff};
+
+    for(usize i = 0; i < group->count; i++) {
+        IC* ic = group->ics[i];
+        if(ic->location.column == 0) { continue; }
+
+        uint height = ic->n_pins / 2;
+        uint min_row = ic->location.orientation == UP ?
+            ic->location.row : ic->location.row - (height - 1);
+
+        Vec2 origin = ic_cell_coord(layout, min_row, ic->location.column);
+        SDL_Rect ic_rect = {.x = origin.x, .y = origin.y,
+                            .w = layout->ic_cell_width,
+                            .h = height * layout->vertical_stride};
+
+        frame_rect(data, member_color, ic_rect, border);
+    }
+
+    if(selection->has_anchor) {
+        SDL_Color anchor_color = {.r = 0xee, .g = 0xcc, .b = 0x00, .a = 0xff};
+
+        uint min_column = selection->anchor_column;
+        uint max_column = selection->column;
+        if(min_column > max_column) { min_column = max_column; max_column = selection->anchor_column; }
+
+        uint min_row = selection->anchor_row;
+        uint max_row = selection->row;
+        if(min_row > max_row) { min_row = max_row; max_row = selection->anchor_row; }
+
+        // NOTE(erick): The columns are apart on the sheet, so each one gets
+        //  its own frame.
+        for(uint column = min_column; column <= max_column; column++) {
+            Vec2 origin = ic_cell_coord(layout, min_row, column);
+            SDL_Rect column_rect = {.x = origin.x, .y = origin.y,
+                                    .w = layout->ic_cell_width,
+                                    .h = (max_row - min_row + 1) * layout->vertical_stride};
+
+            frame_rect(data, anchor_color, column_rect, border);
+        }
+    }
+
+    flush_batch(&data->batch, data->renderer);
+}
+
+// NOTE(erick): Every strip with a violation gets a red frame around its text
+//  cell. Like the selection it is drawn over the tiles.
+void draw_drc_violations(DrawData* data, DrcState* drc) {
+    if(!drc->n_violations) { return; }
+
+    Layout* layout = &data->layout;
+    prepare_screen(data);
+
+    SDL_Color color = {.r = 0xee, .g = 0x00, .b = 0x00, .a = 0xff};
+    int border = layout->line_width * 2;
+
+    for(uint column = 1; column <= DRC_COLUMNS; column++) {
+        for(uint row = 1; row <= DRC_ROWS; row++) {
+            for(uint side = DRC_LEFT; side <= DRC_RIGHT; side++) {
+                Strip* strip = drc_strip(drc, column, row, side);
+                if(strip->violation == DRC_OK) { continue; }
+
+                Vec2 origin = text_cell_coord(layout, row, column,
+                                              side == DRC_LEFT ? LEFT : RIGHT);
+                SDL_Rect cell = {.x = origin.x, .y = origin.y,
+                                 .w = layout->text_cell_width,
+                                 .h = layout->vertical_stride};
+
+                frame_rect(data, color, cell, border);
+            }
+        }
     }
 
-    SDL_RenderFillRect(data->renderer, &selection_rect);
+    flush_batch(&data->batch, data->renderer);
+}
+
+// NOTE(erick): The footprint of every suggested slot for the outside IC being
+//  picked. The current one is the brightest.
+void draw_slot_suggestions(DrawData* data) {
+    SlotSuggestions* suggestions = &data->slot_suggestions;
+    if(!suggestions->count) { return; }
+
+    Layout* layout = &data->layout;
+    prepare_screen(data);
+
+    uint height = suggestions->ic->n_pins / 2;
+    int border = layout->line_width * 2;
+
+    for(uint i = 0; i < suggestions->count; i++) {
+        BreadboardLocation location = suggestions->slots[i].location;
+        uint min_row = location.orientation == UP ? location.row : location.row - (height - 1);
+
+        Vec2 origin = ic_cell_coord(layout, min_row, location.column);
+        SDL_Rect slot_rect = {.x = origin.x, .y = origin.y,
+                              .w = layout->ic_cell_width,
+                              .h = height * layout->vertical_stride};
+
+        SDL_Color color = {.r = 0x88, .g = 0xcc, .b = 0x88, .a = 0xff};
+        if(i == suggestions->current) {
+            color.r = 0x11;
+            color.g = 0x99;
+            color.b = 0x11;
+        }
+
+        frame_rect(data, color, slot_rect, i == suggestions->current ? 2 * border : border);
+    }
+
+    flush_batch(&data->batch, data->renderer);
+}
+
+// NOTE(erick): Screen space text, drawn right away.
+static void draw_hud_text(DrawData* data, char* text, SDL_Rect text_rect) {
+    batch_text(&data->batch, &data->outside_atlas, data->white_color, text,
+               text_rect, 0.0);
+    flush_batch(&data->batch, data->renderer);
+}
+
+// NOTE(erick): Frames the text cell of every placed pin on the highlighted net
+//  and says how many of its pins are still outside.
+void draw_net_highlight(DrawData* data, NetHighlight* highlight) {
+    Net* net = highlight->net;
+    if(!net) { return; }
+
+    Layout* layout = &data->layout;
+    prepare_screen(data);
+
+    int border = layout->line_width * 2;
+    for(uint i = 0; i < net->n_pins; i++) {
+        IC* ic = net->pins[i].ic;
+        uint pin_index = net->pins[i].pin_index;
+
+        uint row;
+        DrcSide side;
+        if(!pin_strip(ic, ic->location, pin_index, &row, &side)) { continue; }
+
+        Vec2 origin = text_cell_coord(layout, row, ic->location.column,
+                                      side == DRC_LEFT ? LEFT : RIGHT);
+        SDL_Rect cell = {.x = origin.x, .y = origin.y,
+                         .w = layout->text_cell_width,
+                         .h = layout->vertical_stride};
+
+        bool is_source = ic == highlight->ic && pin_index == highlight->pin_index;
+        SDL_Color color = {.r = 0x00, .g = 0x88, .b = 0xee, .a = 0xff};
+        if(is_source) { color.g = 0x44; color.b = 0xaa; }
+
+        frame_rect(data, color, cell, is_source ? 2 * border : border);
+    }
+
+    flush_batch(&data->batch, data->renderer);
+
+    char buffer[256];
+    snprintf(buffer, sizeof(buffer), "%s: %u placed, %u outside", net->label,
+             highlight->n_placed, highlight->n_outside);
+
+    int text_w, text_h;
+    measure_text(&data->outside_atlas, buffer, &text_w, &text_h);
+
+    SDL_Rect text_rect = {.x = TEXT_PADDING, .w = text_w, .h = text_h};
+    text_rect.y = data->height - text_rect.h - TEXT_PADDING;
+
+    SDL_Rect bg_rect = {.x = text_rect.x - 1 * TEXT_PADDING,
+                        .y = text_rect.y - 1 * TEXT_PADDING,
+                        .h = text_rect.h + 2 * TEXT_PADDING,
+                        .w = text_rect.w + 2 * TEXT_PADDING};
+
+    SDL_SetRenderDrawColor(data->renderer, 0x33, 0x33, 0x33, 0xff);
+    SDL_RenderFillRect(data->renderer, &bg_rect);
+    draw_hud_text(data, buffer, text_rect);
 }
 
 void draw_outside_ics_count(DrawData* data, ICList ic_list) {
@@ -460,10 +1003,8 @@ void draw_outside_ics_count(DrawData* data, ICList ic_list) {
     char buffer[256];
     sprintf(buffer, "Outside: %d", count);
 
-    SDL_Texture* text_texture = text_to_texture(data->renderer, data->outside_font,
-                                                data->white_color, buffer);
-    int text_h, text_w;
-    SDL_QueryTexture(text_texture, NULL, NULL, &text_w, &text_h);
+    int text_w, text_h;
+    measure_text(&data->outside_atlas, buffer, &text_w, &text_h);
 
     SDL_Rect text_rect = {.y = TEXT_PADDING, .w = text_w, .h = text_h};
     text_rect.x = data->width - text_rect.w - TEXT_PADDING;
@@ -475,40 +1016,33 @@ void draw_outside_ics_count(DrawData* data, ICList ic_list) {
 
     SDL_SetRenderDrawColor(data->renderer, 0x33, 0x33, 0x33, 0xff);
     SDL_RenderFillRect(data->renderer, &bg_rect);
-    SDL_RenderCopy(data->renderer, text_texture, NULL, &text_rect);
-
-    SDL_DestroyTexture(text_texture);
+    draw_hud_text(data, buffer, text_rect);
 }
 
-void draw_outside_ics_list(DrawData* data, ICList ic_list, uint selected) {
-    if(!count_outside_ics(ic_list)) { return; }
-    // ISSUE(erick): This should be dynamic allocated.
-    char buffer[4096];
-    char* write_ptr = buffer;
+// NOTE(erick): The query and the slice of the matches that fits on the screen,
+//  paged so the selected one is visible. Nothing else is laid out.
+void draw_outside_ics_list(DrawData* data, ICList ic_list) {
+    uint text_vertical_stride = data->outside_atlas.line_skip;
+    int n_lines = (data->height - 2 * TEXT_PADDING) / (int) text_vertical_stride - 1;
+    if(n_lines < 1) { n_lines = 1; }
 
-    for(usize ic_index = 0; ic_index < ic_list.count; ic_index++) {
-        IC* ic = ic_list.data + ic_index;
-        if(ic->location.column == 0) {
-            char tmp[16];
+    uint selected = data->outside_ic_selected;
+    uint first = selected - selected % n_lines;
+    uint last = first + n_lines;
+    if(last > data->n_outside_matches) { last = data->n_outside_matches; }
 
-            strcpy(write_ptr, ic->name);
-            write_ptr += strlen(ic->name);
+    char buffer[4096];
+    usize used = snprintf(buffer, sizeof(buffer), "Find: %s_ (%u)",
+                          data->outside_query, data->n_outside_matches);
 
-            sprintf(tmp, " (%d)\n", ic->n_pins);
-            strcpy(write_ptr, tmp);
-            write_ptr += strlen(tmp);
-        }
+    for(uint i = first; i < last && used < sizeof(buffer); i++) {
+        IC* ic = ic_list.data + data->outside_matches[i];
+        used += snprintf(buffer + used, sizeof(buffer) - used, "\n%s (%d)",
+                         ic->name, ic->n_pins);
     }
 
-    SDL_Surface* text_surf = TTF_RenderText_Blended_Wrapped(data->outside_font, buffer,
-                                                            data->white_color,
-                                                            data->width);
-    SDL_Texture* text_texture = SDL_CreateTextureFromSurface(data->renderer,
-                                                             text_surf);
-    SDL_FreeSurface(text_surf);
-
-    int text_h, text_w;
-    SDL_QueryTexture(text_texture, NULL, NULL, &text_w, &text_h);
+    int text_w, text_h;
+    measure_text(&data->outside_atlas, buffer, &text_w, &text_h);
 
     SDL_Rect text_rect = {.x = TEXT_PADDING, .y = TEXT_PADDING,
                           .w = text_w, .h = text_h};
@@ -518,21 +1052,21 @@ void draw_outside_ics_list(DrawData* data, ICList ic_list, uint selected) {
                         .h = text_rect.h + 2 * TEXT_PADDING,
                         .w = text_rect.w + 2 * TEXT_PADDING};
 
-    uint text_vertical_stride = text_h / count_outside_ics(ic_list);
-    SDL_Rect selected_bg = {.x = bg_rect.x,
-                            .y = selected * text_vertical_stride + TEXT_PADDING,
-                            .w = bg_rect.w,
-                            .h = text_vertical_stride};
-
     SDL_SetRenderDrawColor(data->renderer, 0x33, 0x33, 0x33, 0xff);
     SDL_RenderFillRect(data->renderer, &bg_rect);
 
-    SDL_SetRenderDrawColor(data->renderer, 0x11, 0x99, 0x11, 0xff);
-    SDL_RenderFillRect(data->renderer, &selected_bg);
+    if(data->n_outside_matches) {
+        SDL_Rect selected_bg = {.x = bg_rect.x,
+                                .y = (1 + selected - first) * text_vertical_stride +
+                                     TEXT_PADDING,
+                                .w = bg_rect.w,
+                                .h = text_vertical_stride};
 
-    SDL_RenderCopy(data->renderer, text_texture, NULL, &text_rect);
+        SDL_SetRenderDrawColor(data->renderer, 0x11, 0x99, 0x11, 0xff);
+        SDL_RenderFillRect(data->renderer, &selected_bg);
+    }
 
-    SDL_DestroyTexture(text_texture);
+    draw_hud_text(data, buffer, text_rect);
 }
 
 void draw_saving_screen(DrawData* data) {
@@ -541,6 +1075,9 @@ void draw_saving_screen(DrawData* data) {
                                                     data->white_color);
     SDL_Texture* text_texture = SDL_CreateTextureFromSurface(data->renderer,
                                                              text_surf);
+    SDL_FreeSurface(text_surf);
+    profile_count(PROFILE_TEXT_RASTERIZATIONS);
+    profile_count(PROFILE_TEXTURE_CREATIONS);
 
     int text_h, text_w;
     SDL_QueryTexture(text_texture, NULL, NULL, &text_w, &text_h);
@@ -557,13 +1094,33 @@ void draw_saving_screen(DrawData* data) {
 }
 
 void draw_debug_info(DrawData* data) {
-    char buffer[256];
-    sprintf(buffer, "FPS: %.2f", 1.0 / data->dt);
+    char buffer[1024];
+    char* write_ptr = buffer;
 
-    SDL_Texture* debug_text = text_to_texture(data->renderer, data->outside_font,
-                                              data->white_color, buffer);
-    int text_h, text_w;
-    SDL_QueryTexture(debug_text, NULL, NULL, &text_w, &text_h);
+    float frame_ms = profile_frame_ms();
+    write_ptr += sprintf(write_ptr, "FPS: %.2f (%.2f ms)\n",
+                         frame_ms > 0.0f ? 1000.0f / frame_ms : 0.0f, frame_ms);
+    write_ptr += sprintf(write_ptr, "p50: %.2f ms  p99: %.2f ms\n",
+                         profile_frame_percentile(0.50f),
+                         profile_frame_percentile(0.99f));
+
+    for(uint section = 0; section < PROFILE_SECTION_COUNT; section++) {
+        write_ptr += sprintf(write_ptr, "%s: %.3f ms\n",
+                             profile_section_name(section),
+                             profile_section_ms(section));
+    }
+
+    for(uint counter = 0; counter < PROFILE_COUNTER_COUNT; counter++) {
+        write_ptr += sprintf(write_ptr, "%s: %u\n",
+                             profile_counter_name(counter),
+                             profile_counter(counter));
+    }
+
+    // NOTE(erick): Removing the last line break so we don't get an empty line.
+    write_ptr[-1] = '\0';
+
+    int text_w, text_h;
+    measure_text(&data->outside_atlas, buffer, &text_w, &text_h);
 
     SDL_Rect text_rect = {.x = TEXT_PADDING, .y = TEXT_PADDING,
                           .w = text_w, .h = text_h};
@@ -575,119 +1132,220 @@ void draw_debug_info(DrawData* data) {
 
     SDL_SetRenderDrawColor(data->renderer, 0x33, 0x33, 0x33, 0xff);
     SDL_RenderFillRect(data->renderer, &bg_rect);
-    SDL_RenderCopy(data->renderer, debug_text, NULL, &text_rect);
-
-    SDL_DestroyTexture(debug_text);
+    draw_hud_text(data, buffer, text_rect);
 }
 
 void draw_canvas_to_framebuffer(DrawData* data) {
-    // Detach the canvas;
-    SDL_SetRenderTarget(data->renderer, NULL);
+    TiledCanvas* canvas = &data->canvas;
+
+    prepare_screen(data);
     SDL_SetRenderDrawColor(data->renderer, 0x00, 0x00, 0x00, 0xff);
     SDL_RenderClear(data->renderer);
 
-    SDL_Rect dest_rect;
-    SDL_Rect origin_rect;
-    SDL_Rect* dest = NULL;
-    SDL_Rect* origin = NULL;
-    if(!data->zoomed_in) {
-        dest_rect.h = data->height;
-        dest_rect.w = width_preserve_ratio(data->height);
-        dest_rect.y = 0;
-        dest_rect.x = (data->width - dest_rect.w) / 2;
-        dest = &dest_rect;
-    } else {
-        Vec2* zoom_origin = &data->zoom_origin;
-        origin_rect.x = zoom_origin->x;
-        origin_rect.y = zoom_origin->y;
-        origin_rect.h = data->height;
-        origin_rect.w = data->width;
-
-        origin = &origin_rect;
+    int level = tile_level_for_zoom(data->zoom);
+    float level_scale = tile_level_scale(level);
+    SDL_Rect range = visible_tiles(canvas, level, view_rect(data));
+
+    for(int tile_y = range.y; tile_y < range.y + range.h; tile_y++) {
+        for(int tile_x = range.x; tile_x < range.x + range.w; tile_x++) {
+            bool needs_render;
+            SDL_Texture* texture = acquire_tile(canvas, data->renderer, level,
+                                                tile_x, tile_y, &needs_render);
+            // NOTE(erick): Only when the pool ran out.
+            if(!texture || needs_render) { continue; }
+
+            SDL_Rect area = tile_canvas_rect(level, tile_x, tile_y);
+            SDL_Rect origin_rect = {.x = 0, .y = 0,
+                                    .w = (int) (area.w * level_scale),
+                                    .h = (int) (area.h * level_scale)};
+            SDL_Rect dest_rect = to_target(data, area);
+
+            SDL_RenderCopy(data->renderer, texture, &origin_rect, &dest_rect);
+        }
     }
+}
 
-    SDL_RenderCopyEx(data->renderer, data->canvas,
-                     origin, dest, 0, NULL, SDL_FLIP_NONE);
+void swap_buffers(DrawData* data) {
+    SDL_RenderPresent(data->renderer);
+}
 
-    // int SDL_RenderCopyEx(SDL_Renderer*          renderer,
-    //                  SDL_Texture*           texture,
-    //                  const SDL_Rect*        srcrect,
-    //                  const SDL_Rect*        dstrect,
-    //                  const double           angle,
-    //                  const SDL_Point*       center,
-    //                  const SDL_RendererFlip flip)
+// NOTE(erick): Bands get shorter as the sheet gets wider, so the memory a
+//  print needs does not depend on the DPI.
+#define PRINT_BAND_BYTES (8 * 1024 * 1024)
+
+// NOTE(erick): Draws the rows of the sheet from band_y down, as many as the
+//  canvas has, at scale 1 on the CPU. Nothing touches the tiles or the render
+//  target.
+void render_sheet_soft(DrawData* data, ICList ic_list, SoftCanvas* canvas, int band_y) {
+    Layout* layout = &data->layout;
+
+    data->target_origin.x = 0;
+    data->target_origin.y = band_y;
+    data->target_scale = 1.0f;
+
+    // NOTE(erick): Text may stick out of its cell a little, so the rows around
+    //  the band are drawn too and clipped by the renderer.
+    data->cull_rect.x = 0;
+    data->cull_rect.y = band_y - layout->vertical_stride;
+    data->cull_rect.w = layout->canvas_width;
+    data->cull_rect.h = canvas->height + 2 * layout->vertical_stride;
+
+    profile_begin(PROFILE_DRAW_GRID);
+    draw_grid(data);
+    profile_end(PROFILE_DRAW_GRID);
+
+    profile_begin(PROFILE_DRAW_NUMBERS);
+    draw_numbers(data);
+    profile_end(PROFILE_DRAW_NUMBERS);
+
+    profile_begin(PROFILE_DRAW_ICS);
+    draw_ics(data, ic_list);
+    profile_end(PROFILE_DRAW_ICS);
+
+    profile_begin(PROFILE_FLUSH_BATCH);
+    soft_render_batch(canvas, &data->batch, data->white_color, soft_render_threads());
+    profile_end(PROFILE_FLUSH_BATCH);
+}
 
+static void put_palette_color(ImageOptions* options, SDL_Color color) {
+    uint8* entry = options->palette[options->n_colors++];
+    entry[0] = color.r;
+    entry[1] = color.g;
+    entry[2] = color.b;
 }
 
-void swap_buffers(DrawData* data) {
-    SDL_RenderPresent(data->renderer);
+// NOTE(erick): Renders the sheet band by band and streams it to the output
+//  file. The fonts are opened again at the print size, with atlases that only
+//  keep the coverage.
+static bool print_sheet(DrawData* data, ICList ic_list, char* output_filename,
+                        uint dpi, ImageFormat format) {
+    Layout print_layout = layout_for_dpi(dpi);
+    int width = print_layout.canvas_width;
+    int height = print_layout.canvas_height;
+
+    TTF_Font* regular_font = TTF_OpenFont(REGULAR_FONT_FILE,
+                                          print_layout.text_font_size);
+    TTF_Font* bold_font = TTF_OpenFont(BOLD_FONT_FILE,
+                                       print_layout.text_font_size);
+    if(!regular_font || !bold_font) {
+        fprintf(stderr, "Could not open the fonts to print: %s\n", TTF_GetError());
+        if(regular_font) { TTF_CloseFont(regular_font); }
+        if(bold_font) { TTF_CloseFont(bold_font); }
+
+        return false;
+    }
+
+    GlyphAtlas print_regular_atlas;
+    GlyphAtlas print_bold_atlas;
+    init_glyph_atlas(&print_regular_atlas, NULL, regular_font);
+    init_glyph_atlas(&print_bold_atlas, NULL, bold_font);
+
+    // NOTE(erick): The drawing functions use the sheet atlases and layout
+    //  of data, so the print ones take their place for a while.
+    Layout screen_layout = data->layout;
+    GlyphAtlas screen_regular_atlas = data->regular_atlas;
+    GlyphAtlas screen_bold_atlas = data->bold_atlas;
+    data->layout = print_layout;
+    data->regular_atlas = print_regular_atlas;
+    data->bold_atlas = print_bold_atlas;
+
+    int band_height = PRINT_BAND_BYTES / (width * 4);
+    if(band_height < 1) { band_height = 1; }
+    if(band_height > height) { band_height = height; }
+
+    ImageOptions options = {.format = format, .dpi = dpi,
+                            .n_threads = soft_render_threads()};
+    put_palette_color(&options, data->white_color);
+    put_palette_color(&options, data->text_color);
+    put_palette_color(&options, data->vcc_color);
+    put_palette_color(&options, data->gnd_color);
+    put_palette_color(&options, data->not_connected_color);
+
+    SoftCanvas band = new_soft_canvas(width, band_height);
+    ImageWriter writer;
+    bool began = band.pixels &&
+        begin_image(&writer, output_filename, width, height, &options);
+
+    bool ok = began;
+    for(int band_y = 0; ok && band_y < height; band_y += band_height) {
+        band.height = height - band_y < band_height ? height - band_y : band_height;
+        render_sheet_soft(data, ic_list, &band, band_y);
+        ok = write_image_rows(&writer, band.pixels, band.pitch, band.height);
+    }
+
+    if(began && !end_image(&writer)) { ok = false; }
+    free_soft_canvas(&band);
+
+    print_regular_atlas = data->regular_atlas;
+    print_bold_atlas = data->bold_atlas;
+    data->layout = screen_layout;
+    data->regular_atlas = screen_regular_atlas;
+    data->bold_atlas = screen_bold_atlas;
+
+    free_glyph_atlas(&print_regular_atlas);
+    free_glyph_atlas(&print_bold_atlas);
+    TTF_CloseFont(regular_font);
+    TTF_CloseFont(bold_font);
+
+    return ok;
 }
 
-void save_image(DrawData* data, char* output_filename) {
+void save_image(DrawData* data, ICList ic_list, char* output_filename, uint dpi,
+                ImageFormat format) {
+    if(!print_sheet(data, ic_list, output_filename, dpi, format)) {
+        fprintf(stderr, "Failed saving image.\n");
+        return;
+    }
+
+    fprintf(stderr, "Saved canvas (%u DPI) to \"%s\"\n", dpi, output_filename);
+
+    // NOTE(erick): raster reads a BMP the size of a DEFAULT_DPI sheet.
+    if(format != IMAGE_BMP || dpi != DEFAULT_DPI) { return; }
+
     char* raster_script = "./raster ";
     char* raster_command = (char*) malloc(strlen(output_filename) +
                                           strlen(raster_script) + 1);
     strcpy(raster_command, raster_script);
     strcat(raster_command, output_filename);
 
-    save_texture(data->renderer, data->canvas, output_filename);
-
     system(raster_command);
+    free(raster_command);
 }
 
-// NOTE(erick): Copy-pasta from here:
-// https://stackoverflow.com/questions/34255820/save-sdl-texture-to-file
-static void save_texture(SDL_Renderer* renderer,
-                         SDL_Texture* texture,
-                         const char* filename) {
-    uint32 format;
-    int w, h;
+// NOTE(erick): The sheet as vectors, one page. The editor fonts and layout are
+//  used as they are, the page size comes from the layout DPI.
+void save_pdf(DrawData* data, ICList ic_list, char* output_filename) {
+    Layout* layout = &data->layout;
 
-    /* Get information about texture we want to save */
-    int result = SDL_QueryTexture(texture, &format, NULL, &w, &h);
-    if (result != 0) {
-        fprintf(stderr, "Failed querying texture: %s\n", SDL_GetError());
-        return;
-    }
+    PdfWriter writer;
+    if(!begin_pdf(&writer, output_filename)) { return; }
 
-    int bytes_per_pixel = SDL_BYTESPERPIXEL(format);
-
-    /* Create buffer to hold texture data and load it */
-    void* pixels = malloc(w * h * bytes_per_pixel);
-    if (!pixels) {
-        fprintf(stderr, "Failed allocating memory\n");
-        return;
-    }
-
-    SDL_SetRenderTarget(renderer, texture);
-    result = SDL_RenderReadPixels(renderer, NULL, format, pixels, w * bytes_per_pixel);
-    if (result != 0) {
-        fprintf(stderr, "Failed reading pixel data: %s\n", SDL_GetError());
-        free(pixels);
-        return;
+    if(data->clear_sans) {
+        add_pdf_font(&writer, REGULAR_FONT_FILE, data->clear_sans, TEXT_FONT_SIZE);
     }
-
-    /* Copy pixel data over to surface */
-    SDL_Surface* surf = SDL_CreateRGBSurfaceWithFormatFrom(pixels, w, h,
-                                                           SDL_BITSPERPIXEL(format),
-                                                           w * bytes_per_pixel,
-                                                           format);
-    if (!surf) {
-        fprintf(stderr, "Failed creating new surface: %s\n", SDL_GetError());
-        goto cleanup;
+    if(data->clear_sans_bold) {
+        add_pdf_font(&writer, BOLD_FONT_FILE, data->clear_sans_bold, TEXT_FONT_SIZE);
     }
 
-    /* Save result to an image */
-    result = SDL_SaveBMP(surf, filename);
-    if (result != 0) {
-        fprintf(stderr, "Failed saving image: %s\n", SDL_GetError());
-        goto cleanup;
+    data->target_origin.x = 0;
+    data->target_origin.y = 0;
+    data->target_scale = 1.0f;
+    data->cull_rect.x = 0;
+    data->cull_rect.y = 0;
+    data->cull_rect.w = layout->canvas_width;
+    data->cull_rect.h = layout->canvas_height;
+
+    begin_pdf_page(&writer, layout->canvas_width, layout->canvas_height, layout->dpi);
+    draw_grid(data);
+    draw_numbers(data);
+    draw_ics(data, ic_list);
+    pdf_add_batch(&writer, &data->batch);
+    end_pdf_page(&writer);
+
+    if(!end_pdf(&writer)) {
+        fprintf(stderr, "Failed saving PDF.\n");
+        return;
     }
 
-    fprintf(stderr, "Saved texture as BMP to \"%s\"\n", filename);
-
-cleanup:
-    SDL_SetRenderTarget(renderer, NULL);
-    SDL_FreeSurface(surf);
-    free(pixels);
+    fprintf(stderr, "Saved canvas as PDF to \"%s\"\n", output_filename);
 }
@@ -5,19 +5,15 @@
 #include <SDL2/SDL_ttf.h>
 
 #include "ICs.h"
-
-typedef intptr_t isize;
-typedef int8_t   int8;
-typedef int16_t  int16;
-typedef int32_t  int32;
-typedef int64_t  int64;
-
-typedef size_t       usize;
-typedef uint8_t      uint8;
-typedef uint16_t     uint16;
-typedef uint32_t     uint32;
-typedef uint64_t     uint64;
-typedef unsigned int uint;
+#include "canvas.h"
+#include "batch.h"
+#include "soft_render.h"
+#include "image.h"
+#include "pdf.h"
+#include "drc.h"
+#include "suggest.h"
+#include "search.h"
+#include "nets.h"
 
 #define CANVAS_WIDTH  2480
 #define CANVAS_HEIGHT 3508
@@ -36,8 +32,34 @@ typedef unsigned int uint;
 #define OUTSIDE_TEXT_SIZE 20
 #define TEXT_PADDING 10
 
+// NOTE(erick): The macros above are the sheet at DEFAULT_DPI, which is what
+//  the editor shows. Printing may use any DPI, so the drawing functions take
+//  their geometry from a Layout instead.
+#define DEFAULT_DPI 300
+
+typedef struct {
+    uint dpi;
+
+    int canvas_width;
+    int canvas_height;
+
+    int vertical_stride;
+    int number_cell_width;
+    int text_cell_width;
+    int ic_cell_width;
+
+    int line_width;
+    int text_font_size;
+    int text_padding;
+} Layout;
+
 #define width_preserve_ratio(h) ((h * CANVAS_WIDTH) / CANVAS_HEIGHT)
 
+// NOTE(erick): Zoom is in screen pixels per canvas pixel. The smallest zoom
+//  fits the whole sheet height on the screen.
+#define ZOOM_STEP 1.25f
+#define MAX_ZOOM  4.0f
+
 typedef struct {
     union {
         int32 x;
@@ -54,48 +76,93 @@ typedef struct {
 typedef struct {
     SDL_Window* window;
     SDL_Renderer* renderer;
-    SDL_Texture* canvas;
+    TiledCanvas canvas;
+    RenderBatch batch;
+    // NOTE(erick): Only used by the headless renderer. NULL otherwise.
+    SDL_Surface* framebuffer;
 
     TTF_Font* clear_sans;
     TTF_Font* clear_sans_bold;
     TTF_Font* outside_font;
 
+    GlyphAtlas regular_atlas;
+    GlyphAtlas bold_atlas;
+    GlyphAtlas outside_atlas;
+
     SDL_Color text_color;
     SDL_Color gnd_color;
     SDL_Color vcc_color;
     SDL_Color not_connected_color;
     SDL_Color white_color;
+    SDL_Color black_color;
+
+    // NOTE(erick): Geometry of the sheet being drawn. Always the DEFAULT_DPI
+    //  one, except while printing.
+    Layout layout;
 
     int width;
     int height;
 
     // TODO(erick): This don't belong here!!!!
-    bool zoomed_in;
+    float zoom;
     bool is_selecting_outside_ic;
     bool display_debug_info;
+    // NOTE(erick): The outside IC picker. The selected IC is an index into the
+    //  matches of the query, which are list indices.
     uint outside_ic_selected;
+    char outside_query[SEARCH_MAX_QUERY];
+    SearchIndex outside_index;
+    uint32* outside_matches;
+    uint n_outside_matches;
+    SlotSuggestions slot_suggestions;
+    // NOTE(erick): Canvas point shown at the top-left corner of the screen.
+    //  Negative when the sheet is narrower than the screen.
     Vec2 zoom_origin;
 
+    // NOTE(erick): Where the drawing functions put the canvas. A canvas point p
+    //  lands at (p - target_origin) * target_scale on the current target.
+    Vec2 target_origin;
+    float target_scale;
+
+    // NOTE(erick): The part of the canvas covered by the current target, in
+    //  canvas coordinates. Anything outside it is not drawn.
+    SDL_Rect cull_rect;
+
     float dt;
 } DrawData;
 
 
+Layout layout_for_dpi(uint);
+
+DrawData init_SDL_window();
+void init_SDL_renderer(DrawData*);
 DrawData init_SDL();
+DrawData init_headless_SDL(int, int);
+
+float fit_zoom(DrawData*);
+void set_zoom(DrawData*, float);
+void pan_view(DrawData*, int32, int32);
+
+SDL_Rect footprint_of_ic(DrawData*, IC*);
+void invalidate_footprint(DrawData*, SDL_Rect);
+void update_canvas_tiles(DrawData*, ICList);
 
-void prepare_canvas(DrawData*);
-void draw_grid(DrawData*);
-void draw_numbers(DrawData*);
-void draw_ics(DrawData*, ICList);
 void draw_selection(DrawData*, Selection);
+void draw_group(DrawData*, Selection*);
+void draw_drc_violations(DrawData*, DrcState*);
+void draw_slot_suggestions(DrawData*);
+void draw_net_highlight(DrawData*, NetHighlight*);
 void draw_outside_ics_count(DrawData*, ICList);
 void draw_debug_info(DrawData*);
-void draw_outside_ics_list(DrawData*, ICList, uint);
+void draw_outside_ics_list(DrawData*, ICList);
 
 void draw_saving_screen(DrawData*);
 
 void draw_canvas_to_framebuffer(DrawData* data);
 void swap_buffers(DrawData*);
 
-void save_image(DrawData*, char*);
+void render_sheet_soft(DrawData*, ICList, SoftCanvas*, int);
+void save_image(DrawData*, ICList, char*, uint, ImageFormat);
+void save_pdf(DrawData*, ICList, char*);
 
 #endif
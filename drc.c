@@ -0,0 +1,220 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "drc.h"
+
+static const char* kind_names[] = {
+    "ok",
+    "duplicate label",
+    "signal short",
+    "not connected pin shared",
+    "power short",
+};
+
+const char* drc_kind_name(DrcKind kind) {
+    return kind_names[kind];
+}
+
+// NOTE(erick): Rows and columns start at 1, like BreadboardLocation.
+Strip* drc_strip(DrcState* drc, uint column, uint row, DrcSide side) {
+    if(column < 1 || column > DRC_COLUMNS) { return NULL; }
+    if(row < 1 || row > DRC_ROWS) { return NULL; }
+
+    return &drc->strips[column - 1][row - 1][side];
+}
+
+// NOTE(erick): Same pin placement the sheet is drawn with. An IC pointing UP
+//  has pin 1 at its top left, one pointing DOWN is turned 180 degrees.
+bool pin_strip(IC* ic, BreadboardLocation location, uint pin_index,
+               uint* strip_row, DrcSide* strip_side) {
+    uint half = ic->n_pins / 2;
+    int row;
+    DrcSide side;
+
+    if(location.orientation == UP) {
+        if(pin_index < half) {
+            side = DRC_LEFT;
+            row = location.row + pin_index;
+        } else {
+            side = DRC_RIGHT;
+            row = location.row + (ic->n_pins - 1 - pin_index);
+        }
+    } else {
+        if(pin_index < half) {
+            side = DRC_RIGHT;
+            row = (int) location.row - pin_index;
+        } else {
+            side = DRC_LEFT;
+            row = (int) location.row - (ic->n_pins - 1 - pin_index);
+        }
+    }
+
+    if(location.column < 1 || location.column > DRC_COLUMNS) { return false; }
+    if(row < 1 || row > DRC_ROWS) { return false; }
+
+    *strip_row = row;
+    *strip_side = side;
+    return true;
+}
+
+static Strip* strip_of_pin(DrcState* drc, IC* ic, BreadboardLocation location,
+                           uint pin_index) {
+    uint row;
+    DrcSide side;
+    if(!pin_strip(ic, location, pin_index, &row, &side)) { return NULL; }
+
+    return drc_strip(drc, location.column, row, side);
+}
+
+static DrcKind check_strip(Strip* strip) {
+    if(strip->n_pins < 2) { return DRC_OK; }
+
+    bool has_vcc = false;
+    bool has_gnd = false;
+    bool has_not_connected = false;
+    bool same_label = true;
+
+    char* first_label = strip->pins[0].ic->pins[strip->pins[0].pin_index].label;
+    for(uint i = 0; i < strip->n_pins; i++) {
+        Pin* pin = strip->pins[i].ic->pins + strip->pins[i].pin_index;
+
+        if(pin->type == VCC) { has_vcc = true; }
+        if(pin->type == GND) { has_gnd = true; }
+        if(pin->type == NOT_CONNECTED) { has_not_connected = true; }
+        if(strcmp(pin->label, first_label) != 0) { same_label = false; }
+    }
+
+    if(has_vcc && has_gnd) { return DRC_POWER_SHORT; }
+    if(has_not_connected) { return DRC_NOT_CONNECTED_SHARED; }
+    if(!same_label) { return DRC_SIGNAL_SHORT; }
+
+    return DRC_DUPLICATE_LABEL;
+}
+
+static void recheck_strip(DrcState* drc, Strip* strip) {
+    if(strip->violation != DRC_OK) { drc->n_violations--; }
+    strip->violation = check_strip(strip);
+    if(strip->violation != DRC_OK) { drc->n_violations++; }
+}
+
+static void add_ic_pins(DrcState* drc, IC* ic, BreadboardLocation location) {
+    if(location.column == 0) { return; }
+
+    for(uint pin_index = 0; pin_index < ic->n_pins; pin_index++) {
+        Strip* strip = strip_of_pin(drc, ic, location, pin_index);
+        if(!strip) { continue; }
+
+        if(strip->n_pins == strip->capacity) {
+            strip->capacity = strip->capacity ? strip->capacity * 2 : 2;
+            strip->pins = (StripPin*) realloc(strip->pins,
+                                              strip->capacity * sizeof(StripPin));
+        }
+
+        StripPin strip_pin = {.ic = ic, .pin_index = pin_index};
+        strip->pins[strip->n_pins++] = strip_pin;
+        recheck_strip(drc, strip);
+    }
+}
+
+static void remove_ic_pins(DrcState* drc, IC* ic, BreadboardLocation location) {
+    if(location.column == 0) { return; }
+
+    for(uint pin_index = 0; pin_index < ic->n_pins; pin_index++) {
+        Strip* strip = strip_of_pin(drc, ic, location, pin_index);
+        if(!strip) { continue; }
+
+        for(uint i = 0; i < strip->n_pins; i++) {
+            if(strip->pins[i].ic == ic && strip->pins[i].pin_index == pin_index) {
+                strip->pins[i] = strip->pins[--strip->n_pins];
+                break;
+            }
+        }
+
+        recheck_strip(drc, strip);
+    }
+}
+
+static bool same_location(BreadboardLocation a, BreadboardLocation b) {
+    return a.column == b.column && a.row == b.row && a.orientation == b.orientation;
+}
+
+void init_drc(DrcState* drc, ICList ic_list) {
+    memset(drc, 0, sizeof(DrcState));
+
+    drc->ics = ic_list.data;
+    drc->n_ics = ic_list.count;
+    drc->placed = (BreadboardLocation*) calloc(ic_list.count + 1,
+                                               sizeof(BreadboardLocation));
+
+    for(usize ic_index = 0; ic_index < ic_list.count; ic_index++) {
+        IC* ic = ic_list.data + ic_index;
+
+        drc->placed[ic_index] = ic->location;
+        add_ic_pins(drc, ic, ic->location);
+    }
+}
+
+// NOTE(erick): The journal may have the same IC many times. Only where its
+//  pins are now and where they were last checked matter.
+void update_drc(DrcState* drc, PlacementJournal* journal) {
+    for(usize i = 0; i < journal->count; i++) {
+        IC* ic = journal->changes[i].ic;
+        if(ic < drc->ics || ic >= drc->ics + drc->n_ics) { continue; }
+
+        BreadboardLocation* placed = drc->placed + (ic - drc->ics);
+        if(same_location(*placed, ic->location)) { continue; }
+
+        remove_ic_pins(drc, ic, *placed);
+        add_ic_pins(drc, ic, ic->location);
+        *placed = ic->location;
+    }
+}
+
+// NOTE(erick): For an IC whose pins are about to change. Its pins leave the
+//  strips now and come back on the next update that has it in the journal.
+void forget_drc_ic(DrcState* drc, IC* ic) {
+    if(ic < drc->ics || ic >= drc->ics + drc->n_ics) { return; }
+
+    BreadboardLocation* placed = drc->placed + (ic - drc->ics);
+    remove_ic_pins(drc, ic, *placed);
+    placed->column = 0;
+}
+
+void free_drc(DrcState* drc) {
+    for(uint column = 0; column < DRC_COLUMNS; column++) {
+        for(uint row = 0; row < DRC_ROWS; row++) {
+            free(drc->strips[column][row][DRC_LEFT].pins);
+            free(drc->strips[column][row][DRC_RIGHT].pins);
+        }
+    }
+
+    free(drc->placed);
+    memset(drc, 0, sizeof(DrcState));
+}
+
+void print_drc_report(FILE* output, DrcState* drc) {
+    for(uint column = 1; column <= DRC_COLUMNS; column++) {
+        for(uint row = 1; row <= DRC_ROWS; row++) {
+            for(uint side = DRC_LEFT; side <= DRC_RIGHT; side++) {
+                Strip* strip = drc_strip(drc, column, row, side);
+                if(strip->violation == DRC_OK) { continue; }
+
+                fprintf(output, "column %u, row %2u, %s: %s:", column, row,
+                        side == DRC_LEFT ? "left" : "right",
+                        drc_kind_name(strip->violation));
+
+                for(uint i = 0; i < strip->n_pins; i++) {
+                    StripPin* strip_pin = strip->pins + i;
+                    fprintf(output, " %s.%u (%s)", strip_pin->ic->name,
+                            strip_pin->pin_index + 1,
+                            strip_pin->ic->pins[strip_pin->pin_index].label);
+                }
+                fprintf(output, "\n");
+            }
+        }
+    }
+
+    fprintf(output, "%u violation%s.\n", drc->n_violations,
+            drc->n_violations == 1 ? "" : "s");
+}
@@ -0,0 +1,69 @@
+#ifndef DRC_H
+#define DRC_H 1
+
+#include <stdio.h>
+
+#include "ICs.h"
+
+// NOTE(erick): Design rule check of the placement. Every breadboard row has a
+//  strip on each side of the IC channel, and every pin of an IC on the board
+//  lands on one strip. Pins sharing a strip are connected, which is always a
+//  mistake since the pins belong to overlapping ICs, but how bad it is depends
+//  on the pins. A full check is done once and afterwards only the strips of
+//  the ICs that moved are checked again.
+
+#define DRC_COLUMNS 3
+#define DRC_ROWS 64
+
+typedef enum {
+    DRC_LEFT,
+    DRC_RIGHT,
+} DrcSide;
+
+// NOTE(erick): In increasing severity. A strip reports the worst it has.
+typedef enum {
+    DRC_OK,
+    // NOTE(erick): Pins with the same label, already meant to be connected.
+    DRC_DUPLICATE_LABEL,
+    DRC_SIGNAL_SHORT,
+    DRC_NOT_CONNECTED_SHARED,
+    DRC_POWER_SHORT,
+
+    DRC_N_KINDS,
+} DrcKind;
+
+typedef struct {
+    IC* ic;
+    uint pin_index;
+} StripPin;
+
+typedef struct {
+    StripPin* pins;
+    uint n_pins;
+    uint capacity;
+
+    DrcKind violation;
+} Strip;
+
+typedef struct {
+    Strip strips[DRC_COLUMNS][DRC_ROWS][2];
+    uint n_violations;
+
+    // NOTE(erick): Where the pins of every IC of the list are in the strips.
+    //  Column 0 means none.
+    IC* ics;
+    BreadboardLocation* placed;
+    usize n_ics;
+} DrcState;
+
+void init_drc(DrcState*, ICList);
+void update_drc(DrcState*, PlacementJournal*);
+void forget_drc_ic(DrcState*, IC*);
+void free_drc(DrcState*);
+
+Strip* drc_strip(DrcState*, uint, uint, DrcSide);
+bool pin_strip(IC*, BreadboardLocation, uint, uint*, DrcSide*);
+const char* drc_kind_name(DrcKind);
+void print_drc_report(FILE*, DrcState*);
+
+#endif
@@ -0,0 +1,281 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "group.h"
+
+#define GROUP_COLUMNS 3
+#define GROUP_ROWS 64
+
+static uint ic_height(IC* ic) {
+    return ic->n_pins / 2;
+}
+
+static int first_row(IC* ic, BreadboardLocation location) {
+    if(location.orientation == UP) { return (int) location.row; }
+    return (int) location.row - (int) (ic_height(ic) - 1);
+}
+
+// NOTE(erick): The rows an IC takes at a location, bit 0 being row 1. False
+//  when it does not fit on the board there.
+static bool footprint(IC* ic, BreadboardLocation location, uint64* mask) {
+    if(location.column < 1 || location.column > GROUP_COLUMNS) { return false; }
+
+    int first = first_row(ic, location);
+    int height = ic_height(ic);
+    if(height < 1) { return false; }
+    if(first < 1 || first + height - 1 > GROUP_ROWS) { return false; }
+
+    uint64 rows = height == 64 ? ~0ull : (1ull << height) - 1;
+    *mask = rows << (first - 1);
+    return true;
+}
+
+bool group_contains(ICGroup* group, IC* ic) {
+    for(usize i = 0; i < group->count; i++) {
+        if(group->ics[i] == ic) { return true; }
+    }
+
+    return false;
+}
+
+static void add_to_group(ICGroup* group, IC* ic) {
+    if(group_contains(group, ic)) { return; }
+
+    if(group->count == group->capacity) {
+        group->capacity = group->capacity ? group->capacity * 2 : 16;
+        group->ics = (IC**) realloc(group->ics, group->capacity * sizeof(IC*));
+    }
+
+    group->ics[group->count++] = ic;
+}
+
+static void remove_from_group(ICGroup* group, IC* ic) {
+    for(usize i = 0; i < group->count; i++) {
+        if(group->ics[i] == ic) {
+            group->ics[i] = group->ics[--group->count];
+            return;
+        }
+    }
+}
+
+void clear_group(ICGroup* group) {
+    group->count = 0;
+}
+
+static IC* ic_at(ICList list, uint column, uint row) {
+    for(usize ic_index = 0; ic_index < list.count; ic_index++) {
+        IC* ic = list.data + ic_index;
+
+        if(ic->location.column != column) { continue; }
+        if(row_is_inside_ic(ic, row)) { return ic; }
+    }
+
+    return NULL;
+}
+
+void toggle_group_member(ICList list, Selection* selection) {
+    IC* ic = ic_at(list, selection->column, selection->row);
+    if(!ic) { return; }
+
+    if(group_contains(&selection->group, ic)) {
+        remove_from_group(&selection->group, ic);
+    } else {
+        add_to_group(&selection->group, ic);
+    }
+}
+
+// NOTE(erick): Every IC with a row inside the rectangle from the anchor to the
+//  selection joins the group.
+void add_rect_to_group(ICList list, Selection* selection) {
+    uint min_column = selection->anchor_column;
+    uint max_column = selection->column;
+    if(min_column > max_column) { min_column = max_column; max_column = selection->anchor_column; }
+
+    int min_row = selection->anchor_row;
+    int max_row = selection->row;
+    if(min_row > max_row) { min_row = max_row; max_row = selection->anchor_row; }
+
+    for(usize ic_index = 0; ic_index < list.count; ic_index++) {
+        IC* ic = list.data + ic_index;
+
+        if(ic->location.column < min_column) { continue; }
+        if(ic->location.column > max_column) { continue; }
+
+        int first = first_row(ic, ic->location);
+        int last = first + ic_height(ic) - 1;
+        if(last < min_row || first > max_row) { continue; }
+
+        add_to_group(&selection->group, ic);
+    }
+
+    selection->has_anchor = false;
+}
+
+// NOTE(erick): Moves every ics[i] to locations[i], or none of them when one
+//  does not fit. The ICs being moved do not block each other where they are
+//  now, only where they are going.
+static bool place_all(ICList list, IC** ics, BreadboardLocation* locations,
+                      usize count) {
+    uint64 taken[GROUP_COLUMNS + 1] = {};
+
+    bool* is_moving = (bool*) calloc(list.count + 1, sizeof(bool));
+    for(usize i = 0; i < count; i++) {
+        is_moving[ics[i] - list.data] = true;
+    }
+
+    for(usize ic_index = 0; ic_index < list.count; ic_index++) {
+        IC* ic = list.data + ic_index;
+        if(is_moving[ic_index]) { continue; }
+
+        uint64 mask;
+        if(footprint(ic, ic->location, &mask)) {
+            taken[ic->location.column] |= mask;
+        }
+    }
+    free(is_moving);
+
+    for(usize i = 0; i < count; i++) {
+        uint64 mask;
+        if(!footprint(ics[i], locations[i], &mask)) { return false; }
+        if(taken[locations[i].column] & mask) { return false; }
+
+        taken[locations[i].column] |= mask;
+    }
+
+    // NOTE(erick): Everything fits. We can move the ICs.
+    for(usize i = 0; i < count; i++) {
+        record_placement_change(list, ics[i]);
+        ics[i]->location = locations[i];
+    }
+
+    return true;
+}
+
+static bool group_is_placed(ICGroup* group) {
+    if(!group->count) { return false; }
+
+    for(usize i = 0; i < group->count; i++) {
+        if(group->ics[i]->location.column == 0) { return false; }
+    }
+
+    return true;
+}
+
+bool try_to_move_group(ICList list, ICGroup* group, int32 d_column, int32 d_row) {
+    if(!group_is_placed(group)) { return false; }
+
+    BreadboardLocation* locations = (BreadboardLocation*)
+        malloc(group->count * sizeof(BreadboardLocation));
+
+    for(usize i = 0; i < group->count; i++) {
+        locations[i] = group->ics[i]->location;
+        locations[i].column += d_column;
+        locations[i].row += d_row;
+    }
+
+    bool success = place_all(list, group->ics, locations, group->count);
+    free(locations);
+    return success;
+}
+
+// NOTE(erick): The group is turned 180 degrees inside the rectangle around it,
+//  so the columns are mirrored as well as the rows. The selection turns along.
+bool rotate_group(ICList list, Selection* selection) {
+    ICGroup* group = &selection->group;
+    if(!group_is_placed(group)) { return false; }
+
+    uint min_column = GROUP_COLUMNS;
+    uint max_column = 1;
+    int min_row = GROUP_ROWS;
+    int max_row = 1;
+
+    for(usize i = 0; i < group->count; i++) {
+        IC* ic = group->ics[i];
+        int first = first_row(ic, ic->location);
+        int last = first + ic_height(ic) - 1;
+
+        if(ic->location.column < min_column) { min_column = ic->location.column; }
+        if(ic->location.column > max_column) { max_column = ic->location.column; }
+        if(first < min_row) { min_row = first; }
+        if(last > max_row) { max_row = last; }
+    }
+
+    BreadboardLocation* locations = (BreadboardLocation*)
+        malloc(group->count * sizeof(BreadboardLocation));
+
+    for(usize i = 0; i < group->count; i++) {
+        IC* ic = group->ics[i];
+        int last = first_row(ic, ic->location) + ic_height(ic) - 1;
+        int new_first = min_row + max_row - last;
+
+        locations[i].column = min_column + max_column - ic->location.column;
+        if(ic->location.orientation == UP) {
+            locations[i].orientation = DOWN;
+            locations[i].row = new_first + ic_height(ic) - 1;
+        } else {
+            locations[i].orientation = UP;
+            locations[i].row = new_first;
+        }
+    }
+
+    bool success = place_all(list, group->ics, locations, group->count);
+    free(locations);
+
+    if(success) {
+        selection->column = min_column + max_column - selection->column;
+        selection->row = min_row + max_row - selection->row;
+    }
+
+    return success;
+}
+
+void put_group_outside(ICList list, ICGroup* group) {
+    for(usize i = 0; i < group->count; i++) {
+        put_ic_outside(list, group->ics[i]);
+    }
+
+    clear_group(group);
+}
+
+// NOTE(erick): Lays out outside ICs with the same code as the members the way
+//  the group is, d_column columns away. The group itself does not move.
+bool copy_group(ICList list, ICGroup* group, int32 d_column) {
+    if(!group_is_placed(group)) { return false; }
+
+    IC** copies = (IC**) malloc(group->count * sizeof(IC*));
+    BreadboardLocation* locations = (BreadboardLocation*)
+        malloc(group->count * sizeof(BreadboardLocation));
+    bool* is_taken = (bool*) calloc(list.count + 1, sizeof(bool));
+
+    bool success = true;
+    for(usize i = 0; i < group->count && success; i++) {
+        IC* member = group->ics[i];
+        copies[i] = NULL;
+
+        for(usize ic_index = 0; ic_index < list.count; ic_index++) {
+            IC* ic = list.data + ic_index;
+
+            if(ic->location.column != 0 || is_taken[ic_index]) { continue; }
+            if(ic->n_pins != member->n_pins) { continue; }
+            if(strcmp(ic->code, member->code) != 0) { continue; }
+
+            copies[i] = ic;
+            is_taken[ic_index] = true;
+            break;
+        }
+
+        if(!copies[i]) { success = false; break; }
+
+        locations[i] = member->location;
+        locations[i].column += d_column;
+    }
+
+    if(success) {
+        success = place_all(list, copies, locations, group->count);
+    }
+
+    free(is_taken);
+    free(locations);
+    free(copies);
+    return success;
+}
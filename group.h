@@ -0,0 +1,22 @@
+#ifndef GROUP_H
+#define GROUP_H 1
+
+#include "ICs.h"
+
+// NOTE(erick): Operations on the group of ICs of the selection. A group
+//  operation first finds where every member ends up, then checks all of them
+//  at once against the rows taken by the ICs outside of the group, kept as one
+//  row mask per column, and only then moves them. Either the whole group moves
+//  or nothing does.
+
+bool group_contains(ICGroup*, IC*);
+void clear_group(ICGroup*);
+void toggle_group_member(ICList, Selection*);
+void add_rect_to_group(ICList, Selection*);
+
+bool try_to_move_group(ICList, ICGroup*, int32, int32);
+bool rotate_group(ICList, Selection*);
+void put_group_outside(ICList, ICGroup*);
+bool copy_group(ICList, ICGroup*, int32);
+
+#endif
@@ -0,0 +1,478 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include <zlib.h>
+
+#include "image.h"
+
+#define BMP_HEADER_SIZE 54
+
+// NOTE(erick): PNG data is compressed in independent jobs of about this many
+//  bytes, one per thread, each primed with the data before it so the
+//  compression barely suffers. The jobs are joined with sync flushes into a
+//  single zlib stream, like pigz does.
+#define PNG_JOB_BYTES (256 * 1024)
+#define PNG_WINDOW (32 * 1024)
+#define PNG_COMPRESSION_LEVEL 6
+#define PNG_FILTER_UP 2
+
+static const char* format_names[] = {
+    "bmp",
+    "png",
+    "png-palette",
+    "png-mono",
+};
+
+static const char* format_extensions[] = {
+    ".bmp",
+    ".png",
+    ".png",
+    ".png",
+};
+
+bool parse_image_format(char* name, ImageFormat* format) {
+    for(uint i = 0; i < sizeof(format_names) / sizeof(format_names[0]); i++) {
+        if(strcmp(name, format_names[i]) == 0) {
+            *format = (ImageFormat) i;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+const char* image_format_extension(ImageFormat format) {
+    return format_extensions[format];
+}
+
+static void put_u16(uint8* dest, uint16 value) {
+    dest[0] = value & 0xff;
+    dest[1] = (value >> 8) & 0xff;
+}
+
+static void put_u32(uint8* dest, uint32 value) {
+    dest[0] = value & 0xff;
+    dest[1] = (value >> 8) & 0xff;
+    dest[2] = (value >> 16) & 0xff;
+    dest[3] = (value >> 24) & 0xff;
+}
+
+// NOTE(erick): PNG is big-endian.
+static void put_u32_be(uint8* dest, uint32 value) {
+    dest[0] = (value >> 24) & 0xff;
+    dest[1] = (value >> 16) & 0xff;
+    dest[2] = (value >> 8) & 0xff;
+    dest[3] = value & 0xff;
+}
+
+static uint32 pixels_per_meter(uint dpi) {
+    return (dpi * 10000 + 127) / 254;
+}
+
+static bool write_bmp_header(ImageWriter* writer) {
+    uint8 header[BMP_HEADER_SIZE] = {};
+    uint32 resolution = pixels_per_meter(writer->options.dpi);
+
+    header[0] = 'B';
+    header[1] = 'M';
+    put_u32(header + 2, BMP_HEADER_SIZE + writer->row_size * writer->height);
+    put_u32(header + 10, BMP_HEADER_SIZE);
+
+    put_u32(header + 14, 40);
+    put_u32(header + 18, writer->width);
+    // NOTE(erick): A negative height means the rows are stored top-down,
+    //  which is the order we produce them in.
+    put_u32(header + 22, (uint32) -writer->height);
+    put_u16(header + 26, 1);
+    put_u16(header + 28, 24);
+    put_u32(header + 34, writer->row_size * writer->height);
+    put_u32(header + 38, resolution);
+    put_u32(header + 42, resolution);
+
+    return fwrite(header, sizeof(header), 1, writer->file) == 1;
+}
+
+static bool write_png_chunk(ImageWriter* writer, char* type, uint8* data, usize size) {
+    uint8 length[4];
+    put_u32_be(length, size);
+
+    uint32 crc = crc32(0, (uint8*) type, 4);
+    if(size) { crc = crc32(crc, data, size); }
+
+    uint8 crc_bytes[4];
+    put_u32_be(crc_bytes, crc);
+
+    return fwrite(length, 4, 1, writer->file) == 1 &&
+        fwrite(type, 4, 1, writer->file) == 1 &&
+        (!size || fwrite(data, size, 1, writer->file) == 1) &&
+        fwrite(crc_bytes, 4, 1, writer->file) == 1;
+}
+
+static bool write_png_header(ImageWriter* writer) {
+    static uint8 signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    if(fwrite(signature, sizeof(signature), 1, writer->file) != 1) { return false; }
+
+    uint8 bit_depth = 8;
+    uint8 color_type = 2;
+    if(writer->options.format == IMAGE_PNG_PALETTE) {
+        bit_depth = 4;
+        color_type = 3;
+    } else if(writer->options.format == IMAGE_PNG_MONO) {
+        bit_depth = 1;
+        color_type = 0;
+    }
+
+    uint8 ihdr[13] = {};
+    put_u32_be(ihdr + 0, writer->width);
+    put_u32_be(ihdr + 4, writer->height);
+    ihdr[8] = bit_depth;
+    ihdr[9] = color_type;
+    if(!write_png_chunk(writer, "IHDR", ihdr, sizeof(ihdr))) { return false; }
+
+    uint8 phys[9] = {};
+    put_u32_be(phys + 0, pixels_per_meter(writer->options.dpi));
+    put_u32_be(phys + 4, pixels_per_meter(writer->options.dpi));
+    phys[8] = 1;
+    if(!write_png_chunk(writer, "pHYs", phys, sizeof(phys))) { return false; }
+
+    if(writer->options.format == IMAGE_PNG_PALETTE) {
+        return write_png_chunk(writer, "PLTE", writer->options.palette[0],
+                               writer->options.n_colors * 3);
+    }
+
+    return true;
+}
+
+bool begin_image(ImageWriter* writer, char* filename, int width, int height,
+                 ImageOptions* options) {
+    memset(writer, 0, sizeof(ImageWriter));
+    writer->options = *options;
+    writer->width = width;
+    writer->height = height;
+    writer->adler = 1;
+
+    ImageOptions* o = &writer->options;
+    if(o->n_threads < 1) { o->n_threads = 1; }
+    if(o->n_threads > IMAGE_MAX_THREADS) { o->n_threads = IMAGE_MAX_THREADS; }
+    if(o->format == IMAGE_PNG_PALETTE && (o->n_colors < 1 || o->n_colors > IMAGE_MAX_COLORS)) {
+        fprintf(stderr, "Palettes must have between 1 and %d colors.\n", IMAGE_MAX_COLORS);
+        return false;
+    }
+
+    switch(o->format) {
+    case IMAGE_BMP:         writer->row_size = (width * 3 + 3) & ~3; break;
+    case IMAGE_PNG_RGB:     writer->row_size = width * 3;            break;
+    case IMAGE_PNG_PALETTE: writer->row_size = (width + 1) / 2;      break;
+    case IMAGE_PNG_MONO:    writer->row_size = (width + 7) / 8;      break;
+    }
+
+    writer->row = (uint8*) calloc(writer->row_size, 1);
+    bool ok = writer->row != NULL;
+
+    if(ok && o->format != IMAGE_BMP) {
+        writer->previous_row = (uint8*) calloc(writer->row_size, 1);
+        writer->pending_capacity = PNG_WINDOW + o->n_threads * PNG_JOB_BYTES +
+            writer->row_size + 1;
+        writer->pending = (uint8*) malloc(writer->pending_capacity);
+        ok = writer->previous_row && writer->pending;
+    }
+
+    if(ok) {
+        writer->file = fopen(filename, "wb");
+        if(!writer->file) {
+            fprintf(stderr, "Could not open [%s] to write the image.\n", filename);
+            ok = false;
+        }
+    }
+
+    if(ok) {
+        ok = o->format == IMAGE_BMP ? write_bmp_header(writer) : write_png_header(writer);
+        if(!ok) { fprintf(stderr, "Failed writing the image header.\n"); }
+    }
+
+    if(!ok) {
+        if(writer->file) { fclose(writer->file); }
+        free(writer->row);
+        free(writer->previous_row);
+        free(writer->pending);
+        memset(writer, 0, sizeof(ImageWriter));
+    }
+
+    return ok;
+}
+
+typedef struct {
+    uint8* input;
+    usize input_size;
+    // NOTE(erick): The bytes right before the input, up to a window.
+    uint8* dictionary;
+    usize dictionary_size;
+    bool last;
+
+    // NOTE(erick): 2 bytes are left free before the compressed data and 4
+    //  after it for the zlib header and trailer.
+    uint8* output;
+    usize output_size;
+    uint32 adler;
+    bool ok;
+} CompressJob;
+
+static void* compress_job(void* arg) {
+    CompressJob* job = (CompressJob*) arg;
+    job->ok = false;
+    job->adler = adler32(adler32(0, NULL, 0), job->input, job->input_size);
+
+    z_stream stream = {};
+    if(deflateInit2(&stream, PNG_COMPRESSION_LEVEL, Z_DEFLATED, -15, 8,
+                    Z_DEFAULT_STRATEGY) != Z_OK) {
+        return NULL;
+    }
+
+    if(job->dictionary_size) {
+        deflateSetDictionary(&stream, job->dictionary, job->dictionary_size);
+    }
+
+    // NOTE(erick): deflateBound assumes Z_FINISH, a sync flush adds a few bytes.
+    usize capacity = deflateBound(&stream, job->input_size) + 16;
+    job->output = (uint8*) malloc(capacity + 6);
+    if(!job->output) {
+        deflateEnd(&stream);
+        return NULL;
+    }
+
+    stream.next_in = job->input;
+    stream.avail_in = job->input_size;
+    stream.next_out = job->output + 2;
+    stream.avail_out = capacity;
+
+    int status = deflate(&stream, job->last ? Z_FINISH : Z_SYNC_FLUSH);
+    job->ok = job->last ? status == Z_STREAM_END :
+        status == Z_OK && stream.avail_in == 0 && stream.avail_out > 0;
+    job->output_size = capacity - stream.avail_out;
+
+    deflateEnd(&stream);
+    return NULL;
+}
+
+// NOTE(erick): Compresses the pending rows and writes them as IDAT chunks.
+//  The last flush ends the zlib stream.
+static bool flush_png_data(ImageWriter* writer, bool last) {
+    uint8* data = writer->pending + writer->history_size;
+    usize size = writer->pending_size - writer->history_size;
+    if(!size && !last) { return true; }
+
+    uint n_threads = writer->options.n_threads;
+    usize job_bytes = (size + n_threads - 1) / n_threads;
+    if(job_bytes < PNG_JOB_BYTES) { job_bytes = PNG_JOB_BYTES; }
+
+    uint n_jobs = (size + job_bytes - 1) / job_bytes;
+    if(n_jobs < 1) { n_jobs = 1; }
+
+    CompressJob jobs[IMAGE_MAX_THREADS];
+    pthread_t threads[IMAGE_MAX_THREADS];
+    bool started[IMAGE_MAX_THREADS] = {};
+
+    for(uint i = 0; i < n_jobs; i++) {
+        CompressJob* job = jobs + i;
+        memset(job, 0, sizeof(CompressJob));
+
+        usize offset = i * job_bytes;
+        job->input = data + offset;
+        job->input_size = i == n_jobs - 1 ? size - offset : job_bytes;
+
+        usize before = job->input - writer->pending;
+        job->dictionary_size = before > PNG_WINDOW ? PNG_WINDOW : before;
+        job->dictionary = job->input - job->dictionary_size;
+        job->last = last && i == n_jobs - 1;
+    }
+
+    // NOTE(erick): The calling thread takes the first job, and any job whose
+    //  thread could not be started.
+    for(uint i = 1; i < n_jobs; i++) {
+        started[i] = pthread_create(threads + i, NULL, compress_job, jobs + i) == 0;
+    }
+
+    compress_job(jobs + 0);
+    for(uint i = 1; i < n_jobs; i++) {
+        if(started[i]) {
+            pthread_join(threads[i], NULL);
+        } else {
+            compress_job(jobs + i);
+        }
+    }
+
+    bool ok = true;
+    for(uint i = 0; i < n_jobs; i++) {
+        CompressJob* job = jobs + i;
+        ok = ok && job->ok;
+
+        if(ok) {
+            uint8* output = job->output + 2;
+            usize output_size = job->output_size;
+
+            if(!writer->began_stream) {
+                output -= 2;
+                output[0] = 0x78;
+                output[1] = 0x9c;
+                output_size += 2;
+                writer->began_stream = true;
+            }
+
+            writer->adler = adler32_combine(writer->adler, job->adler, job->input_size);
+            if(job->last) {
+                put_u32_be(output + output_size, writer->adler);
+                output_size += 4;
+            }
+
+            ok = write_png_chunk(writer, "IDAT", output, output_size);
+        }
+
+        free(job->output);
+    }
+
+    usize keep = writer->pending_size > PNG_WINDOW ? PNG_WINDOW : writer->pending_size;
+    memmove(writer->pending, writer->pending + writer->pending_size - keep, keep);
+    writer->pending_size = keep;
+    writer->history_size = keep;
+
+    return ok;
+}
+
+static uint8 nearest_color(ImageWriter* writer, uint8* pixel) {
+    uint best = 0;
+    int best_distance = 0x7fffffff;
+
+    for(uint i = 0; i < writer->options.n_colors; i++) {
+        uint8* color = writer->options.palette[i];
+        int dr = pixel[0] - color[0];
+        int dg = pixel[1] - color[1];
+        int db = pixel[2] - color[2];
+        int distance = dr * dr + dg * dg + db * db;
+
+        if(distance < best_distance) {
+            best = i;
+            best_distance = distance;
+        }
+    }
+
+    return (uint8) best;
+}
+
+// NOTE(erick): Converts one RGBA row to the file format, in writer->row.
+static void convert_row(ImageWriter* writer, uint8* src) {
+    uint8* row = writer->row;
+
+    switch(writer->options.format) {
+    case IMAGE_BMP:
+        for(int x = 0; x < writer->width; x++, src += 4) {
+            row[3 * x + 0] = src[2];
+            row[3 * x + 1] = src[1];
+            row[3 * x + 2] = src[0];
+        }
+        break;
+
+    case IMAGE_PNG_RGB:
+        for(int x = 0; x < writer->width; x++, src += 4) {
+            row[3 * x + 0] = src[0];
+            row[3 * x + 1] = src[1];
+            row[3 * x + 2] = src[2];
+        }
+        break;
+
+    case IMAGE_PNG_PALETTE: {
+        // NOTE(erick): Sheets are long runs of the same color.
+        uint32 last_pixel = 0;
+        uint8 last_index = nearest_color(writer, src);
+        memcpy(&last_pixel, src, 4);
+
+        memset(row, 0, writer->row_size);
+        for(int x = 0; x < writer->width; x++, src += 4) {
+            uint32 pixel;
+            memcpy(&pixel, src, 4);
+            if(pixel != last_pixel) {
+                last_pixel = pixel;
+                last_index = nearest_color(writer, src);
+            }
+
+            row[x / 2] |= x % 2 ? last_index : last_index << 4;
+        }
+    } break;
+
+    case IMAGE_PNG_MONO:
+        memset(row, 0, writer->row_size);
+        for(int x = 0; x < writer->width; x++, src += 4) {
+            bool ink = src[0] < 0x80 || src[1] < 0x80 || src[2] < 0x80;
+            if(!ink) { row[x / 8] |= 0x80 >> (x % 8); }
+        }
+        break;
+    }
+}
+
+bool write_image_rows(ImageWriter* writer, uint8* pixels, int pitch, int n_rows) {
+    if(!writer->file) { return false; }
+
+    if(writer->rows_written + n_rows > writer->height) {
+        fprintf(stderr, "Too many rows for the image.\n");
+        return false;
+    }
+
+    for(int y = 0; y < n_rows; y++) {
+        convert_row(writer, pixels + y * pitch);
+
+        if(writer->options.format == IMAGE_BMP) {
+            if(fwrite(writer->row, writer->row_size, 1, writer->file) != 1) {
+                fprintf(stderr, "Failed writing the image.\n");
+                return false;
+            }
+            continue;
+        }
+
+        // NOTE(erick): The Up filter turns the many repeated rows of a sheet
+        //  into zeros.
+        uint8* filtered = writer->pending + writer->pending_size;
+        filtered[0] = PNG_FILTER_UP;
+        for(usize i = 0; i < writer->row_size; i++) {
+            filtered[i + 1] = writer->row[i] - writer->previous_row[i];
+        }
+        writer->pending_size += writer->row_size + 1;
+
+        uint8* swap = writer->previous_row;
+        writer->previous_row = writer->row;
+        writer->row = swap;
+
+        if(writer->pending_size + writer->row_size + 1 > writer->pending_capacity) {
+            if(!flush_png_data(writer, false)) {
+                fprintf(stderr, "Failed writing the image.\n");
+                return false;
+            }
+        }
+    }
+
+    writer->rows_written += n_rows;
+    return true;
+}
+
+bool end_image(ImageWriter* writer) {
+    if(!writer->file) { return false; }
+
+    bool ok = writer->rows_written == writer->height;
+    if(!ok) {
+        fprintf(stderr, "The image is missing %d rows.\n",
+                writer->height - writer->rows_written);
+    }
+
+    if(ok && writer->options.format != IMAGE_BMP) {
+        ok = flush_png_data(writer, true) && write_png_chunk(writer, "IEND", NULL, 0);
+        if(!ok) { fprintf(stderr, "Failed writing the image.\n"); }
+    }
+
+    if(fclose(writer->file) != 0) { ok = false; }
+    free(writer->row);
+    free(writer->previous_row);
+    free(writer->pending);
+    memset(writer, 0, sizeof(ImageWriter));
+
+    return ok;
+}
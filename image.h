@@ -0,0 +1,72 @@
+#ifndef IMAGE_H
+#define IMAGE_H 1
+
+#include <stdio.h>
+
+#include "ICs.h"
+
+// NOTE(erick): Images are written a few rows at a time, top to bottom, so the
+//  whole image never has to be in memory. Rows come in as RGBA, one byte per
+//  channel (SoftCanvas pixels).
+
+typedef enum {
+    // NOTE(erick): 24 bits, stored top-down.
+    IMAGE_BMP,
+    // NOTE(erick): 8 bits per channel, no alpha.
+    IMAGE_PNG_RGB,
+    // NOTE(erick): Every pixel becomes the nearest palette color.
+    IMAGE_PNG_PALETTE,
+    // NOTE(erick): 1 bit per pixel. Anything darker than mid gray in some
+    //  channel is ink, so colored text survives.
+    IMAGE_PNG_MONO,
+} ImageFormat;
+
+#define IMAGE_MAX_COLORS 16
+#define IMAGE_MAX_THREADS 32
+
+typedef struct {
+    ImageFormat format;
+    uint dpi;
+
+    // NOTE(erick): Only for IMAGE_PNG_PALETTE. RGB.
+    uint8 palette[IMAGE_MAX_COLORS][3];
+    uint n_colors;
+
+    // NOTE(erick): How many threads compress PNG data.
+    uint n_threads;
+} ImageOptions;
+
+typedef struct {
+    ImageOptions options;
+    FILE* file;
+
+    int width;
+    int height;
+    int rows_written;
+
+    // NOTE(erick): One row in the format of the file.
+    uint8* row;
+    usize row_size;
+
+    // NOTE(erick): PNG only. Filtered rows waiting to be compressed, after
+    //  history_size bytes that were already compressed and are kept as the
+    //  dictionary of the next ones.
+    uint8* pending;
+    usize pending_size;
+    usize pending_capacity;
+    usize history_size;
+
+    // NOTE(erick): The previous row before filtering.
+    uint8* previous_row;
+    bool began_stream;
+    uint32 adler;
+} ImageWriter;
+
+bool parse_image_format(char*, ImageFormat*);
+const char* image_format_extension(ImageFormat);
+
+bool begin_image(ImageWriter*, char*, int, int, ImageOptions*);
+bool write_image_rows(ImageWriter*, uint8*, int, int);
+bool end_image(ImageWriter*);
+
+#endif
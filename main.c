@@ -0,0 +1,905 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+
+#include "bread_placer.h"
+#include "draw.h"
+#include "profiler.h"
+#include "replay.h"
+#include "pacing.h"
+#include "router.h"
+#include "placer.h"
+#include "compact.h"
+#include "group.h"
+#include "watcher.h"
+#include "render_thread.h"
+
+// TODO(erick): Viewport must focus on selection when zoomed in.
+
+#define PAN_INCREMENT 10
+
+//
+// Globals
+//
+static const char* prj_extension = ".icprj";
+static const char* ics_extension = ".ics_list";
+
+static uint dec_mod(uint value, uint mod) {
+    if(value == 0) { return mod - 1; }
+
+    return value - 1;
+}
+
+static uint inc_mod(uint value, uint mod) {
+    if(value + 1 == mod) { return 0; }
+
+    return value + 1;
+}
+
+static IC* picked_outside_ic(DrawData* dd, ICList ic_list) {
+    if(dd->outside_ic_selected >= dd->n_outside_matches) { return NULL; }
+
+    return ic_list.data + dd->outside_matches[dd->outside_ic_selected];
+}
+
+static void refresh_outside_matches(DrawData* dd, ICList ic_list) {
+    dd->n_outside_matches = search_outside_ics(&dd->outside_index, dd->outside_query,
+                                               dd->outside_matches);
+    dd->outside_ic_selected = 0;
+
+    IC* ic = picked_outside_ic(dd, ic_list);
+    if(ic) {
+        suggest_slots(ic_list, ic, &dd->slot_suggestions);
+    } else {
+        dd->slot_suggestions.count = 0;
+    }
+}
+
+// NOTE(erick): Merges a reload of the ics_list file into the list. The file
+//  was already read and parsed by the watcher thread. With as many ICs as
+//  before the list is changed in place and only what depends on the ICs that
+//  changed is updated. Otherwise everything that points into the list is
+//  built again. Returns whether the reload was applied.
+static bool reload_ic_list(IcsListReload* reload, ICList* ic_list, DrawData* dd,
+                           Selection* selection, DrcState* drc, NetList* net_list,
+                           NetHighlight* net_highlight) {
+    if(ic_list->count != reload->n_old) {
+        fprintf(stderr, "The ics_list file could not be reloaded."
+                " Restart to load it.\n");
+        return false;
+    }
+
+    bool in_place = reload->n_new == reload->n_old;
+    usize first_changed = reload->n_same_before;
+    usize n_changed = reload->n_new - reload->n_same_before - reload->n_same_after;
+    usize n_old_changed = reload->n_old - reload->n_same_before - reload->n_same_after;
+
+    if(in_place) {
+        for(usize ic_index = first_changed; ic_index < first_changed + n_old_changed; ic_index++) {
+            forget_drc_ic(drc, ic_list->data + ic_index);
+        }
+    } else {
+        // NOTE(erick): When the list moves, the journal and the selection point
+        //  into the old one.
+        clear_placement_journal(ic_list->journal);
+    }
+
+    usize selected_index = selection->state == SELECTING ?
+        (usize) (selection->selected_ic - ic_list->data) : 0;
+    ICGroup* group = &selection->group;
+    usize* group_indices = (usize*) malloc((group->count + 1) * sizeof(usize));
+    for(usize i = 0; i < group->count; i++) {
+        group_indices[i] = group->ics[i] - ic_list->data;
+    }
+
+    uint32* new_index = (uint32*) malloc((reload->n_old + 1) * sizeof(uint32));
+    apply_ics_list_reload(ic_list, reload, new_index);
+
+    if(in_place) {
+        // NOTE(erick): Brings the pins back to the DRC.
+        for(usize ic_index = first_changed; ic_index < first_changed + n_changed; ic_index++) {
+            record_placement_change(*ic_list, ic_list->data + ic_index);
+        }
+
+        update_net_list(net_list, *ic_list, first_changed, n_changed);
+        update_search_index(&dd->outside_index, *ic_list, first_changed, n_changed);
+    } else {
+        free_drc(drc);
+        init_drc(drc, *ic_list);
+
+        free_net_list(net_list);
+        *net_list = build_net_list(*ic_list);
+
+        free_search_index(&dd->outside_index);
+        build_search_index(&dd->outside_index, *ic_list);
+        dd->outside_matches = (uint32*) realloc(dd->outside_matches,
+                                                (ic_list->count + 1) * sizeof(uint32));
+    }
+    *net_highlight = (NetHighlight) {};
+
+    // NOTE(erick): ICs whose number of pins changed are outside now.
+    if(selection->state == SELECTING) {
+        uint32 index = new_index[selected_index];
+        if(index == RELOAD_DROPPED || ic_list->data[index].location.column == 0) {
+            selection->state = HOVERING;
+            selection->selected_ic = NULL;
+        } else {
+            selection->selected_ic = ic_list->data + index;
+            if(reload_changes_old_ic(reload, selected_index)) { selection->highlighted_pin = 0; }
+        }
+    }
+
+    usize group_count = 0;
+    for(usize i = 0; i < group->count; i++) {
+        uint32 index = new_index[group_indices[i]];
+        if(index == RELOAD_DROPPED || ic_list->data[index].location.column == 0) { continue; }
+
+        group->ics[group_count++] = ic_list->data + index;
+    }
+    group->count = group_count;
+
+    free(new_index);
+    free(group_indices);
+
+    if(dd->is_selecting_outside_ic) {
+        refresh_outside_matches(dd, *ic_list);
+    } else {
+        dd->slot_suggestions.count = 0;
+    }
+
+    usize n_replaced = n_changed < n_old_changed ? n_changed : n_old_changed;
+    printf("Reloaded the ics_list: %zu ICs changed, %zu added, %zu dropped.\n",
+           n_replaced, n_changed - n_replaced, n_old_changed - n_replaced);
+    return true;
+}
+
+// NOTE(erick): Brings what depends on the placement up to date and hands the
+//  frame to the renderer.
+static void publish_frame(RenderThread* render, DrawData* dd, ICList ic_list,
+                          Selection* selection, DrcState* drc, NetList* net_list,
+                          NetHighlight* net_highlight) {
+    update_drc(drc, ic_list.journal);
+    if(ic_list.journal->count) { net_highlight->valid = false; }
+    clear_placement_journal(ic_list.journal);
+
+    IC* highlighted_ic = selection->state == SELECTING && selection->highlighted_pin ?
+        selection->selected_ic : NULL;
+    update_net_highlight(net_highlight, net_list, highlighted_ic,
+                         selection->highlighted_pin - 1);
+
+    publish_snapshot(render, dd, ic_list, selection, drc, net_highlight);
+}
+
+static bool is_query_key(SDL_Keycode key) {
+    return (key >= SDLK_a && key <= SDLK_z) || (key >= SDLK_0 && key <= SDLK_9) ||
+        key == SDLK_PERIOD || key == SDLK_MINUS || key == SDLK_SLASH;
+}
+
+// NOTE(erick): Typing into the picker repeats like text does, with the OS key
+//  repeat. The fixed step repeat would pan or zoom with some of these keys.
+static bool is_typing_in_picker(DrawData* dd, SDL_Keycode key) {
+    return dd->is_selecting_outside_ic && (is_query_key(key) || key == SDLK_BACKSPACE);
+}
+
+// NOTE(erick): While the outside IC picker is open, typing goes to its query.
+//  Returns whether the key was taken.
+static bool handle_picker_key(SDL_Keycode key, DrawData* dd, ICList ic_list) {
+    usize length = strlen(dd->outside_query);
+
+    if(is_query_key(key)) {
+        if(length + 1 < SEARCH_MAX_QUERY) {
+            dd->outside_query[length] = (char) key;
+            dd->outside_query[length + 1] = '\0';
+            refresh_outside_matches(dd, ic_list);
+        }
+        return true;
+    }
+
+    switch(key) {
+    case SDLK_BACKSPACE:
+        if(length) {
+            dd->outside_query[length - 1] = '\0';
+            refresh_outside_matches(dd, ic_list);
+        }
+        return true;
+    case SDLK_ESCAPE:
+        dd->is_selecting_outside_ic = false;
+        dd->slot_suggestions.count = 0;
+        return true;
+    }
+
+    return false;
+}
+
+
+// NOTE(erick): Every edit goes through here, both for live input and for
+//  replayed recordings.
+static void handle_key_down(SDL_Keycode key, DrawData* dd, ICList ic_list,
+                            Selection* selection, bool* is_running) {
+    if(dd->is_selecting_outside_ic && handle_picker_key(key, dd, ic_list)) { return; }
+
+    switch (key) {
+    case SDLK_ESCAPE: // Fall-through
+    case SDLK_q:
+        *is_running = false;
+        break;
+    case SDLK_z:
+        // NOTE(erick): Toggles between the whole sheet and 1:1.
+        set_zoom(dd, dd->zoom < 1.0f ? 1.0f : fit_zoom(dd));
+        break;
+    case SDLK_EQUALS: // Fall-through
+    case SDLK_PLUS:
+    case SDLK_KP_PLUS:
+        set_zoom(dd, dd->zoom * ZOOM_STEP);
+        break;
+    case SDLK_MINUS: // Fall-through
+    case SDLK_KP_MINUS:
+        set_zoom(dd, dd->zoom / ZOOM_STEP);
+        break;
+    case SDLK_p:
+        dd->display_debug_info = !dd->display_debug_info;
+        break;
+    case SDLK_w:
+        pan_view(dd, 0, -1 * PAN_INCREMENT);
+        break;
+    case SDLK_s:
+        pan_view(dd, 0, 1 * PAN_INCREMENT);
+        break;
+    case SDLK_a:
+        pan_view(dd, -1 * PAN_INCREMENT, 0);
+        break;
+    case SDLK_d:
+        pan_view(dd, 1 * PAN_INCREMENT, 0);
+        break;
+    case SDLK_LEFT:
+        if(!dd->is_selecting_outside_ic) {
+            move_selection(ic_list, selection, -1, 0);
+        }
+        break;
+    case SDLK_RIGHT:
+        if(!dd->is_selecting_outside_ic) {
+            move_selection(ic_list, selection, 1, 0);
+        }
+        break;
+    case SDLK_UP:
+        if(!dd->is_selecting_outside_ic) {
+            move_selection(ic_list, selection, 0, -1);
+        } else if(dd->n_outside_matches) {
+            dd->outside_ic_selected = dec_mod(dd->outside_ic_selected,
+                                              dd->n_outside_matches);
+            suggest_slots(ic_list, picked_outside_ic(dd, ic_list), &dd->slot_suggestions);
+        }
+        break;
+    case SDLK_DOWN:
+        if(!dd->is_selecting_outside_ic) {
+            move_selection(ic_list, selection, 0, 1);
+        } else if(dd->n_outside_matches) {
+            dd->outside_ic_selected = inc_mod(dd->outside_ic_selected,
+                                              dd->n_outside_matches);
+            suggest_slots(ic_list, picked_outside_ic(dd, ic_list), &dd->slot_suggestions);
+        }
+        break;
+    case SDLK_r:
+        if(selection->state == SELECTING) {
+            if(group_contains(&selection->group, selection->selected_ic)) {
+                rotate_group(ic_list, selection);
+            } else {
+                rotate_ic(ic_list, selection->selected_ic);
+            }
+        }
+        break;
+    case SDLK_BACKSPACE: // Fall-through
+    case SDLK_DELETE:
+        if(selection->state == SELECTING) {
+            if(group_contains(&selection->group, selection->selected_ic)) {
+                put_group_outside(ic_list, &selection->group);
+            } else {
+                put_ic_outside(ic_list, selection->selected_ic);
+            }
+            selection->state = HOVERING;
+        }
+        break;
+    case SDLK_g:
+        if(!dd->is_selecting_outside_ic) {
+            toggle_group_member(ic_list, selection);
+        }
+        break;
+    case SDLK_v:
+        // NOTE(erick): The first press drops the anchor, the second one adds
+        //  the ICs in the rectangle up to the selection.
+        if(!dd->is_selecting_outside_ic) {
+            if(selection->has_anchor) {
+                add_rect_to_group(ic_list, selection);
+            } else {
+                selection->has_anchor = true;
+                selection->anchor_row = selection->row;
+                selection->anchor_column = selection->column;
+            }
+        }
+        break;
+    case SDLK_x:
+        if(!dd->is_selecting_outside_ic) {
+            clear_group(&selection->group);
+            selection->has_anchor = false;
+        }
+        break;
+    case SDLK_e:
+        // NOTE(erick): Copies the group to the nearest column it fits in.
+        if(!dd->is_selecting_outside_ic && selection->group.count) {
+            int32 d_columns[] = {1, -1, 2, -2};
+            bool success = false;
+            for(uint i = 0; i < 4 && !success; i++) {
+                success = copy_group(ic_list, &selection->group, d_columns[i]);
+            }
+
+            if(!success) {
+                printf("The group could not be copied to another column.\n");
+            }
+        }
+        break;
+    case SDLK_i:
+        if(count_outside_ics(ic_list)) {
+            dd->is_selecting_outside_ic = true;
+            dd->outside_query[0] = '\0';
+            refresh_outside_matches(dd, ic_list);
+        }
+        break;
+    case SDLK_TAB:
+        if(dd->is_selecting_outside_ic && dd->slot_suggestions.count) {
+            SlotSuggestions* suggestions = &dd->slot_suggestions;
+            suggestions->current = inc_mod(suggestions->current, suggestions->count);
+        }
+        break;
+    case SDLK_n:
+        // NOTE(erick): Goes through the pins of the selected IC, skipping the
+        //  N.C. ones, and then back to no highlight.
+        if(selection->state == SELECTING) {
+            IC* ic = selection->selected_ic;
+            do {
+                selection->highlighted_pin = inc_mod(selection->highlighted_pin,
+                                                     ic->n_pins + 1);
+            } while(selection->highlighted_pin &&
+                    ic->pins[selection->highlighted_pin - 1].type == NOT_CONNECTED);
+        }
+        break;
+    case SDLK_c:
+        if(!dd->is_selecting_outside_ic) {
+            // NOTE(erick): The selection follows the selected IC.
+            IC* selected_ic = selection->state == SELECTING ? selection->selected_ic : NULL;
+            BreadboardLocation old_location = selected_ic ? selected_ic->location :
+                (BreadboardLocation) {};
+
+            Compaction compaction = compact_board(ic_list);
+            print_compaction_report(stdout, &compaction);
+
+            if(selected_ic) {
+                selection->column = selected_ic->location.column;
+                selection->row += (int) selected_ic->location.row - (int) old_location.row;
+            }
+        }
+        break;
+    case SDLK_INSERT:
+        // NOTE(erick): The IC goes to the suggested slot being shown (Tab
+        //  goes through them) and the selection follows it.
+        if(dd->is_selecting_outside_ic) {
+            IC* ic = picked_outside_ic(dd, ic_list);
+            if(place_suggested_ic(ic_list, &dd->slot_suggestions)) {
+                dd->is_selecting_outside_ic = false;
+                dd->slot_suggestions.count = 0;
+
+                selection->column = ic->location.column;
+                selection->row = ic->location.row;
+                try_to_select_ic(ic_list, selection);
+            }
+        }
+        break;
+    case SDLK_SPACE: // Fall-through
+    case SDLK_RETURN:
+        if(dd->is_selecting_outside_ic) {
+            dd->is_selecting_outside_ic = false;
+
+            IC* ic = picked_outside_ic(dd, ic_list);
+            bool success = ic && move_ic_in(ic_list, ic, selection->row, selection->column);
+            dd->slot_suggestions.count = 0;
+
+            if(success) {
+                try_to_select_ic(ic_list, selection);
+            }
+
+        } else {
+            if(selection->state == HOVERING) {
+                try_to_select_ic(ic_list, selection);
+            } else {
+                selection->state = HOVERING;
+                selection->selected_ic = NULL;
+            }
+        }
+
+        break;
+    default:
+        printf("Key pressed: %d\n", key);
+    }
+}
+
+static void apply_key_event(KeyRepeat* key_repeat, uint32 time_ms, bool pressed,
+                            SDL_Keycode key, DrawData* dd, ICList ic_list,
+                            Selection* selection, bool* is_running) {
+    if(pressed) {
+        bool is_typing = is_typing_in_picker(dd, key);
+        handle_key_down(key, dd, ic_list, selection, is_running);
+        if(!is_typing) { press_key(key_repeat, key, time_ms); }
+    } else {
+        release_key(key_repeat, key);
+    }
+}
+
+// NOTE(erick): Returns whether anything changed.
+static bool apply_repeat_result(RepeatResult* repeated, DrawData* dd, ICList ic_list,
+                                Selection* selection, bool* is_running) {
+    for(uint i = 0; i < repeated->n_repeated_keys; i++) {
+        handle_key_down(repeated->repeated_keys[i], dd, ic_list, selection, is_running);
+    }
+
+    if(repeated->pan_dx || repeated->pan_dy) {
+        pan_view(dd, repeated->pan_dx, repeated->pan_dy);
+    }
+
+    return repeated->n_repeated_keys || repeated->pan_dx || repeated->pan_dy;
+}
+
+static void print_usage(char* program_name) {
+    fprintf(stderr, "Usage: %s [options] (ics__list_file | prj_file)\n", program_name);
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "\t--trace <file.json>       Write a Chrome trace of the frame timings\n");
+    fprintf(stderr, "\t--record <file>           Record the key events of this session\n");
+    fprintf(stderr, "\t--replay <file>           Replay a recording instead of reading the keyboard\n");
+    fprintf(stderr, "\t--fast                    Replay events one per frame, ignoring their times\n");
+    fprintf(stderr, "\t--headless                Replay without a window (needs --replay)\n");
+    fprintf(stderr, "\t--frame-times <file.csv>  Write every frame time of a replay\n");
+    fprintf(stderr, "\t--frame-policy <policy>   on-demand (default), capped or continuous\n");
+    fprintf(stderr, "\t--dpi <dpi>               Resolution of the saved image (default %d)\n",
+            DEFAULT_DPI);
+    fprintf(stderr, "\t--image <format>          bmp (default), png, png-palette or png-mono\n");
+    fprintf(stderr, "\t--pdf                     Save the sheet as a vector PDF instead\n");
+    fprintf(stderr, "\t--place-exact <seconds>   Find the placement with the least wire length, save it and exit\n");
+    fprintf(stderr, "\t--compact                 Pack the ICs, bring outside ones in, save and exit\n");
+    fprintf(stderr, "\t--check                   Print the design rule violations and exit\n");
+    fprintf(stderr, "\t--route                   Print the jumper cut list and assembly order and exit\n");
+}
+
+int main(int args_count, char** args_values) {
+    char* input_filename = NULL;
+    char* trace_filename = NULL;
+    char* record_filename = NULL;
+    char* replay_filename = NULL;
+    char* frame_times_filename = NULL;
+    bool replay_fast = false;
+    bool headless = false;
+    FramePolicy frame_policy = FRAME_POLICY_ON_DEMAND;
+    uint print_dpi = DEFAULT_DPI;
+    ImageFormat image_format = IMAGE_BMP;
+    bool save_as_pdf = false;
+    bool only_check = false;
+    bool only_route = false;
+    double exact_seconds = 0.0;
+    bool only_compact = false;
+
+    for(int arg_index = 1; arg_index < args_count; arg_index++) {
+        char* arg = args_values[arg_index];
+        bool has_value = arg_index + 1 < args_count;
+
+        if(strcmp(arg, "--trace") == 0 && has_value) {
+            trace_filename = args_values[++arg_index];
+        } else if(strcmp(arg, "--record") == 0 && has_value) {
+            record_filename = args_values[++arg_index];
+        } else if(strcmp(arg, "--replay") == 0 && has_value) {
+            replay_filename = args_values[++arg_index];
+        } else if(strcmp(arg, "--frame-times") == 0 && has_value) {
+            frame_times_filename = args_values[++arg_index];
+        } else if(strcmp(arg, "--frame-policy") == 0 && has_value) {
+            if(!parse_frame_policy(args_values[++arg_index], &frame_policy)) {
+                print_usage(args_values[0]);
+                exit(1);
+            }
+        } else if(strcmp(arg, "--dpi") == 0 && has_value) {
+            int dpi = atoi(args_values[++arg_index]);
+            if(dpi < 72 || dpi > 2400) {
+                fprintf(stderr, "The DPI must be between 72 and 2400.\n");
+                exit(1);
+            }
+            print_dpi = dpi;
+        } else if(strcmp(arg, "--image") == 0 && has_value) {
+            if(!parse_image_format(args_values[++arg_index], &image_format)) {
+                print_usage(args_values[0]);
+                exit(1);
+            }
+        } else if(strcmp(arg, "--pdf") == 0) {
+            save_as_pdf = true;
+        } else if(strcmp(arg, "--place-exact") == 0 && has_value) {
+            exact_seconds = atof(args_values[++arg_index]);
+            if(exact_seconds <= 0.0) {
+                fprintf(stderr, "The time limit must be positive.\n");
+                exit(1);
+            }
+        } else if(strcmp(arg, "--compact") == 0) {
+            only_compact = true;
+        } else if(strcmp(arg, "--check") == 0) {
+            only_check = true;
+        } else if(strcmp(arg, "--route") == 0) {
+            only_route = true;
+        } else if(strcmp(arg, "--fast") == 0) {
+            replay_fast = true;
+        } else if(strcmp(arg, "--headless") == 0) {
+            headless = true;
+        } else if(!string_begins_with(arg, "--") && !input_filename) {
+            input_filename = arg;
+        } else {
+            print_usage(args_values[0]);
+            exit(1);
+        }
+    }
+
+    if(!input_filename || (headless && !replay_filename) ||
+       (record_filename && replay_filename)) {
+        print_usage(args_values[0]);
+        exit(1);
+    }
+
+    char* project_name;
+    char* ics_list_filename;
+    char* project_filename;
+    char* image_filename;
+
+    char* input_extension = extension(input_filename);
+    usize input_extension_len = strlen(input_extension);
+
+    bool should_read_prj_file;
+
+    if(input_extension == input_filename) {
+        fprintf(stderr, "The input file must have an extension\n");
+        exit(2);
+    }
+
+    project_name = str_n_alloc_cpy(input_filename,
+                                   strlen(input_filename) -
+                                   input_extension_len);
+    usize project_name_len = strlen(project_name);
+
+    // NOTE(erick): A project file was passed.
+    if(strcmp(input_extension, prj_extension) == 0) {
+        project_filename = input_filename;
+        should_read_prj_file = true;
+
+        usize ics_extension_len = strlen(ics_extension);
+        ics_list_filename = (char*) malloc(project_name_len +
+                                           ics_extension_len + 1);
+
+        strcpy(ics_list_filename, project_name);
+        strcat(ics_list_filename, ics_extension);
+
+    // NOTE(erick): A ics_list file was passed.
+    } else if(strcmp(input_extension, ics_extension) == 0) {
+        ics_list_filename = input_filename;
+        should_read_prj_file = false;
+
+        usize prj_extension_len = strlen(prj_extension);
+        project_filename = (char*) malloc(prj_extension_len +
+                                                project_name_len + 1);
+
+        strcpy(project_filename, project_name);
+        strcat(project_filename, prj_extension);
+    } else {
+        fprintf(stderr, "You must pass either a project file or a ics_list file\n");
+        exit(2);
+    }
+
+    const char* image_extension = save_as_pdf ? ".pdf" : image_format_extension(image_format);
+    image_filename = (char*) malloc(strlen(project_name) + strlen(image_extension) + 1);
+    sprintf(image_filename, "%s%s", project_name, image_extension);
+
+    FILE* ics_list_file = fopen(ics_list_filename, "r");
+    if(!ics_list_file) {
+        fprintf(stderr, "Could not open ics_list file [%s] to read the ics data.\n",
+                ics_list_filename);
+        exit(3);
+    }
+
+    // NOTE(erick): Without its files the editor has nothing to do, so any error
+    //  reading or writing them ends it.
+    ProjectContext context = new_project_context(stderr);
+
+    ICList ic_list;
+    int error = read_ic_list_file(&context, ics_list_file, &ic_list);
+    fclose(ics_list_file);
+    if(error) { exit(error); }
+
+    if(should_read_prj_file) {
+        error = read_project_file(&context, project_filename, &ic_list);
+        if(error) { exit(error); }
+    }
+
+    if(only_compact) {
+        Compaction compaction = compact_board(ic_list);
+        print_compaction_report(stdout, &compaction);
+        if(save_project_file(&context, project_filename, &ic_list)) { exit(4); }
+
+        if(!exact_seconds && !only_route && !only_check) { return 0; }
+        printf("\n");
+    }
+
+    if(exact_seconds > 0.0) {
+        ExactPlacement placement;
+        if(!place_exact(&context, ic_list, exact_seconds, &placement)) { exit(1); }
+
+        print_exact_placement_report(stdout, &placement);
+        if(save_project_file(&context, project_filename, &ic_list)) { exit(4); }
+
+        if(!only_route && !only_check) { return 0; }
+        printf("\n");
+    }
+
+    if(only_route) {
+        JumperList jumpers = route_jumpers(ic_list);
+        print_cut_list(stdout, &jumpers);
+        printf("\n");
+        print_assembly_order(stdout, &jumpers);
+        free_jumpers(&jumpers);
+
+        if(!only_check) { return 0; }
+        printf("\n");
+    }
+
+    DrcState drc;
+    init_drc(&drc, ic_list);
+
+    // NOTE(erick): The exit code tells scripts whether the placement is clean.
+    if(only_check) {
+        print_drc_report(stdout, &drc);
+        return drc.n_violations ? 1 : 0;
+    }
+
+    PlacementJournal placement_journal = {};
+    ic_list.journal = &placement_journal;
+
+    bool replaying = replay_filename != NULL;
+    InputRecording recording = {};
+    if(replaying && !load_recording(replay_filename, &recording)) {
+        exit(1);
+    }
+
+    FILE* recording_file = NULL;
+    if(record_filename) {
+        recording_file = open_recording(record_filename);
+        if(!recording_file) {
+            fprintf(stderr, "Could not open recording file [%s].\n", record_filename);
+            exit(1);
+        }
+    }
+
+    // NOTE(erick): Replays draw on the main thread, one frame per loop, so the
+    //  frame times they report are what the frames cost. Otherwise the window
+    //  is drawn by the render thread, which makes its own renderer.
+    Selection selection = {.row = 1, .column = 1};
+    DrawData dd;
+    if(headless) {
+        dd = init_headless_SDL(1920, 1080);
+    } else {
+        dd = replaying ? init_SDL() : init_SDL_window();
+    }
+    build_search_index(&dd.outside_index, ic_list);
+
+    NetList net_list = build_net_list(ic_list);
+    NetHighlight net_highlight = {};
+    dd.outside_matches = (uint32*) malloc((ic_list.count + 1) * sizeof(uint32));
+    bool is_running = true;
+
+    init_profiler();
+    if(trace_filename && !open_profile_trace(trace_filename)) {
+        fprintf(stderr, "Could not open trace file [%s]. Tracing is disabled.\n",
+                trace_filename);
+    }
+
+    int refresh_rate = 60;
+    SDL_DisplayMode display_mode;
+    if(!headless && SDL_GetCurrentDisplayMode(0, &display_mode) == 0) {
+        refresh_rate = display_mode.refresh_rate;
+    }
+
+    // NOTE(erick): A replay must not depend on the file changing under it.
+    IcsListWatcher watcher;
+    bool is_watching = !replaying && start_ics_list_watcher(&watcher, ics_list_filename);
+    if(!replaying && !is_watching) {
+        fprintf(stderr, "Could not watch [%s]. It will not be reloaded when it changes.\n",
+                ics_list_filename);
+    }
+
+    FramePacer pacer = init_frame_pacer(frame_policy, refresh_rate);
+
+    RenderThread render;
+    init_render_thread(&render, &dd, pacer);
+    if(!replaying && !start_render_thread(&render)) {
+        fprintf(stderr, "Could not start the render thread. Drawing on the main thread.\n");
+        init_SDL_renderer(&render.dd);
+    }
+
+    // NOTE(erick): With a render thread this loop only waits for input. The
+    //  frame policy is up to the render thread.
+    bool draws_here = !render.is_threaded;
+    KeyRepeat key_repeat = {};
+    bool needs_redraw = true;
+
+    FrameTimes frame_times = {};
+    uint64 frame_count = 0;
+    uint32 loop_start_ticks = SDL_GetTicks();
+    uint64 loop_start_counter = SDL_GetPerformanceCounter();
+
+    // NOTE(erick): Time, in milliseconds since the loop started, that drives the
+    //  fixed step updates. A fast replay uses the recorded times instead of the
+    //  wall clock so it stays deterministic.
+    uint32 clock_ms = 0;
+
+    while(is_running) {
+        bool waits_for_input = frame_policy == FRAME_POLICY_ON_DEMAND || !draws_here;
+        if(waits_for_input && !needs_redraw && !replay_fast) {
+            uint32 now_ms = SDL_GetTicks() - loop_start_ticks;
+            int32 timeout = -1;
+
+            if(has_held_keys(&key_repeat)) {
+                int32 until_update = (int32) (next_update_ms(&key_repeat) - now_ms);
+                timeout = until_update > 0 ? until_update : 0;
+            }
+
+            uint32 event_ms;
+            if(replaying && next_event_time(&recording, &event_ms)) {
+                int32 until_event = event_ms > now_ms ? (int32) (event_ms - now_ms) : 0;
+                if(timeout < 0 || until_event < timeout) { timeout = until_event; }
+            }
+
+            // NOTE(erick): Passing NULL leaves the event in the queue for the
+            //  loop below.
+            if(timeout < 0) {
+                SDL_WaitEvent(NULL);
+            } else if(timeout > 0) {
+                SDL_WaitEventTimeout(NULL, timeout);
+            }
+        }
+
+        if(!replay_fast) {
+            clock_ms = SDL_GetTicks() - loop_start_ticks;
+        }
+
+        SDL_Event e;
+        while(SDL_PollEvent(&e)) {
+            if(e.type == SDL_QUIT) {
+                is_running = false;
+
+            } else if(e.type == SDL_WINDOWEVENT) {
+                needs_redraw = true;
+
+            } else if(is_watching && e.type == watcher.event_type) {
+                // NOTE(erick): The reload frees strings and pins the render
+                //  thread is drawing. It gets a snapshot without them before
+                //  going on.
+                IcsListReload* reload = (IcsListReload*) e.user.data1;
+                pause_render_thread(&render);
+                bool applied = reload_ic_list(reload, &ic_list, &dd, &selection, &drc,
+                                              &net_list, &net_highlight);
+                finish_ics_list_reload(&watcher, reload, applied);
+                publish_frame(&render, &dd, ic_list, &selection, &drc, &net_list,
+                              &net_highlight);
+                resume_render_thread(&render);
+
+                free_ics_list_reload(reload);
+                free(reload);
+                needs_redraw = true;
+
+            } else if(e.type == SDL_KEYDOWN || e.type == SDL_KEYUP) {
+                bool pressed = e.type == SDL_KEYDOWN;
+
+                // NOTE(erick): While replaying, the recording is the only input.
+                //  Escape still aborts the replay.
+                if(replaying) {
+                    if(pressed && e.key.keysym.sym == SDLK_ESCAPE) { is_running = false; }
+                    continue;
+                }
+
+                // NOTE(erick): Held keys are repeated by the fixed step update,
+                //  the OS key repeat is ignored, except for typing.
+                if(e.key.repeat && !(pressed && is_typing_in_picker(&dd, e.key.keysym.sym))) {
+                    continue;
+                }
+
+                uint32 event_ms = e.key.timestamp - loop_start_ticks;
+                record_key_event(recording_file, event_ms, pressed,
+                                 e.key.keysym.sym, e.key.keysym.mod);
+
+                RepeatResult repeated = step_key_repeat(&key_repeat, event_ms);
+                apply_repeat_result(&repeated, &dd, ic_list, &selection, &is_running);
+
+                apply_key_event(&key_repeat, event_ms, pressed, e.key.keysym.sym,
+                                &dd, ic_list, &selection, &is_running);
+                needs_redraw = true;
+            }
+        }
+
+        if(replaying) {
+            // NOTE(erick): When replaying as fast as possible we take one event
+            //  per frame so every edit gets its own frame.
+            uint32 now_ms = replay_fast ? UINT32_MAX : clock_ms;
+
+            RecordedEvent* recorded;
+            while((recorded = next_due_event(&recording, now_ms))) {
+                if(replay_fast) { clock_ms = recorded->time_ms; }
+
+                RepeatResult repeated = step_key_repeat(&key_repeat, recorded->time_ms);
+                apply_repeat_result(&repeated, &dd, ic_list, &selection, &is_running);
+
+                apply_key_event(&key_repeat, recorded->time_ms, recorded->pressed,
+                                recorded->key, &dd, ic_list, &selection, &is_running);
+                needs_redraw = true;
+
+                if(replay_fast) { break; }
+            }
+
+            if(replay_finished(&recording)) { is_running = false; }
+        }
+
+        RepeatResult repeated = step_key_repeat(&key_repeat, clock_ms);
+        if(apply_repeat_result(&repeated, &dd, ic_list, &selection, &is_running)) {
+            needs_redraw = true;
+        }
+
+        if(waits_for_input && !needs_redraw) { continue; }
+        needs_redraw = false;
+
+        publish_frame(&render, &dd, ic_list, &selection, &drc, &net_list, &net_highlight);
+        if(!draws_here) { continue; }
+
+        render_latest_snapshot(&render);
+
+        if(frame_count++) {
+            add_frame_time(&frame_times, profile_frame_ms());
+        }
+
+        if(!replay_fast) {
+            wait_for_next_frame(&pacer);
+        }
+    }
+
+    // NOTE(erick): The render thread writes to the trace too, so it stops
+    //  first. It leaves "Saving..." on the screen.
+    if(!replaying) { stop_render_thread(&render); }
+    if(is_watching) { stop_ics_list_watcher(&watcher); }
+
+    close_profile_trace();
+    close_recording(recording_file);
+
+    // NOTE(erick): A replay is a measurement, it must not overwrite the project.
+    if(replaying) {
+        profile_frame_boundary();
+        add_frame_time(&frame_times, profile_frame_ms());
+
+        double total_seconds = (double) (SDL_GetPerformanceCounter() - loop_start_counter) /
+            (double) SDL_GetPerformanceFrequency();
+        print_replay_report(stdout, &frame_times, total_seconds);
+
+        if(frame_times_filename && !write_frame_times(frame_times_filename, &frame_times)) {
+            fprintf(stderr, "Could not write frame times to [%s].\n",
+                    frame_times_filename);
+        }
+
+        return 0;
+    }
+
+    if(save_as_pdf) {
+        save_pdf(&render.dd, ic_list, image_filename);
+    } else {
+        save_image(&render.dd, ic_list, image_filename, print_dpi, image_format);
+    }
+    if(save_project_file(&context, project_filename, &ic_list)) { exit(4); }
+
+    return 0;
+}
@@ -0,0 +1,225 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "nets.h"
+
+static int compare_net_pins(const void* a, const void* b) {
+    NetPin* pin_a = (NetPin*) a;
+    NetPin* pin_b = (NetPin*) b;
+
+    int result = strcmp(pin_a->ic->pins[pin_a->pin_index].label,
+                        pin_b->ic->pins[pin_b->pin_index].label);
+    if(result) { return result; }
+
+    if(pin_a->ic != pin_b->ic) { return pin_a->ic < pin_b->ic ? -1 : 1; }
+    return (int) pin_a->pin_index - (int) pin_b->pin_index;
+}
+
+static char* label_of(NetPin* pin) {
+    return pin->ic->pins[pin->pin_index].label;
+}
+
+// NOTE(erick): Splits the sorted pins into nets. Where the nets start may be
+//  known already, otherwise the labels are compared.
+static void group_nets(NetList* list, bool* starts_net) {
+    // NOTE(erick): There are never more nets than pins.
+    list->nets = (Net*) malloc((list->n_pins + 1) * sizeof(Net));
+    for(usize pin_index = 0; pin_index < list->n_pins; ) {
+        NetPin* first = list->pins + pin_index;
+        Pin* first_pin = first->ic->pins + first->pin_index;
+
+        Net net = {.label = first_pin->label,
+                   .type = first_pin->type,
+                   .pins = first};
+
+        net.n_pins++;
+        pin_index++;
+
+        while(pin_index < list->n_pins) {
+            if(starts_net) {
+                if(starts_net[pin_index]) { break; }
+            } else if(strcmp(label_of(list->pins + pin_index), net.label) != 0) {
+                break;
+            }
+
+            net.n_pins++;
+            pin_index++;
+        }
+
+        list->nets[list->count++] = net;
+    }
+}
+
+NetList build_net_list(ICList ic_list) {
+    NetList result = {};
+
+    usize n_pins = 0;
+    for(usize ic_index = 0; ic_index < ic_list.count; ic_index++) {
+        n_pins += ic_list.data[ic_index].n_pins;
+    }
+
+    result.pins = (NetPin*) malloc((n_pins + 1) * sizeof(NetPin));
+    for(usize ic_index = 0; ic_index < ic_list.count; ic_index++) {
+        IC* ic = ic_list.data + ic_index;
+
+        for(uint pin_index = 0; pin_index < ic->n_pins; pin_index++) {
+            if(ic->pins[pin_index].type == NOT_CONNECTED) { continue; }
+
+            NetPin pin = {.ic = ic, .pin_index = pin_index};
+            result.pins[result.n_pins++] = pin;
+        }
+    }
+
+    qsort(result.pins, result.n_pins, sizeof(NetPin), compare_net_pins);
+    group_nets(&result, NULL);
+
+    return result;
+}
+
+static bool is_changed_ic(IC* ic, IC* first, usize count) {
+    return ic >= first && ic < first + count;
+}
+
+// NOTE(erick): The count ICs from first had their pins replaced, in place. The
+//  pins of the other ICs are still in order, so only the new pins are sorted
+//  and put in between them. Where the nets start is taken from the old nets,
+//  so only the labels next to the new pins are compared.
+void update_net_list(NetList* list, ICList ic_list, usize first, usize count) {
+    IC* first_ic = ic_list.data + first;
+
+    usize n_new_pins = 0;
+    for(usize i = 0; i < count; i++) { n_new_pins += first_ic[i].n_pins; }
+
+    NetPin* new_pins = (NetPin*) malloc((n_new_pins + 1) * sizeof(NetPin));
+    n_new_pins = 0;
+    for(usize i = 0; i < count; i++) {
+        IC* ic = first_ic + i;
+
+        for(uint pin_index = 0; pin_index < ic->n_pins; pin_index++) {
+            if(ic->pins[pin_index].type == NOT_CONNECTED) { continue; }
+
+            NetPin pin = {.ic = ic, .pin_index = pin_index};
+            new_pins[n_new_pins++] = pin;
+        }
+    }
+    qsort(new_pins, n_new_pins, sizeof(NetPin), compare_net_pins);
+
+    // NOTE(erick): The old pins of the changed ICs go first. Their labels are
+    //  gone, so they cannot be compared. The kept pins are moved down over
+    //  them, never past where they are read from.
+    bool* kept_starts_net = (bool*) malloc((list->n_pins + 1) * sizeof(bool));
+    usize n_kept = 0;
+    for(usize net_index = 0; net_index < list->count; net_index++) {
+        Net* net = list->nets + net_index;
+
+        bool is_first = true;
+        for(uint i = 0; i < net->n_pins; i++) {
+            if(is_changed_ic(net->pins[i].ic, first_ic, count)) { continue; }
+
+            list->pins[n_kept] = net->pins[i];
+            kept_starts_net[n_kept++] = is_first;
+            is_first = false;
+        }
+    }
+
+    NetPin* pins = (NetPin*) malloc((n_kept + n_new_pins + 1) * sizeof(NetPin));
+    bool* starts_net = (bool*) malloc((n_kept + n_new_pins + 1) * sizeof(bool));
+    usize n_pins = 0;
+    usize kept_index = 0;
+    for(usize i = 0; i < n_new_pins; i++) {
+        usize begin = kept_index;
+        usize end = n_kept;
+        while(begin < end) {
+            usize middle = begin + (end - begin) / 2;
+            if(compare_net_pins(list->pins + middle, new_pins + i) < 0) {
+                begin = middle + 1;
+            } else {
+                end = middle;
+            }
+        }
+
+        memcpy(pins + n_pins, list->pins + kept_index, (begin - kept_index) * sizeof(NetPin));
+        memcpy(starts_net + n_pins, kept_starts_net + kept_index, (begin - kept_index) * sizeof(bool));
+        n_pins += begin - kept_index;
+        kept_index = begin;
+
+        char* label = label_of(new_pins + i);
+        starts_net[n_pins] = !n_pins || strcmp(label_of(pins + n_pins - 1), label) != 0;
+        pins[n_pins++] = new_pins[i];
+
+        // NOTE(erick): The kept pin after it may be on its net.
+        if(kept_index < n_kept && kept_starts_net[kept_index] &&
+           strcmp(label_of(list->pins + kept_index), label) == 0) {
+            kept_starts_net[kept_index] = false;
+        }
+    }
+
+    memcpy(pins + n_pins, list->pins + kept_index, (n_kept - kept_index) * sizeof(NetPin));
+    memcpy(starts_net + n_pins, kept_starts_net + kept_index, (n_kept - kept_index) * sizeof(bool));
+    n_pins += n_kept - kept_index;
+
+    free(new_pins);
+    free(kept_starts_net);
+    free(list->pins);
+    free(list->nets);
+
+    list->pins = pins;
+    list->n_pins = n_pins;
+    list->nets = NULL;
+    list->count = 0;
+    group_nets(list, starts_net);
+
+    free(starts_net);
+}
+
+// NOTE(erick): Nets are sorted by label.
+Net* find_net(NetList* list, char* label) {
+    usize begin = 0;
+    usize end = list->count;
+
+    while(begin < end) {
+        usize middle = begin + (end - begin) / 2;
+        int order = strcmp(label, list->nets[middle].label);
+
+        if(order == 0) { return list->nets + middle; }
+        if(order < 0) {
+            end = middle;
+        } else {
+            begin = middle + 1;
+        }
+    }
+
+    return NULL;
+}
+
+// NOTE(erick): A NULL ic means nothing is highlighted.
+void update_net_highlight(NetHighlight* highlight, NetList* list, IC* ic,
+                          uint pin_index) {
+    if(highlight->valid && highlight->ic == ic && highlight->pin_index == pin_index) {
+        return;
+    }
+
+    memset(highlight, 0, sizeof(NetHighlight));
+    highlight->ic = ic;
+    highlight->pin_index = pin_index;
+    highlight->valid = true;
+
+    if(!ic || pin_index >= ic->n_pins) { return; }
+
+    highlight->net = find_net(list, ic->pins[pin_index].label);
+    if(!highlight->net) { return; }
+
+    for(uint i = 0; i < highlight->net->n_pins; i++) {
+        if(highlight->net->pins[i].ic->location.column) {
+            highlight->n_placed++;
+        } else {
+            highlight->n_outside++;
+        }
+    }
+}
+
+void free_net_list(NetList* list) {
+    free(list->nets);
+    free(list->pins);
+    memset(list, 0, sizeof(NetList));
+}
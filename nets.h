@@ -0,0 +1,52 @@
+#ifndef NETS_H
+#define NETS_H 1
+
+#include "ICs.h"
+
+// NOTE(erick): Pins with the same label are on the same net. The pins of a
+//  net are contiguous in NetList.pins, nets are sorted by label and the pins of
+//  a net are in list order, so the result does not depend on how the labels
+//  are hashed or sorted. N.C. pins are on no net.
+
+typedef struct {
+    IC* ic;
+    uint pin_index;
+} NetPin;
+
+typedef struct {
+    char* label;
+    PinType type;
+
+    NetPin* pins;
+    uint n_pins;
+} Net;
+
+typedef struct {
+    Net* nets;
+    usize count;
+
+    NetPin* pins;
+    usize n_pins;
+} NetList;
+
+// NOTE(erick): The net of a pin and how many of its pins are on the board.
+//  Only the pins of that one net are looked at, and the result is kept until
+//  the placement or the pin changes.
+typedef struct {
+    IC* ic;
+    uint pin_index;
+    bool valid;
+
+    Net* net;
+    uint n_placed;
+    uint n_outside;
+} NetHighlight;
+
+NetList build_net_list(ICList);
+void update_net_list(NetList*, ICList, usize, usize);
+void free_net_list(NetList*);
+Net* find_net(NetList*, char*);
+
+void update_net_highlight(NetHighlight*, NetList*, IC*, uint);
+
+#endif
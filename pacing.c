@@ -0,0 +1,160 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "pacing.h"
+
+static const char* policy_names[] = {
+    "on-demand",
+    "capped",
+    "continuous",
+};
+
+bool parse_frame_policy(char* name, FramePolicy* policy) {
+    for(uint i = 0; i < sizeof(policy_names) / sizeof(policy_names[0]); i++) {
+        if(strcmp(name, policy_names[i]) == 0) {
+            *policy = (FramePolicy) i;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+const char* frame_policy_name(FramePolicy policy) {
+    return policy_names[policy];
+}
+
+FramePacer init_frame_pacer(FramePolicy policy, int refresh_rate) {
+    FramePacer result = {};
+
+    // NOTE(erick): Some drivers report 0 when they don't know.
+    if(refresh_rate <= 0) { refresh_rate = 60; }
+
+    result.policy = policy;
+    result.frequency = SDL_GetPerformanceFrequency();
+    result.frame_ticks = result.frequency / refresh_rate;
+    result.next_frame = SDL_GetPerformanceCounter() + result.frame_ticks;
+
+    return result;
+}
+
+// NOTE(erick): We sleep most of the remaining time and spin the last
+//  millisecond, SDL_Delay is not precise.
+void wait_for_next_frame(FramePacer* pacer) {
+    if(pacer->policy == FRAME_POLICY_CONTINUOUS) { return; }
+
+    uint64 now = SDL_GetPerformanceCounter();
+    if(now < pacer->next_frame) {
+        uint64 remaining_ms = (pacer->next_frame - now) * 1000 / pacer->frequency;
+        if(remaining_ms > 1) {
+            SDL_Delay((uint32) (remaining_ms - 1));
+        }
+
+        while(SDL_GetPerformanceCounter() < pacer->next_frame) { }
+        pacer->next_frame += pacer->frame_ticks;
+    } else {
+        // NOTE(erick): We missed the deadline. Don't try to catch up.
+        pacer->next_frame = now + pacer->frame_ticks;
+    }
+}
+
+static bool is_pan_key(SDL_Keycode key) {
+    return key == SDLK_w || key == SDLK_a || key == SDLK_s || key == SDLK_d;
+}
+
+static bool is_move_key(SDL_Keycode key) {
+    return key == SDLK_UP || key == SDLK_DOWN || key == SDLK_LEFT || key == SDLK_RIGHT;
+}
+
+static bool is_zoom_key(SDL_Keycode key) {
+    return key == SDLK_EQUALS || key == SDLK_PLUS || key == SDLK_MINUS ||
+        key == SDLK_KP_PLUS || key == SDLK_KP_MINUS;
+}
+
+bool is_repeating_key(SDL_Keycode key) {
+    return is_pan_key(key) || is_move_key(key) || is_zoom_key(key);
+}
+
+void press_key(KeyRepeat* repeat, SDL_Keycode key, uint32 time_ms) {
+    if(!is_repeating_key(key)) { return; }
+
+    for(uint i = 0; i < repeat->n_held; i++) {
+        if(repeat->held[i].key == key) { return; }
+    }
+
+    if(repeat->n_held == MAX_HELD_KEYS) { return; }
+
+    // NOTE(erick): Nothing was held, so the fixed step clock was idle.
+    if(!repeat->n_held) { repeat->update_time_ms = time_ms; }
+
+    HeldKey* held = repeat->held + repeat->n_held++;
+    held->key = key;
+    held->pressed_at_ms = time_ms;
+    held->next_repeat_ms = time_ms + REPEAT_DELAY_MS;
+    held->pan_remainder = 0.0f;
+}
+
+void release_key(KeyRepeat* repeat, SDL_Keycode key) {
+    for(uint i = 0; i < repeat->n_held; i++) {
+        if(repeat->held[i].key == key) {
+            repeat->held[i] = repeat->held[--repeat->n_held];
+            return;
+        }
+    }
+}
+
+bool has_held_keys(KeyRepeat* repeat) {
+    return repeat->n_held != 0;
+}
+
+uint32 next_update_ms(KeyRepeat* repeat) {
+    return repeat->update_time_ms + UPDATE_STEP_MS;
+}
+
+static float pan_speed(uint32 held_ms) {
+    float speed = PAN_SPEED_MIN + PAN_ACCELERATION * (held_ms / 1000.0f);
+    return speed > PAN_SPEED_MAX ? PAN_SPEED_MAX : speed;
+}
+
+// NOTE(erick): Runs every fixed step up to until_ms and returns what they
+//  produced: repeated movement keys (in order) and the total pan.
+RepeatResult step_key_repeat(KeyRepeat* repeat, uint32 until_ms) {
+    RepeatResult result = {};
+
+    if(!repeat->n_held) {
+        repeat->update_time_ms = until_ms;
+        return result;
+    }
+
+    while(repeat->update_time_ms + UPDATE_STEP_MS <= until_ms) {
+        repeat->update_time_ms += UPDATE_STEP_MS;
+        uint32 now_ms = repeat->update_time_ms;
+
+        for(uint i = 0; i < repeat->n_held; i++) {
+            HeldKey* held = repeat->held + i;
+            if(now_ms < held->pressed_at_ms + REPEAT_DELAY_MS) { continue; }
+
+            if(is_pan_key(held->key)) {
+                float distance = pan_speed(now_ms - held->pressed_at_ms) *
+                    UPDATE_STEP_MS / 1000.0f + held->pan_remainder;
+                int32 pixels = (int32) distance;
+                held->pan_remainder = distance - pixels;
+
+                switch(held->key) {
+                case SDLK_w: result.pan_dy -= pixels; break;
+                case SDLK_s: result.pan_dy += pixels; break;
+                case SDLK_a: result.pan_dx -= pixels; break;
+                case SDLK_d: result.pan_dx += pixels; break;
+                }
+            } else if(now_ms >= held->next_repeat_ms) {
+                held->next_repeat_ms += REPEAT_INTERVAL_MS;
+
+                if(result.n_repeated_keys < MAX_REPEATS) {
+                    result.repeated_keys[result.n_repeated_keys++] = held->key;
+                }
+            }
+        }
+    }
+
+    return result;
+}
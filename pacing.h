@@ -0,0 +1,77 @@
+#ifndef PACING_H
+#define PACING_H 1
+
+#include <SDL2/SDL.h>
+
+#include "ICs.h"
+
+// NOTE(erick): Held keys are updated on a fixed time step, independent of the
+//  frame rate, so moving and panning feel the same at 30 or 300 FPS.
+#define UPDATE_STEP_MS 8
+
+#define REPEAT_DELAY_MS    250
+#define REPEAT_INTERVAL_MS 50
+
+// NOTE(erick): Panning speeds are in screen pixels per second. The speed grows
+//  while the key is held, up to the maximum.
+#define PAN_SPEED_MIN      600.0f
+#define PAN_SPEED_MAX      4000.0f
+#define PAN_ACCELERATION   3000.0f
+
+#define MAX_HELD_KEYS 8
+#define MAX_REPEATS   64
+
+typedef enum {
+    // NOTE(erick): Block until there is input, render only when something
+    //  changed and never faster than the display refresh.
+    FRAME_POLICY_ON_DEMAND,
+    // NOTE(erick): Render every frame, but never faster than the display refresh.
+    FRAME_POLICY_CAPPED,
+    // NOTE(erick): Render as fast as possible (the old behaviour).
+    FRAME_POLICY_CONTINUOUS,
+} FramePolicy;
+
+typedef struct {
+    FramePolicy policy;
+
+    uint64 frequency;
+    uint64 frame_ticks;
+    uint64 next_frame;
+} FramePacer;
+
+typedef struct {
+    SDL_Keycode key;
+    uint32 pressed_at_ms;
+    uint32 next_repeat_ms;
+    float pan_remainder;
+} HeldKey;
+
+typedef struct {
+    HeldKey held[MAX_HELD_KEYS];
+    uint n_held;
+
+    uint32 update_time_ms;
+} KeyRepeat;
+
+typedef struct {
+    SDL_Keycode repeated_keys[MAX_REPEATS];
+    uint n_repeated_keys;
+
+    int32 pan_dx;
+    int32 pan_dy;
+} RepeatResult;
+
+bool parse_frame_policy(char*, FramePolicy*);
+const char* frame_policy_name(FramePolicy);
+
+FramePacer init_frame_pacer(FramePolicy, int);
+void wait_for_next_frame(FramePacer*);
+
+bool is_repeating_key(SDL_Keycode);
+void press_key(KeyRepeat*, SDL_Keycode, uint32);
+void release_key(KeyRepeat*, SDL_Keycode);
+bool has_held_keys(KeyRepeat*);
+uint32 next_update_ms(KeyRepeat*);
+RepeatResult step_key_repeat(KeyRepeat*, uint32);
+
+#endif
@@ -0,0 +1,459 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+
+#include <zlib.h>
+
+#include "pdf.h"
+
+#include FT_OUTLINE_H
+
+// NOTE(erick): Object numbers that are known from the start.
+#define PDF_CATALOG_OBJECT 1
+#define PDF_PAGES_OBJECT   2
+
+static void buffer_printf(PdfBuffer* buffer, char* format, ...) {
+    va_list args;
+
+    while(true) {
+        usize available = buffer->capacity - buffer->size;
+
+        va_start(args, format);
+        int length = vsnprintf(buffer->data + buffer->size, available, format, args);
+        va_end(args);
+
+        if(length < 0) { return; }
+        if((usize) length < available) {
+            buffer->size += length;
+            return;
+        }
+
+        buffer->capacity = buffer->capacity ? buffer->capacity * 2 : 4096;
+        while(buffer->capacity - buffer->size <= (usize) length) { buffer->capacity *= 2; }
+        buffer->data = (char*) realloc(buffer->data, buffer->capacity);
+    }
+}
+
+static void free_buffer(PdfBuffer* buffer) {
+    free(buffer->data);
+    memset(buffer, 0, sizeof(PdfBuffer));
+}
+
+static void pdf_printf(PdfWriter* writer, char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    int length = vfprintf(writer->file, format, args);
+    va_end(args);
+
+    if(length < 0) {
+        writer->ok = false;
+    } else {
+        writer->written += length;
+    }
+}
+
+static void pdf_write(PdfWriter* writer, void* data, usize size) {
+    if(size && fwrite(data, size, 1, writer->file) != 1) { writer->ok = false; }
+    writer->written += size;
+}
+
+static uint reserve_object(PdfWriter* writer) {
+    if(writer->n_objects == writer->offsets_capacity) {
+        writer->offsets_capacity *= 2;
+        writer->offsets = (usize*) realloc(writer->offsets,
+                                           writer->offsets_capacity * sizeof(usize));
+    }
+
+    writer->offsets[writer->n_objects] = 0;
+    return writer->n_objects++;
+}
+
+static void begin_object(PdfWriter* writer, uint object) {
+    writer->offsets[object] = writer->written;
+    pdf_printf(writer, "%u 0 obj\n", object);
+}
+
+static void end_object(PdfWriter* writer) {
+    pdf_printf(writer, "endobj\n");
+}
+
+// NOTE(erick): Writes the buffer as a compressed stream object.
+static void write_stream_object(PdfWriter* writer, uint object, PdfBuffer* buffer) {
+    uLongf compressed_size = compressBound(buffer->size);
+    uint8* compressed = (uint8*) malloc(compressed_size);
+    if(!compressed ||
+       compress2(compressed, &compressed_size, (uint8*) buffer->data, buffer->size,
+                 Z_BEST_SPEED) != Z_OK) {
+        free(compressed);
+        writer->ok = false;
+        return;
+    }
+
+    begin_object(writer, object);
+    pdf_printf(writer, "<< /Length %lu /Filter /FlateDecode >>\nstream\n",
+               (unsigned long) compressed_size);
+    pdf_write(writer, compressed, compressed_size);
+    pdf_printf(writer, "\nendstream\n");
+    end_object(writer);
+
+    free(compressed);
+}
+
+bool begin_pdf(PdfWriter* writer, char* filename) {
+    memset(writer, 0, sizeof(PdfWriter));
+
+    if(FT_Init_FreeType(&writer->library) != 0) {
+        fprintf(stderr, "Could not init FreeType.\n");
+        return false;
+    }
+
+    writer->file = fopen(filename, "wb");
+    if(!writer->file) {
+        fprintf(stderr, "Could not open [%s] to write the PDF.\n", filename);
+        FT_Done_FreeType(writer->library);
+        return false;
+    }
+
+    writer->ok = true;
+    writer->offsets_capacity = 64;
+    writer->offsets = (usize*) malloc(writer->offsets_capacity * sizeof(usize));
+    // NOTE(erick): Object 0 is always free.
+    writer->n_objects = 1;
+    reserve_object(writer);
+    reserve_object(writer);
+
+    // NOTE(erick): The binary comment tells tools the file is not plain text.
+    pdf_printf(writer, "%%PDF-1.4\n%%\xe2\xe3\xcf\xd3\n");
+
+    return writer->ok;
+}
+
+// NOTE(erick): Fonts must be added before the first page.
+bool add_pdf_font(PdfWriter* writer, char* filename, TTF_Font* ttf_font,
+                  int point_size) {
+    if(writer->n_fonts == PDF_MAX_FONTS) { return false; }
+
+    PdfFont* font = writer->fonts + writer->n_fonts;
+    memset(font, 0, sizeof(PdfFont));
+
+    if(FT_New_Face(writer->library, filename, 0, &font->face) != 0) {
+        fprintf(stderr, "Could not load [%s] for the PDF.\n", filename);
+        return false;
+    }
+
+    font->ttf_font = ttf_font;
+    font->point_size = point_size;
+    font->object = reserve_object(writer);
+    writer->n_fonts++;
+
+    return true;
+}
+
+void begin_pdf_page(PdfWriter* writer, int sheet_width, int sheet_height, uint dpi) {
+    writer->page_scale = 72.0f / dpi;
+    writer->page_width = sheet_width * writer->page_scale;
+    writer->page_height = sheet_height * writer->page_scale;
+
+    writer->content.size = 0;
+    buffer_printf(&writer->content, "q %.6f 0 0 %.6f 0 %.4f cm\n",
+                  writer->page_scale, -writer->page_scale, writer->page_height);
+}
+
+static PdfFont* font_of_text(PdfWriter* writer, BatchedText* text) {
+    for(uint i = 0; i < writer->n_fonts; i++) {
+        if(writer->fonts[i].ttf_font == text->atlas->font) { return writer->fonts + i; }
+    }
+
+    return NULL;
+}
+
+static void add_text_line(PdfWriter* writer, PdfFont* font, char* line, usize length) {
+    PdfBuffer* content = &writer->content;
+    FT_Face face = font->face;
+    FT_UInt previous = 0;
+
+    buffer_printf(content, "[(");
+    for(usize i = 0; i < length; i++) {
+        char c = line[i];
+        if(c < ATLAS_FIRST_GLYPH || c > ATLAS_LAST_GLYPH) { c = '?'; }
+        font->used[c - ATLAS_FIRST_GLYPH] = true;
+
+        FT_UInt glyph = FT_Get_Char_Index(face, c);
+        FT_Vector kerning = {};
+        if(previous && glyph && FT_HAS_KERNING(face)) {
+            FT_Get_Kerning(face, previous, glyph, FT_KERNING_UNSCALED, &kerning);
+        }
+        previous = glyph;
+
+        // NOTE(erick): TJ numbers are thousandths of an em, positive to the left.
+        if(kerning.x) {
+            buffer_printf(content, ") %ld (", -kerning.x * 1000 / face->units_per_EM);
+        }
+
+        if(c == '(' || c == ')' || c == '\\') {
+            buffer_printf(content, "\\%c", c);
+        } else {
+            buffer_printf(content, "%c", c);
+        }
+    }
+    buffer_printf(content, ")] TJ\n");
+}
+
+// NOTE(erick): Text is placed in its dest rect the way SDL_ttf lays it out:
+//  lines line_skip apart, each baseline at the ascent. Rotated text is turned
+//  180 degrees around the center of the rect.
+static void add_text(PdfWriter* writer, RenderBatch* batch, BatchedText* text) {
+    PdfFont* font = font_of_text(writer, text);
+    if(!font) { return; }
+
+    char* string = batch->text_arena + text->text_offset;
+    int text_w, text_h;
+    measure_text(text->atlas, string, &text_w, &text_h);
+    if(!text_w || !text_h) { return; }
+
+    float ratio = (float) text->dest.h / text_h;
+    float em = font->point_size * ratio;
+    float ascent = TTF_FontAscent(text->atlas->font) * ratio;
+    float line_skip = text->atlas->line_skip * ratio;
+    bool flip = text->rotation > 90.0 && text->rotation < 270.0;
+
+    PdfBuffer* content = &writer->content;
+    buffer_printf(content, "BT\n%.4f %.4f %.4f rg\n/F%u 1 Tf\n",
+                  text->color.r / 255.0f, text->color.g / 255.0f,
+                  text->color.b / 255.0f, (uint) (font - writer->fonts));
+
+    char* line = string;
+    for(uint line_index = 0; ; line_index++) {
+        char* line_end = strchr(line, '\n');
+        usize length = line_end ? (usize) (line_end - line) : strlen(line);
+
+        float baseline = ascent + line_index * line_skip;
+        if(flip) {
+            buffer_printf(content, "%.4f 0 0 %.4f %.4f %.4f Tm\n", -em, em,
+                          (float) text->dest.x + text->dest.w,
+                          text->dest.y + text->dest.h - baseline);
+        } else {
+            buffer_printf(content, "%.4f 0 0 %.4f %.4f %.4f Tm\n", em, -em,
+                          (float) text->dest.x, text->dest.y + baseline);
+        }
+
+        add_text_line(writer, font, line, length);
+
+        if(!line_end) { break; }
+        line = line_end + 1;
+    }
+
+    buffer_printf(content, "ET\n");
+}
+
+// NOTE(erick): Same order as the other backends: layers, then buckets, then
+//  text. The batch is left empty.
+void pdf_add_batch(PdfWriter* writer, RenderBatch* batch) {
+    PdfBuffer* content = &writer->content;
+
+    for(uint layer = 0; layer < BATCH_LAYER_COUNT; layer++) {
+        for(uint i = 0; i < batch->n_buckets[layer]; i++) {
+            RectBucket* bucket = batch->buckets[layer] + i;
+            if(!bucket->count) { continue; }
+
+            buffer_printf(content, "%.4f %.4f %.4f rg\n", bucket->color.r / 255.0f,
+                          bucket->color.g / 255.0f, bucket->color.b / 255.0f);
+
+            for(usize rect_index = 0; rect_index < bucket->count; rect_index++) {
+                SDL_Rect rect = bucket->rects[rect_index];
+                buffer_printf(content, "%d %d %d %d re\n", rect.x, rect.y, rect.w, rect.h);
+            }
+            buffer_printf(content, "f\n");
+        }
+    }
+
+    for(usize i = 0; i < batch->n_texts; i++) {
+        add_text(writer, batch, batch->texts + i);
+    }
+
+    clear_batch(batch);
+}
+
+void end_pdf_page(PdfWriter* writer) {
+    buffer_printf(&writer->content, "Q\n");
+
+    uint content_object = reserve_object(writer);
+    write_stream_object(writer, content_object, &writer->content);
+
+    uint page_object = reserve_object(writer);
+    begin_object(writer, page_object);
+    pdf_printf(writer, "<< /Type /Page /Parent %u 0 R /MediaBox [0 0 %.4f %.4f]\n",
+               PDF_PAGES_OBJECT, writer->page_width, writer->page_height);
+    pdf_printf(writer, "   /Contents %u 0 R /Resources << /Font <<", content_object);
+    for(uint i = 0; i < writer->n_fonts; i++) {
+        pdf_printf(writer, " /F%u %u 0 R", i, writer->fonts[i].object);
+    }
+    pdf_printf(writer, " >> >> >>\n");
+    end_object(writer);
+
+    if(writer->n_pages == writer->pages_capacity) {
+        writer->pages_capacity = writer->pages_capacity ? writer->pages_capacity * 2 : 8;
+        writer->pages = (uint*) realloc(writer->pages, writer->pages_capacity * sizeof(uint));
+    }
+    writer->pages[writer->n_pages++] = page_object;
+}
+
+typedef struct {
+    PdfBuffer* buffer;
+    FT_Vector current;
+} OutlineWalk;
+
+static int outline_move_to(const FT_Vector* to, void* user) {
+    OutlineWalk* walk = (OutlineWalk*) user;
+    buffer_printf(walk->buffer, "%ld %ld m\n", to->x, to->y);
+    walk->current = *to;
+    return 0;
+}
+
+static int outline_line_to(const FT_Vector* to, void* user) {
+    OutlineWalk* walk = (OutlineWalk*) user;
+    buffer_printf(walk->buffer, "%ld %ld l\n", to->x, to->y);
+    walk->current = *to;
+    return 0;
+}
+
+// NOTE(erick): PDF has no quadratic curves, the same curve as a cubic has its
+//  control points 2/3 of the way to the quadratic one.
+static int outline_conic_to(const FT_Vector* control, const FT_Vector* to, void* user) {
+    OutlineWalk* walk = (OutlineWalk*) user;
+    FT_Vector from = walk->current;
+
+    buffer_printf(walk->buffer, "%.2f %.2f %.2f %.2f %ld %ld c\n",
+                  from.x + 2.0f * (control->x - from.x) / 3.0f,
+                  from.y + 2.0f * (control->y - from.y) / 3.0f,
+                  to->x + 2.0f * (control->x - to->x) / 3.0f,
+                  to->y + 2.0f * (control->y - to->y) / 3.0f,
+                  to->x, to->y);
+    walk->current = *to;
+    return 0;
+}
+
+static int outline_cubic_to(const FT_Vector* control1, const FT_Vector* control2,
+                            const FT_Vector* to, void* user) {
+    OutlineWalk* walk = (OutlineWalk*) user;
+    buffer_printf(walk->buffer, "%ld %ld %ld %ld %ld %ld c\n", control1->x, control1->y,
+                  control2->x, control2->y, to->x, to->y);
+    walk->current = *to;
+    return 0;
+}
+
+// NOTE(erick): Glyphs are in font units, the font matrix scales them to an em.
+//  d1 leaves the color to whoever shows the text.
+static void write_font(PdfWriter* writer, PdfFont* font) {
+    FT_Face face = font->face;
+    int widths[ATLAS_N_GLYPHS] = {};
+    uint procs[ATLAS_N_GLYPHS] = {};
+
+    static const FT_Outline_Funcs outline_funcs = {
+        .move_to = outline_move_to,
+        .line_to = outline_line_to,
+        .conic_to = outline_conic_to,
+        .cubic_to = outline_cubic_to,
+    };
+
+    PdfBuffer glyph_buffer = {};
+    for(uint i = 0; i < ATLAS_N_GLYPHS; i++) {
+        if(!font->used[i]) { continue; }
+
+        char c = ATLAS_FIRST_GLYPH + i;
+        if(FT_Load_Char(face, c, FT_LOAD_NO_SCALE) != 0) {
+            font->used[i] = false;
+            continue;
+        }
+
+        FT_GlyphSlot slot = face->glyph;
+        FT_BBox box;
+        FT_Outline_Get_CBox(&slot->outline, &box);
+        widths[i] = slot->metrics.horiAdvance;
+
+        glyph_buffer.size = 0;
+        buffer_printf(&glyph_buffer, "%d 0 %ld %ld %ld %ld d1\n", widths[i],
+                      box.xMin, box.yMin, box.xMax, box.yMax);
+
+        OutlineWalk walk = {.buffer = &glyph_buffer};
+        FT_Outline_Decompose(&slot->outline, &outline_funcs, &walk);
+        buffer_printf(&glyph_buffer, "f\n");
+
+        procs[i] = reserve_object(writer);
+        write_stream_object(writer, procs[i], &glyph_buffer);
+    }
+    free_buffer(&glyph_buffer);
+
+    uint procs_object = reserve_object(writer);
+    begin_object(writer, procs_object);
+    pdf_printf(writer, "<<");
+    for(uint i = 0; i < ATLAS_N_GLYPHS; i++) {
+        if(font->used[i]) { pdf_printf(writer, " /g%u %u 0 R", i, procs[i]); }
+    }
+    pdf_printf(writer, " >>\n");
+    end_object(writer);
+
+    float scale = 1.0f / face->units_per_EM;
+    begin_object(writer, font->object);
+    pdf_printf(writer, "<< /Type /Font /Subtype /Type3\n");
+    pdf_printf(writer, "   /FontBBox [%ld %ld %ld %ld] /FontMatrix [%.8f 0 0 %.8f 0 0]\n",
+               face->bbox.xMin, face->bbox.yMin, face->bbox.xMax, face->bbox.yMax,
+               scale, scale);
+    pdf_printf(writer, "   /CharProcs %u 0 R /Resources << >>\n", procs_object);
+    pdf_printf(writer, "   /Encoding << /Type /Encoding /Differences [");
+    for(uint i = 0; i < ATLAS_N_GLYPHS; i++) {
+        if(font->used[i]) { pdf_printf(writer, " %u /g%u", ATLAS_FIRST_GLYPH + i, i); }
+    }
+    pdf_printf(writer, " ] >>\n");
+    pdf_printf(writer, "   /FirstChar %u /LastChar %u /Widths [",
+               ATLAS_FIRST_GLYPH, ATLAS_LAST_GLYPH);
+    for(uint i = 0; i < ATLAS_N_GLYPHS; i++) {
+        pdf_printf(writer, " %d", widths[i]);
+    }
+    pdf_printf(writer, " ] >>\n");
+    end_object(writer);
+}
+
+bool end_pdf(PdfWriter* writer) {
+    for(uint i = 0; i < writer->n_fonts; i++) {
+        write_font(writer, writer->fonts + i);
+    }
+
+    begin_object(writer, PDF_PAGES_OBJECT);
+    pdf_printf(writer, "<< /Type /Pages /Count %u /Kids [", writer->n_pages);
+    for(uint i = 0; i < writer->n_pages; i++) {
+        pdf_printf(writer, " %u 0 R", writer->pages[i]);
+    }
+    pdf_printf(writer, " ] >>\n");
+    end_object(writer);
+
+    begin_object(writer, PDF_CATALOG_OBJECT);
+    pdf_printf(writer, "<< /Type /Catalog /Pages %u 0 R >>\n", PDF_PAGES_OBJECT);
+    end_object(writer);
+
+    // NOTE(erick): Every xref entry is exactly 20 bytes, end of line included.
+    usize xref_offset = writer->written;
+    pdf_printf(writer, "xref\n0 %u\n", writer->n_objects);
+    pdf_printf(writer, "0000000000 65535 f\r\n");
+    for(uint i = 1; i < writer->n_objects; i++) {
+        pdf_printf(writer, "%010lu 00000 n\r\n", (unsigned long) writer->offsets[i]);
+    }
+    pdf_printf(writer, "trailer\n<< /Size %u /Root %u 0 R >>\nstartxref\n%lu\n%%%%EOF\n",
+               writer->n_objects, PDF_CATALOG_OBJECT, (unsigned long) xref_offset);
+
+    bool ok = writer->ok;
+    if(fclose(writer->file) != 0) { ok = false; }
+
+    for(uint i = 0; i < writer->n_fonts; i++) {
+        FT_Done_Face(writer->fonts[i].face);
+    }
+    FT_Done_FreeType(writer->library);
+
+    free(writer->offsets);
+    free(writer->pages);
+    free_buffer(&writer->content);
+    memset(writer, 0, sizeof(PdfWriter));
+
+    return ok;
+}
@@ -0,0 +1,71 @@
+#ifndef PDF_H
+#define PDF_H 1
+
+#include <stdio.h>
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+#include "ICs.h"
+#include "batch.h"
+
+// NOTE(erick): A single pass PDF writer for the batches draw.c records, so the
+//  sheet comes out as vectors instead of pixels. Rects become filled paths and
+//  text is set in Type3 fonts built from the outlines of the TTF files, with
+//  only the glyphs that were drawn. Pages are written as soon as they end; the
+//  fonts, whose glyph sets are only known then, go at the end of the file.
+
+#define PDF_MAX_FONTS 4
+
+typedef struct {
+    char* data;
+    usize size;
+    usize capacity;
+} PdfBuffer;
+
+typedef struct {
+    // NOTE(erick): Text drawn from an atlas of this font uses this PDF font.
+    TTF_Font* ttf_font;
+    int point_size;
+
+    FT_Face face;
+    uint object;
+    bool used[ATLAS_N_GLYPHS];
+} PdfFont;
+
+typedef struct {
+    FILE* file;
+    usize written;
+    bool ok;
+
+    // NOTE(erick): File offset of every object, by object number.
+    usize* offsets;
+    uint n_objects;
+    uint offsets_capacity;
+
+    uint* pages;
+    uint n_pages;
+    uint pages_capacity;
+
+    FT_Library library;
+    PdfFont fonts[PDF_MAX_FONTS];
+    uint n_fonts;
+
+    // NOTE(erick): Content of the current page. Sheet pixels map to points
+    //  with page_scale, y pointing down like on the sheet.
+    PdfBuffer content;
+    float page_scale;
+    float page_width;
+    float page_height;
+} PdfWriter;
+
+bool begin_pdf(PdfWriter*, char*);
+bool add_pdf_font(PdfWriter*, char*, TTF_Font*, int);
+
+void begin_pdf_page(PdfWriter*, int, int, uint);
+void pdf_add_batch(PdfWriter*, RenderBatch*);
+void end_pdf_page(PdfWriter*);
+
+bool end_pdf(PdfWriter*);
+
+#endif
@@ -0,0 +1,699 @@
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "placer.h"
+#include "nets.h"
+#include "router.h"
+
+#define PLACER_MAX_SLOTS (DRC_COLUMNS * DRC_ROWS * 2)
+
+// NOTE(erick): Where the pins one IC has on one net are, relative to the IC.
+typedef struct {
+    uint net;
+    DrcSide min_side;
+    DrcSide max_side;
+    uint min_dy;
+    uint max_dy;
+} NetSpan;
+
+typedef struct {
+    IC* ic;
+    uint height;
+
+    // NOTE(erick): By orientation. Both have the same nets in the same order.
+    NetSpan* spans[2];
+    uint n_spans;
+
+    // NOTE(erick): An identical IC placed before this one, or UINT_MAX.
+    uint twin;
+} PlacerIC;
+
+typedef struct {
+    uint8 column;
+    uint8 min_row;
+    uint8 orientation;
+} Slot;
+
+typedef struct {
+    Slot slot;
+    uint bound;
+} Child;
+
+typedef struct {
+    int min_x;
+    int max_x;
+    int min_y;
+    int max_y;
+    bool empty;
+} NetBox;
+
+typedef struct {
+    PlacerIC ics[PLACER_MAX_ICS];
+    uint n_ics;
+    uint n_nets;
+    uint max_spans;
+
+    // NOTE(erick): The extents the unplaced ICs alone give every net when the
+    //  first depth ICs are placed, at [depth * n_nets + net].
+    int* lone_x;
+    int* lone_y;
+
+    bool break_rotation;
+
+    Child top[PLACER_MAX_SLOTS];
+    bool top_done[PLACER_MAX_SLOTS];
+    uint n_top;
+    uint next_top;
+
+    // NOTE(erick): Read without the lock to prune, written with it.
+    uint best_cost;
+    Slot best[PLACER_MAX_ICS];
+    pthread_mutex_t best_lock;
+
+    double deadline;
+    bool timed_out;
+} PlacerSearch;
+
+typedef struct {
+    PlacerSearch* search;
+
+    NetBox* boxes;
+    // NOTE(erick): The boxes an IC changed, at [depth * max_spans + span].
+    NetBox* saved;
+
+    uint64 column_rows[DRC_COLUMNS];
+    Slot slots[PLACER_MAX_ICS];
+
+    uint64 nodes;
+    bool aborted;
+} PlacerWorker;
+
+static double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (double) ts.tv_sec + (double) ts.tv_nsec / 1e9;
+}
+
+static int hole_x(uint column, DrcSide side) {
+    StripLocation strip = {.column = column, .row = 1, .side = side};
+    return strip_x(strip);
+}
+
+static uint net_cost(NetBox* box, int lone_x, int lone_y) {
+    int x = box->empty ? 0 : box->max_x - box->min_x;
+    int y = box->empty ? 0 : box->max_y - box->min_y;
+    if(lone_x > x) { x = lone_x; }
+    if(lone_y > y) { y = lone_y; }
+
+    return x + y;
+}
+
+static NetBox grow_box(NetBox box, NetSpan* span, Slot slot) {
+    int min_x = hole_x(slot.column, span->min_side);
+    int max_x = hole_x(slot.column, span->max_side);
+    int min_y = slot.min_row + span->min_dy;
+    int max_y = slot.min_row + span->max_dy;
+
+    if(box.empty) {
+        NetBox result = {min_x, max_x, min_y, max_y, false};
+        return result;
+    }
+
+    if(min_x < box.min_x) { box.min_x = min_x; }
+    if(max_x > box.max_x) { box.max_x = max_x; }
+    if(min_y < box.min_y) { box.min_y = min_y; }
+    if(max_y > box.max_y) { box.max_y = max_y; }
+
+    return box;
+}
+
+static uint64 slot_rows(Slot slot, uint height) {
+    uint64 rows = height >= 64 ? ~0ull : (1ull << height) - 1;
+    return rows << (slot.min_row - 1);
+}
+
+static uint slot_key(Slot slot) {
+    return (slot.column * 64 + slot.min_row) * 2 + slot.orientation;
+}
+
+// NOTE(erick): The same IC after turning the whole board 180 degrees.
+static Slot rotated_slot(Slot slot, uint height) {
+    Slot result = {.column = DRC_COLUMNS + 1 - slot.column,
+                   .min_row = DRC_ROWS + 1 - (slot.min_row + height - 1),
+                   .orientation = slot.orientation == UP ? DOWN : UP};
+    return result;
+}
+
+static int extent(bool empty, int min, int max, int lone) {
+    int result = empty ? 0 : max - min;
+    return result > lone ? result : lone;
+}
+
+static int grown_extent(bool empty, int min, int max, int new_min, int new_max,
+                        int lone) {
+    if(empty) { return extent(false, new_min, new_max, lone); }
+
+    if(new_min > min) { new_min = min; }
+    if(new_max < max) { new_max = max; }
+    return extent(false, new_min, new_max, lone);
+}
+
+// NOTE(erick): The bound is a sum of x extents plus a sum of y extents. What
+//  an IC adds to the x part depends only on its column and orientation and
+//  what it adds to the y part only on its row and orientation, so the bound
+//  of every slot is the sum of two entries of these tables.
+static void child_deltas(PlacerWorker* worker, uint depth,
+                         int x_delta[DRC_COLUMNS][2], int y_delta[2][DRC_ROWS + 1]) {
+    PlacerSearch* search = worker->search;
+    PlacerIC* placer_ic = search->ics + depth;
+    uint n_nets = search->n_nets;
+    int* lone_x = search->lone_x + depth * n_nets;
+    int* lone_y = search->lone_y + depth * n_nets;
+
+    memset(x_delta, 0, DRC_COLUMNS * 2 * sizeof(int));
+    memset(y_delta, 0, 2 * (DRC_ROWS + 1) * sizeof(int));
+
+    for(uint orientation = UP; orientation <= DOWN; orientation++) {
+        for(uint i = 0; i < placer_ic->n_spans; i++) {
+            NetSpan* span = placer_ic->spans[orientation] + i;
+            NetBox* box = worker->boxes + span->net;
+
+            int old_x = extent(box->empty, box->min_x, box->max_x, lone_x[span->net]);
+            int old_y = extent(box->empty, box->min_y, box->max_y, lone_y[span->net]);
+            int next_lone_x = lone_x[n_nets + span->net];
+            int next_lone_y = lone_y[n_nets + span->net];
+
+            for(uint column = 1; column <= DRC_COLUMNS; column++) {
+                x_delta[column - 1][orientation] +=
+                    grown_extent(box->empty, box->min_x, box->max_x,
+                                 hole_x(column, span->min_side),
+                                 hole_x(column, span->max_side), next_lone_x) - old_x;
+            }
+
+            for(uint min_row = 1; min_row + placer_ic->height - 1 <= DRC_ROWS; min_row++) {
+                y_delta[orientation][min_row] +=
+                    grown_extent(box->empty, box->min_y, box->max_y,
+                                 min_row + span->min_dy,
+                                 min_row + span->max_dy, next_lone_y) - old_y;
+            }
+        }
+    }
+}
+
+static int compare_children(const void* a, const void* b) {
+    Child* child_a = (Child*) a;
+    Child* child_b = (Child*) b;
+
+    if(child_a->bound != child_b->bound) { return child_a->bound < child_b->bound ? -1 : 1; }
+    return (int) slot_key(child_a->slot) - (int) slot_key(child_b->slot);
+}
+
+// NOTE(erick): Every slot the IC at depth fits in with a bound under the best
+//  placement so far, by increasing bound.
+static uint legal_children(PlacerWorker* worker, uint depth, uint bound,
+                           Child* children) {
+    PlacerSearch* search = worker->search;
+    PlacerIC* placer_ic = search->ics + depth;
+    uint height = placer_ic->height;
+    uint best_cost = __atomic_load_n(&search->best_cost, __ATOMIC_RELAXED);
+    uint n_children = 0;
+
+    int x_delta[DRC_COLUMNS][2];
+    int y_delta[2][DRC_ROWS + 1];
+    child_deltas(worker, depth, x_delta, y_delta);
+
+    for(uint column = 1; column <= DRC_COLUMNS; column++) {
+        for(uint min_row = 1; min_row + height - 1 <= DRC_ROWS; min_row++) {
+            for(uint orientation = UP; orientation <= DOWN; orientation++) {
+                Slot slot = {column, min_row, orientation};
+                if(worker->column_rows[column - 1] & slot_rows(slot, height)) { continue; }
+
+                if(placer_ic->twin != UINT_MAX &&
+                   slot_key(slot) <= slot_key(worker->slots[placer_ic->twin])) {
+                    continue;
+                }
+
+                if(depth == 0 && search->break_rotation &&
+                   slot_key(slot) > slot_key(rotated_slot(slot, height))) {
+                    continue;
+                }
+
+                Child child = {slot, bound + x_delta[column - 1][orientation] +
+                               y_delta[orientation][min_row]};
+                if(child.bound < best_cost) { children[n_children++] = child; }
+            }
+        }
+    }
+
+    qsort(children, n_children, sizeof(Child), compare_children);
+    return n_children;
+}
+
+static void apply_slot(PlacerWorker* worker, uint depth, Slot slot) {
+    PlacerSearch* search = worker->search;
+    PlacerIC* placer_ic = search->ics + depth;
+    NetBox* saved = worker->saved + depth * search->max_spans;
+
+    for(uint i = 0; i < placer_ic->n_spans; i++) {
+        NetSpan* span = placer_ic->spans[slot.orientation] + i;
+        saved[i] = worker->boxes[span->net];
+        worker->boxes[span->net] = grow_box(saved[i], span, slot);
+    }
+
+    worker->column_rows[slot.column - 1] |= slot_rows(slot, placer_ic->height);
+    worker->slots[depth] = slot;
+}
+
+static void undo_slot(PlacerWorker* worker, uint depth) {
+    PlacerSearch* search = worker->search;
+    PlacerIC* placer_ic = search->ics + depth;
+    NetBox* saved = worker->saved + depth * search->max_spans;
+    Slot slot = worker->slots[depth];
+
+    for(uint i = 0; i < placer_ic->n_spans; i++) {
+        worker->boxes[placer_ic->spans[0][i].net] = saved[i];
+    }
+
+    worker->column_rows[slot.column - 1] &= ~slot_rows(slot, placer_ic->height);
+}
+
+static void found_placement(PlacerWorker* worker, uint cost) {
+    PlacerSearch* search = worker->search;
+
+    pthread_mutex_lock(&search->best_lock);
+    if(cost < search->best_cost) {
+        memcpy(search->best, worker->slots, search->n_ics * sizeof(Slot));
+        __atomic_store_n(&search->best_cost, cost, __ATOMIC_RELAXED);
+    }
+    pthread_mutex_unlock(&search->best_lock);
+}
+
+static void search_placement(PlacerWorker* worker, uint depth, uint bound) {
+    PlacerSearch* search = worker->search;
+
+    worker->nodes++;
+    if((worker->nodes & 4095) == 0 && now_seconds() > search->deadline) {
+        __atomic_store_n(&search->timed_out, true, __ATOMIC_RELAXED);
+    }
+    if(__atomic_load_n(&search->timed_out, __ATOMIC_RELAXED)) {
+        worker->aborted = true;
+        return;
+    }
+
+    // NOTE(erick): With every IC placed the bound is the wire length.
+    if(depth == search->n_ics) {
+        found_placement(worker, bound);
+        return;
+    }
+
+    Child children[PLACER_MAX_SLOTS];
+    uint n_children = legal_children(worker, depth, bound, children);
+
+    for(uint i = 0; i < n_children; i++) {
+        if(children[i].bound >= __atomic_load_n(&search->best_cost, __ATOMIC_RELAXED)) {
+            break;
+        }
+
+        apply_slot(worker, depth, children[i].slot);
+        search_placement(worker, depth + 1, children[i].bound);
+        undo_slot(worker, depth);
+
+        if(worker->aborted) { return; }
+    }
+}
+
+static void init_worker(PlacerWorker* worker, PlacerSearch* search) {
+    memset(worker, 0, sizeof(PlacerWorker));
+    worker->search = search;
+    worker->boxes = (NetBox*) malloc((search->n_nets + 1) * sizeof(NetBox));
+    worker->saved = (NetBox*) malloc((search->n_ics * search->max_spans + 1) *
+                                     sizeof(NetBox));
+
+    for(uint net = 0; net < search->n_nets; net++) {
+        worker->boxes[net].empty = true;
+    }
+}
+
+static void free_worker(PlacerWorker* worker) {
+    free(worker->boxes);
+    free(worker->saved);
+}
+
+static void* search_top_branches(void* data) {
+    PlacerWorker* worker = (PlacerWorker*) data;
+    PlacerSearch* search = worker->search;
+
+    while(true) {
+        uint index = __atomic_fetch_add(&search->next_top, 1, __ATOMIC_RELAXED);
+        if(index >= search->n_top) { break; }
+
+        Child* child = search->top + index;
+        if(child->bound < __atomic_load_n(&search->best_cost, __ATOMIC_RELAXED)) {
+            apply_slot(worker, 0, child->slot);
+            search_placement(worker, 1, child->bound);
+            undo_slot(worker, 0);
+        }
+
+        if(worker->aborted) { break; }
+        search->top_done[index] = true;
+    }
+
+    return NULL;
+}
+
+// NOTE(erick): Takes the best child all the way down, which gives the search
+//  a good first bound to prune with.
+static void greedy_placement(PlacerWorker* worker, uint root_bound) {
+    PlacerSearch* search = worker->search;
+    Child children[PLACER_MAX_SLOTS];
+
+    uint depth = 0;
+    uint bound = root_bound;
+    for(; depth < search->n_ics; depth++) {
+        uint n_children = legal_children(worker, depth, bound, children);
+        if(!n_children) { break; }
+
+        apply_slot(worker, depth, children[0].slot);
+        bound = children[0].bound;
+    }
+
+    if(depth == search->n_ics) {
+        found_placement(worker, bound);
+    }
+
+    while(depth > 0) {
+        undo_slot(worker, --depth);
+    }
+}
+
+static bool identical_ics(IC* a, IC* b) {
+    if(a->n_pins != b->n_pins) { return false; }
+    if(strcmp(a->code, b->code) != 0) { return false; }
+
+    for(uint pin_index = 0; pin_index < a->n_pins; pin_index++) {
+        if(strcmp(a->pins[pin_index].label, b->pins[pin_index].label) != 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void add_to_span(NetSpan* span, DrcSide side, uint dy) {
+    if(side < span->min_side) { span->min_side = side; }
+    if(side > span->max_side) { span->max_side = side; }
+    if(dy < span->min_dy) { span->min_dy = dy; }
+    if(dy > span->max_dy) { span->max_dy = dy; }
+}
+
+// NOTE(erick): Builds the spans of every IC, in list order, and returns the
+//  number of nets with more than one pin.
+static uint build_spans(ICList ic_list, PlacerIC* placer_ics) {
+    NetList nets = build_net_list(ic_list);
+
+    for(usize ic_index = 0; ic_index < ic_list.count; ic_index++) {
+        IC* ic = ic_list.data + ic_index;
+        PlacerIC* placer_ic = placer_ics + ic_index;
+
+        placer_ic->ic = ic;
+        placer_ic->height = ic->n_pins / 2;
+        placer_ic->spans[UP] = (NetSpan*) malloc((ic->n_pins + 1) * sizeof(NetSpan));
+        placer_ic->spans[DOWN] = (NetSpan*) malloc((ic->n_pins + 1) * sizeof(NetSpan));
+        placer_ic->twin = UINT_MAX;
+    }
+
+    uint n_nets = 0;
+    for(usize net_index = 0; net_index < nets.count; net_index++) {
+        Net* net = nets.nets + net_index;
+        if(net->n_pins < 2) { continue; }
+
+        for(uint i = 0; i < net->n_pins; i++) {
+            IC* ic = net->pins[i].ic;
+            PlacerIC* placer_ic = placer_ics + (ic - ic_list.data);
+
+            // NOTE(erick): The pins of a net are sorted by IC.
+            bool is_new = !placer_ic->n_spans ||
+                placer_ic->spans[UP][placer_ic->n_spans - 1].net != n_nets;
+
+            for(uint orientation = UP; orientation <= DOWN; orientation++) {
+                BreadboardLocation location = {.column = 1,
+                                               .row = orientation == UP ? 1 : placer_ic->height,
+                                               .orientation = orientation};
+                uint row;
+                DrcSide side;
+                pin_strip(ic, location, net->pins[i].pin_index, &row, &side);
+
+                NetSpan* spans = placer_ic->spans[orientation];
+                if(is_new) {
+                    NetSpan span = {n_nets, side, side, row - 1, row - 1};
+                    spans[placer_ic->n_spans] = span;
+                } else {
+                    add_to_span(spans + placer_ic->n_spans - 1, side, row - 1);
+                }
+            }
+
+            if(is_new) { placer_ic->n_spans++; }
+        }
+
+        n_nets++;
+    }
+
+    free_net_list(&nets);
+    return n_nets;
+}
+
+// NOTE(erick): The biggest IC first, then always the one with most nets in
+//  common with those already placed, so the bound grows as early as it can.
+static void order_ics(PlacerIC* placer_ics, uint n_ics, PlacerIC* ordered) {
+    bool taken[PLACER_MAX_ICS] = {};
+    uint shared[PLACER_MAX_ICS] = {};
+
+    for(uint depth = 0; depth < n_ics; depth++) {
+        uint next = UINT_MAX;
+        for(uint i = 0; i < n_ics; i++) {
+            if(taken[i]) { continue; }
+
+            if(next == UINT_MAX ||
+               shared[i] > shared[next] ||
+               (shared[i] == shared[next] &&
+                placer_ics[i].ic->n_pins > placer_ics[next].ic->n_pins)) {
+                next = i;
+            }
+        }
+
+        taken[next] = true;
+        ordered[depth] = placer_ics[next];
+
+        for(uint i = 0; i < n_ics; i++) {
+            if(taken[i]) { continue; }
+
+            PlacerIC* a = placer_ics + next;
+            PlacerIC* b = placer_ics + i;
+            for(uint j = 0; j < a->n_spans; j++) {
+                for(uint k = 0; k < b->n_spans; k++) {
+                    if(a->spans[UP][j].net == b->spans[UP][k].net) { shared[i]++; }
+                }
+            }
+        }
+    }
+}
+
+uint placement_wire_length(ICList ic_list) {
+    NetList nets = build_net_list(ic_list);
+    uint result = 0;
+
+    for(usize net_index = 0; net_index < nets.count; net_index++) {
+        Net* net = nets.nets + net_index;
+        NetBox box = {.empty = true};
+
+        for(uint i = 0; i < net->n_pins; i++) {
+            IC* ic = net->pins[i].ic;
+            uint row;
+            DrcSide side;
+            if(!pin_strip(ic, ic->location, net->pins[i].pin_index, &row, &side)) {
+                continue;
+            }
+
+            int x = hole_x(ic->location.column, side);
+            if(box.empty) {
+                NetBox first = {x, x, row, row, false};
+                box = first;
+            }
+
+            if(x < box.min_x) { box.min_x = x; }
+            if(x > box.max_x) { box.max_x = x; }
+            if((int) row < box.min_y) { box.min_y = row; }
+            if((int) row > box.max_y) { box.max_y = row; }
+        }
+
+        result += net_cost(&box, 0, 0);
+    }
+
+    free_net_list(&nets);
+    return result;
+}
+
+bool place_exact(ProjectContext* context, ICList ic_list, double time_limit,
+                 ExactPlacement* result) {
+    memset(result, 0, sizeof(ExactPlacement));
+    result->n_ics = ic_list.count;
+
+    if(ic_list.count == 0) { return false; }
+    if(ic_list.count > PLACER_MAX_ICS) {
+        context_message(context, "The exact placer handles at most %d ICs,"
+                        " the list has %zu.\n", PLACER_MAX_ICS, ic_list.count);
+        return false;
+    }
+
+    double begin = now_seconds();
+
+    PlacerSearch* search = (PlacerSearch*) calloc(1, sizeof(PlacerSearch));
+    search->n_ics = ic_list.count;
+    search->best_cost = UINT_MAX;
+    search->deadline = begin + time_limit;
+    pthread_mutex_init(&search->best_lock, NULL);
+
+    PlacerIC placer_ics[PLACER_MAX_ICS] = {};
+    search->n_nets = build_spans(ic_list, placer_ics);
+    order_ics(placer_ics, search->n_ics, search->ics);
+
+    uint n_nets = search->n_nets;
+    for(uint depth = 0; depth < search->n_ics; depth++) {
+        PlacerIC* placer_ic = search->ics + depth;
+        if(placer_ic->n_spans > search->max_spans) { search->max_spans = placer_ic->n_spans; }
+
+        for(uint earlier = 0; earlier < depth; earlier++) {
+            if(identical_ics(search->ics[earlier].ic, placer_ic->ic)) {
+                placer_ic->twin = earlier;
+            }
+        }
+    }
+
+    search->break_rotation = true;
+    for(uint depth = 1; depth < search->n_ics; depth++) {
+        if(identical_ics(search->ics[0].ic, search->ics[depth].ic)) {
+            search->break_rotation = false;
+        }
+    }
+
+    search->lone_x = (int*) calloc((search->n_ics + 1) * n_nets + 1, sizeof(int));
+    search->lone_y = (int*) calloc((search->n_ics + 1) * n_nets + 1, sizeof(int));
+    for(int depth = search->n_ics - 1; depth >= 0; depth--) {
+        int* lone_x = search->lone_x + depth * n_nets;
+        int* lone_y = search->lone_y + depth * n_nets;
+        memcpy(lone_x, lone_x + n_nets, n_nets * sizeof(int));
+        memcpy(lone_y, lone_y + n_nets, n_nets * sizeof(int));
+
+        PlacerIC* placer_ic = search->ics + depth;
+        for(uint i = 0; i < placer_ic->n_spans; i++) {
+            NetSpan* span = placer_ic->spans[UP] + i;
+            int x = hole_x(1, span->max_side) - hole_x(1, span->min_side);
+            int y = span->max_dy - span->min_dy;
+
+            if(x > lone_x[span->net]) { lone_x[span->net] = x; }
+            if(y > lone_y[span->net]) { lone_y[span->net] = y; }
+        }
+    }
+
+    uint root_bound = 0;
+    for(uint net = 0; net < n_nets; net++) {
+        root_bound += search->lone_x[net] + search->lone_y[net];
+    }
+
+    PlacerWorker workers[PLACER_MAX_THREADS];
+    init_worker(workers + 0, search);
+
+    greedy_placement(workers + 0, root_bound);
+    search->n_top = legal_children(workers + 0, 0, root_bound, search->top);
+
+    long n_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    uint n_threads = n_cpus < 1 ? 1 : n_cpus;
+    if(n_threads > PLACER_MAX_THREADS) { n_threads = PLACER_MAX_THREADS; }
+    if(n_threads > search->n_top) { n_threads = search->n_top ? search->n_top : 1; }
+
+    // NOTE(erick): The calling thread is the first worker.
+    pthread_t threads[PLACER_MAX_THREADS];
+    uint n_started = 0;
+    for(uint i = 1; i < n_threads; i++) {
+        init_worker(workers + i, search);
+        if(pthread_create(threads + i, NULL, search_top_branches, workers + i) != 0) {
+            free_worker(workers + i);
+            break;
+        }
+        n_started++;
+    }
+
+    search_top_branches(workers + 0);
+
+    for(uint i = 1; i <= n_started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    for(uint i = 0; i <= n_started; i++) {
+        result->nodes += workers[i].nodes;
+        free_worker(workers + i);
+    }
+
+    // NOTE(erick): Branches that were not finished may still hold something
+    //  as good as their bound.
+    uint lower_bound = search->best_cost;
+    for(uint i = 0; i < search->n_top; i++) {
+        if(!search->top_done[i] && search->top[i].bound < lower_bound) {
+            lower_bound = search->top[i].bound;
+        }
+    }
+
+    result->n_threads = n_started + 1;
+    result->optimal = !search->timed_out;
+    result->seconds = now_seconds() - begin;
+
+    bool found = search->best_cost != UINT_MAX;
+    if(found) {
+        result->wire_length = search->best_cost;
+        result->lower_bound = lower_bound;
+        result->gap = result->wire_length ?
+            (double) (result->wire_length - lower_bound) / result->wire_length : 0.0;
+
+        for(uint depth = 0; depth < search->n_ics; depth++) {
+            IC* ic = search->ics[depth].ic;
+            Slot slot = search->best[depth];
+
+            record_placement_change(ic_list, ic);
+            ic->location.column = slot.column;
+            ic->location.orientation = slot.orientation;
+            ic->location.row = slot.orientation == UP ?
+                slot.min_row : slot.min_row + search->ics[depth].height - 1;
+        }
+    } else if(search->timed_out) {
+        context_message(context, "The exact placer found no placement in %.1f"
+                        " seconds.\n", time_limit);
+    } else {
+        context_message(context, "The ICs do not fit on the board.\n");
+    }
+
+    for(uint depth = 0; depth < search->n_ics; depth++) {
+        free(search->ics[depth].spans[UP]);
+        free(search->ics[depth].spans[DOWN]);
+    }
+    free(search->lone_x);
+    free(search->lone_y);
+    pthread_mutex_destroy(&search->best_lock);
+    free(search);
+
+    return found;
+}
+
+void print_exact_placement_report(FILE* output, ExactPlacement* placement) {
+    fprintf(output, "Exact placement of %u ICs: %s, wire length %u holes.\n",
+            placement->n_ics, placement->optimal ? "optimal" : "time limit reached",
+            placement->wire_length);
+    fprintf(output, "Lower bound %u, gap %.2f%%, %llu nodes in %.3f s on %u thread%s.\n",
+            placement->lower_bound, placement->gap * 100.0,
+            (unsigned long long) placement->nodes, placement->seconds,
+            placement->n_threads, placement->n_threads == 1 ? "" : "s");
+}
@@ -0,0 +1,43 @@
+#ifndef PLACER_H
+#define PLACER_H 1
+
+#include <stdio.h>
+
+#include "ICs.h"
+#include "context.h"
+
+// NOTE(erick): Exact placement for small boards. Every IC of the list is
+//  placed on columns 1 to 3, rows 1 to 64, UP or DOWN, without overlaps, so
+//  that the total half-perimeter wire length of the nets (in holes, on the
+//  board model of router.h) is minimal.
+//
+// It is a depth first branch and bound. The bound of a partial placement is,
+//  for every net, the extents of its placed pins or, if larger, the extents
+//  any single unplaced IC will add to it on its own, since the pins of one IC
+//  are fixed relative to each other. ICs that are identical (same code and
+//  same labels) are placed in increasing slot order and, when the first IC
+//  has no twin, only one of a placement and its 180 degree rotation is
+//  searched. The branches of the first IC are split among threads.
+
+#define PLACER_MAX_ICS 16
+#define PLACER_MAX_THREADS 32
+
+typedef struct {
+    uint n_ics;
+    // NOTE(erick): False when the time ran out first.
+    bool optimal;
+
+    uint wire_length;
+    uint lower_bound;
+    double gap;
+
+    uint64 nodes;
+    double seconds;
+    uint n_threads;
+} ExactPlacement;
+
+uint placement_wire_length(ICList);
+bool place_exact(ProjectContext*, ICList, double, ExactPlacement*);
+void print_exact_placement_report(FILE*, ExactPlacement*);
+
+#endif
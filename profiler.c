@@ -0,0 +1,183 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <SDL2/SDL.h>
+
+#include "profiler.h"
+
+// NOTE(erick): The profiler is a single global instance. It is only meant to
+//  be touched by the thread that renders, so there is no locking here.
+typedef struct {
+    uint64 frequency;
+    uint64 origin;
+
+    uint64 frame_begin;
+    uint64 section_begin[PROFILE_SECTION_COUNT];
+    uint64 section_ticks[PROFILE_SECTION_COUNT];
+    uint32 counters[PROFILE_COUNTER_COUNT];
+
+    // NOTE(erick): Values of the last finished frame. These are the ones
+    //  displayed, the ones above are still being accumulated.
+    float last_frame_ms;
+    float last_section_ms[PROFILE_SECTION_COUNT];
+    uint32 last_counters[PROFILE_COUNTER_COUNT];
+
+    float frame_history[PROFILE_HISTORY_SIZE];
+    uint history_count;
+    uint history_next;
+
+    FILE* trace_file;
+    bool trace_has_events;
+} Profiler;
+
+static Profiler profiler;
+
+static const char* section_names[PROFILE_SECTION_COUNT] = {
+    "prepare_canvas",
+    "draw_grid",
+    "draw_numbers",
+    "draw_ics",
+    "flush_batch",
+    "draw_canvas_to_framebuffer",
+    "swap_buffers",
+};
+
+static const char* counter_names[PROFILE_COUNTER_COUNT] = {
+    "text rasterizations",
+    "texture creations",
+    "tiles rendered",
+    "draw calls",
+};
+
+static float ticks_to_ms(uint64 ticks) {
+    return (float) ((double) ticks * 1000.0 / (double) profiler.frequency);
+}
+
+static double ticks_to_us(uint64 ticks) {
+    return (double) ticks * 1000000.0 / (double) profiler.frequency;
+}
+
+void init_profiler() {
+    memset(&profiler, 0, sizeof(profiler));
+
+    profiler.frequency = SDL_GetPerformanceFrequency();
+    profiler.origin = SDL_GetPerformanceCounter();
+}
+
+// NOTE(erick): The trace uses the Chrome trace event format. It can be loaded
+//  in chrome://tracing or https://ui.perfetto.dev
+bool open_profile_trace(char* filename) {
+    profiler.trace_file = fopen(filename, "w");
+    if(!profiler.trace_file) { return false; }
+
+    fprintf(profiler.trace_file, "{\"traceEvents\":[\n");
+    profiler.trace_has_events = false;
+
+    return true;
+}
+
+void close_profile_trace() {
+    if(!profiler.trace_file) { return; }
+
+    fprintf(profiler.trace_file, "\n]}\n");
+    fclose(profiler.trace_file);
+    profiler.trace_file = NULL;
+}
+
+static void write_trace_event(const char* name, uint64 begin, uint64 end) {
+    if(!profiler.trace_file) { return; }
+
+    if(profiler.trace_has_events) {
+        fprintf(profiler.trace_file, ",\n");
+    }
+
+    fprintf(profiler.trace_file,
+            "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":0,"
+            "\"ts\":%.3f,\"dur\":%.3f}",
+            name, ticks_to_us(begin - profiler.origin), ticks_to_us(end - begin));
+    profiler.trace_has_events = true;
+}
+
+void profile_frame_boundary() {
+    uint64 now = SDL_GetPerformanceCounter();
+
+    if(profiler.frame_begin) {
+        profiler.last_frame_ms = ticks_to_ms(now - profiler.frame_begin);
+
+        profiler.frame_history[profiler.history_next] = profiler.last_frame_ms;
+        profiler.history_next = (profiler.history_next + 1) % PROFILE_HISTORY_SIZE;
+        if(profiler.history_count < PROFILE_HISTORY_SIZE) {
+            profiler.history_count++;
+        }
+
+        write_trace_event("frame", profiler.frame_begin, now);
+    }
+
+    for(uint section = 0; section < PROFILE_SECTION_COUNT; section++) {
+        profiler.last_section_ms[section] = ticks_to_ms(profiler.section_ticks[section]);
+        profiler.section_ticks[section] = 0;
+    }
+
+    for(uint counter = 0; counter < PROFILE_COUNTER_COUNT; counter++) {
+        profiler.last_counters[counter] = profiler.counters[counter];
+        profiler.counters[counter] = 0;
+    }
+
+    profiler.frame_begin = now;
+}
+
+void profile_begin(ProfileSection section) {
+    profiler.section_begin[section] = SDL_GetPerformanceCounter();
+}
+
+void profile_end(ProfileSection section) {
+    uint64 now = SDL_GetPerformanceCounter();
+    uint64 begin = profiler.section_begin[section];
+
+    profiler.section_ticks[section] += now - begin;
+    write_trace_event(section_names[section], begin, now);
+}
+
+void profile_count(ProfileCounter counter) {
+    profiler.counters[counter]++;
+}
+
+float profile_frame_ms() {
+    return profiler.last_frame_ms;
+}
+
+static int compare_floats(const void* a, const void* b) {
+    float fa = *(const float*) a;
+    float fb = *(const float*) b;
+
+    return (fa > fb) - (fa < fb);
+}
+
+// NOTE(erick): percentile goes from 0.0 to 1.0.
+float profile_frame_percentile(float percentile) {
+    if(!profiler.history_count) { return 0.0f; }
+
+    float sorted[PROFILE_HISTORY_SIZE];
+    memcpy(sorted, profiler.frame_history, profiler.history_count * sizeof(float));
+    qsort(sorted, profiler.history_count, sizeof(float), compare_floats);
+
+    uint index = (uint) (percentile * (profiler.history_count - 1) + 0.5f);
+    return sorted[index];
+}
+
+float profile_section_ms(ProfileSection section) {
+    return profiler.last_section_ms[section];
+}
+
+uint32 profile_counter(ProfileCounter counter) {
+    return profiler.last_counters[counter];
+}
+
+const char* profile_section_name(ProfileSection section) {
+    return section_names[section];
+}
+
+const char* profile_counter_name(ProfileCounter counter) {
+    return counter_names[counter];
+}
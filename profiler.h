@@ -0,0 +1,46 @@
+#ifndef PROFILER_H
+#define PROFILER_H 1
+
+#include "ICs.h"
+
+// NOTE(erick): Number of frames kept to compute the percentiles shown on the HUD.
+#define PROFILE_HISTORY_SIZE 256
+
+typedef enum {
+    PROFILE_PREPARE_CANVAS,
+    PROFILE_DRAW_GRID,
+    PROFILE_DRAW_NUMBERS,
+    PROFILE_DRAW_ICS,
+    PROFILE_FLUSH_BATCH,
+    PROFILE_DRAW_CANVAS_TO_FRAMEBUFFER,
+    PROFILE_SWAP_BUFFERS,
+
+    PROFILE_SECTION_COUNT,
+} ProfileSection;
+
+typedef enum {
+    PROFILE_TEXT_RASTERIZATIONS,
+    PROFILE_TEXTURE_CREATIONS,
+    PROFILE_TILES_RENDERED,
+    PROFILE_DRAW_CALLS,
+
+    PROFILE_COUNTER_COUNT,
+} ProfileCounter;
+
+void init_profiler();
+bool open_profile_trace(char*);
+void close_profile_trace();
+
+void profile_frame_boundary();
+void profile_begin(ProfileSection);
+void profile_end(ProfileSection);
+void profile_count(ProfileCounter);
+
+float profile_frame_ms();
+float profile_frame_percentile(float);
+float profile_section_ms(ProfileSection);
+uint32 profile_counter(ProfileCounter);
+const char* profile_section_name(ProfileSection);
+const char* profile_counter_name(ProfileCounter);
+
+#endif
@@ -0,0 +1,287 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bread_placer.h"
+#include "reload.h"
+
+// NOTE(erick): The text of the IC blocks of a file, one line after the other,
+//  read the same way the parser reads them. Block i is text[starts[i]] up to
+//  text[starts[i + 1]].
+typedef struct {
+    char* text;
+    usize size;
+    usize capacity;
+
+    usize* starts;
+    uint64* hashes;
+    usize count;
+    usize block_capacity;
+} IcsListBlocks;
+
+static void append_line(IcsListBlocks* blocks, char* line) {
+    usize length = strlen(line);
+    if(blocks->size + length + 1 > blocks->capacity) {
+        while(blocks->size + length + 1 > blocks->capacity) {
+            blocks->capacity = blocks->capacity ? blocks->capacity * 2 : 4096;
+        }
+        blocks->text = (char*) realloc(blocks->text, blocks->capacity);
+    }
+
+    memcpy(blocks->text + blocks->size, line, length);
+    blocks->text[blocks->size + length] = '\n';
+    blocks->size += length + 1;
+}
+
+// NOTE(erick): FNV-1a.
+static uint64 hash_bytes(char* bytes, usize count) {
+    uint64 hash = 0xcbf29ce484222325ull;
+    for(usize i = 0; i < count; i++) {
+        hash ^= (uint8) bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+
+    return hash;
+}
+
+static void begin_block(IcsListBlocks* blocks) {
+    // NOTE(erick): One more start than blocks, for the end of the last one.
+    if(blocks->count + 2 > blocks->block_capacity) {
+        blocks->block_capacity = blocks->block_capacity ? blocks->block_capacity * 2 : 64;
+        blocks->starts = (usize*) realloc(blocks->starts,
+                                          blocks->block_capacity * sizeof(usize));
+        blocks->hashes = (uint64*) realloc(blocks->hashes,
+                                           blocks->block_capacity * sizeof(uint64));
+    }
+
+    blocks->starts[blocks->count] = blocks->size;
+}
+
+static void end_block(IcsListBlocks* blocks) {
+    usize start = blocks->starts[blocks->count];
+    blocks->hashes[blocks->count] = hash_bytes(blocks->text + start, blocks->size - start);
+
+    blocks->count++;
+    blocks->starts[blocks->count] = blocks->size;
+}
+
+static void read_blocks(FILE* input_file, IcsListBlocks* blocks) {
+    memset(blocks, 0, sizeof(IcsListBlocks));
+
+    // NOTE(erick): Same line size as read_ic_list_file, so long lines are
+    //  cut the same way.
+    char line[256];
+    bool is_reading_ic = false;
+
+    while(!feof(input_file) && fgets(line, sizeof(line), input_file)) {
+        trim_end(line);
+
+        if(!is_reading_ic) {
+            if(string_begins_with(line, "IC")) {
+                is_reading_ic = true;
+                begin_block(blocks);
+                append_line(blocks, line);
+            }
+        } else if(strlen(line) == 0) {
+            is_reading_ic = false;
+            end_block(blocks);
+        } else {
+            append_line(blocks, line);
+        }
+    }
+
+    if(is_reading_ic) { end_block(blocks); }
+}
+
+static void free_blocks(IcsListBlocks* blocks) {
+    free(blocks->text);
+    free(blocks->starts);
+    free(blocks->hashes);
+    memset(blocks, 0, sizeof(IcsListBlocks));
+}
+
+static bool parse_block(ProjectContext* context, IcsListBlocks* blocks, usize block,
+                        IC* result) {
+    usize start = blocks->starts[block];
+    FILE* block_file = fmemopen(blocks->text + start, blocks->starts[block + 1] - start, "r");
+    if(!block_file) { return false; }
+
+    ICList list;
+    int error = read_ic_list_file(context, block_file, &list);
+    fclose(block_file);
+    if(error) { return false; }
+
+    bool success = list.count == 1;
+    if(success) {
+        *result = list.data[0];
+        list.count = 0;
+    }
+
+    free_ic_list(&list);
+    return success;
+}
+
+bool snapshot_ics_list_file(char* filename, IcsListSnapshot* snapshot) {
+    FILE* input_file = fopen(filename, "r");
+    if(!input_file) { return false; }
+
+    IcsListBlocks blocks;
+    read_blocks(input_file, &blocks);
+    fclose(input_file);
+
+    free(snapshot->hashes);
+    snapshot->hashes = blocks.hashes;
+    snapshot->count = blocks.count;
+    blocks.hashes = NULL;
+
+    free_blocks(&blocks);
+    return true;
+}
+
+// NOTE(erick): Returns whether there is anything to apply. The snapshot is
+//  left alone, the new version goes in the snapshot of the reload. Errors are
+//  reported and the file is left for the next time it changes.
+bool diff_ics_list_file(ProjectContext* context, char* filename,
+                        IcsListSnapshot* snapshot, IcsListReload* reload) {
+    FILE* input_file = fopen(filename, "r");
+    if(!input_file) {
+        context_error(context, 3, "Could not open ics_list file [%s] to reload it.\n",
+                      filename);
+        return false;
+    }
+
+    IcsListBlocks blocks;
+    read_blocks(input_file, &blocks);
+    fclose(input_file);
+
+    usize n_old = snapshot->count;
+    usize n_new = blocks.count;
+
+    usize n_same_before = 0;
+    while(n_same_before < n_old && n_same_before < n_new &&
+          snapshot->hashes[n_same_before] == blocks.hashes[n_same_before]) {
+        n_same_before++;
+    }
+
+    usize n_same_after = 0;
+    while(n_same_after < n_old - n_same_before && n_same_after < n_new - n_same_before &&
+          snapshot->hashes[n_old - 1 - n_same_after] == blocks.hashes[n_new - 1 - n_same_after]) {
+        n_same_after++;
+    }
+
+    if(n_old == n_new && n_same_before == n_new) {
+        free_blocks(&blocks);
+        return false;
+    }
+
+    usize n_changed = n_new - n_same_before - n_same_after;
+    IC* changed = (IC*) malloc((n_changed + 1) * sizeof(IC));
+
+    for(usize i = 0; i < n_changed; i++) {
+        if(!parse_block(context, &blocks, n_same_before + i, changed + i)) {
+            context_message(context, "The ics_list file [%s] has errors."
+                            " It was not reloaded.\n", filename);
+
+            for(usize j = 0; j < i; j++) { free_ic(changed + j); }
+            free(changed);
+            free_blocks(&blocks);
+            return false;
+        }
+    }
+
+    reload->n_old = n_old;
+    reload->n_new = n_new;
+    reload->n_same_before = n_same_before;
+    reload->n_same_after = n_same_after;
+    reload->changed = changed;
+    reload->snapshot.hashes = blocks.hashes;
+    reload->snapshot.count = n_new;
+    blocks.hashes = NULL;
+
+    free_blocks(&blocks);
+    return true;
+}
+
+// NOTE(erick): Whether the IC at that index of the old list is replaced or
+//  dropped.
+bool reload_changes_old_ic(IcsListReload* reload, usize old_index) {
+    return old_index >= reload->n_same_before &&
+        old_index < reload->n_old - reload->n_same_after;
+}
+
+// NOTE(erick): new_index gets, for every IC of the old list, its index on the
+//  new one or RELOAD_DROPPED. The ICs that did not change keep their memory,
+//  so their strings stay valid. When there are as many ICs as before the
+//  changed ones are replaced in place and the array is kept, so pointers to
+//  the ICs stay valid as well.
+bool apply_ics_list_reload(ICList* list, IcsListReload* reload, uint32* new_index) {
+    if(list->count != reload->n_old || !reload->changed) { return false; }
+
+    usize n_same_before = reload->n_same_before;
+    usize n_same_after = reload->n_same_after;
+    usize n_changed = reload->n_new - n_same_before - n_same_after;
+    usize n_old_changed = reload->n_old - n_same_before - n_same_after;
+
+    bool in_place = reload->n_new == reload->n_old;
+    IC* data = in_place ? list->data : (IC*) malloc((reload->n_new + 1) * sizeof(IC));
+
+    for(usize i = 0; i < n_same_before; i++) {
+        data[i] = list->data[i];
+        new_index[i] = i;
+    }
+
+    for(usize i = 0; i < n_changed; i++) {
+        IC* ic = reload->changed + i;
+
+        if(i < n_old_changed) {
+            IC* old_ic = list->data + n_same_before + i;
+            if(old_ic->n_pins == ic->n_pins) { ic->location = old_ic->location; }
+
+            new_index[n_same_before + i] = n_same_before + i;
+            free_ic(old_ic);
+        }
+
+        data[n_same_before + i] = *ic;
+    }
+
+    for(usize i = n_changed; i < n_old_changed; i++) {
+        free_ic(list->data + n_same_before + i);
+        new_index[n_same_before + i] = RELOAD_DROPPED;
+    }
+
+    for(usize i = 0; i < n_same_after; i++) {
+        data[reload->n_new - n_same_after + i] = list->data[reload->n_old - n_same_after + i];
+        new_index[reload->n_old - n_same_after + i] = reload->n_new - n_same_after + i;
+    }
+
+    if(!in_place) {
+        free(list->data);
+        list->data = data;
+        list->count = reload->n_new;
+        list->capacity = reload->n_new + 1;
+    }
+
+    // NOTE(erick): The parsed ICs belong to the list now. Their ids were
+    //  worked out without the rest of the list.
+    free(reload->changed);
+    reload->changed = NULL;
+
+    assign_ic_ids(list);
+    return true;
+}
+
+void free_ics_list_reload(IcsListReload* reload) {
+    if(reload->changed) {
+        usize n_changed = reload->n_new - reload->n_same_before - reload->n_same_after;
+        for(usize i = 0; i < n_changed; i++) { free_ic(reload->changed + i); }
+        free(reload->changed);
+    }
+
+    free_ics_list_snapshot(&reload->snapshot);
+    memset(reload, 0, sizeof(IcsListReload));
+}
+
+void free_ics_list_snapshot(IcsListSnapshot* snapshot) {
+    free(snapshot->hashes);
+    memset(snapshot, 0, sizeof(IcsListSnapshot));
+}
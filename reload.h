@@ -0,0 +1,45 @@
+#ifndef RELOAD_H
+#define RELOAD_H 1
+
+#include "ICs.h"
+#include "context.h"
+
+// NOTE(erick): Reloading of the ics_list file while the program runs. The
+//  file is split into the blocks of its ICs and every block is hashed. A new
+//  version is lined up with the last one by the blocks that did not change at
+//  its beginning and at its end, and only the blocks in between are parsed.
+//  Those replace the old ICs in between one for one, keeping their locations
+//  when the number of pins is the same. Extra new ICs start outside and extra
+//  old ones are dropped. An edit of one label parses one block.
+
+#define RELOAD_DROPPED UINT32_MAX
+
+typedef struct {
+    uint64* hashes;
+    usize count;
+} IcsListSnapshot;
+
+typedef struct {
+    usize n_old;
+    usize n_new;
+
+    // NOTE(erick): The first n_same_before and the last n_same_after ICs did
+    //  not change. The n_new - n_same_before - n_same_after in between are
+    //  parsed again.
+    usize n_same_before;
+    usize n_same_after;
+    IC* changed;
+
+    // NOTE(erick): The version of the file the reload leads to. Whoever
+    //  applies the reload takes it as the one to diff against next.
+    IcsListSnapshot snapshot;
+} IcsListReload;
+
+bool snapshot_ics_list_file(char*, IcsListSnapshot*);
+bool diff_ics_list_file(ProjectContext*, char*, IcsListSnapshot*, IcsListReload*);
+bool reload_changes_old_ic(IcsListReload*, usize);
+bool apply_ics_list_reload(ICList*, IcsListReload*, uint32*);
+void free_ics_list_reload(IcsListReload*);
+void free_ics_list_snapshot(IcsListSnapshot*);
+
+#endif
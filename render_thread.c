@@ -0,0 +1,348 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "render_thread.h"
+#include "profiler.h"
+
+void init_render_thread(RenderThread* render, DrawData* dd, FramePacer pacer) {
+    memset(render, 0, sizeof(RenderThread));
+
+    render->dd = *dd;
+    render->pacer = pacer;
+
+    render->reading = 0;
+    render->latest = 1;
+    render->writing = 2;
+}
+
+static IC* snapshot_ic(FrameSnapshot* snapshot, ICList ic_list, IC* ic) {
+    if(!ic) { return NULL; }
+
+    return snapshot->ics + (ic - ic_list.data);
+}
+
+static void copy_drc_violations(FrameSnapshot* snapshot, DrcState* drc) {
+    snapshot->drc.n_violations = drc->n_violations;
+    if(!drc->n_violations) { return; }
+
+    for(uint column = 0; column < DRC_COLUMNS; column++) {
+        for(uint row = 0; row < DRC_ROWS; row++) {
+            for(uint side = DRC_LEFT; side <= DRC_RIGHT; side++) {
+                snapshot->drc.strips[column][row][side].violation =
+                    drc->strips[column][row][side].violation;
+            }
+        }
+    }
+}
+
+static void copy_net_highlight(FrameSnapshot* snapshot, ICList ic_list,
+                               NetHighlight* net_highlight) {
+    snapshot->net_highlight = *net_highlight;
+    snapshot->net_highlight.ic = snapshot_ic(snapshot, ic_list, net_highlight->ic);
+
+    Net* net = net_highlight->net;
+    if(!net) { return; }
+
+    if(net->n_pins > snapshot->net_pins_capacity) {
+        snapshot->net_pins_capacity = net->n_pins;
+        snapshot->net_pins = (NetPin*) realloc(snapshot->net_pins,
+                                               net->n_pins * sizeof(NetPin));
+    }
+
+    for(uint i = 0; i < net->n_pins; i++) {
+        snapshot->net_pins[i].ic = snapshot_ic(snapshot, ic_list, net->pins[i].ic);
+        snapshot->net_pins[i].pin_index = net->pins[i].pin_index;
+    }
+
+    snapshot->net = *net;
+    snapshot->net.pins = snapshot->net_pins;
+    snapshot->net_highlight.net = &snapshot->net;
+}
+
+static void copy_view(FrameSnapshot* snapshot, DrawData* dd, ICList ic_list) {
+    snapshot->zoom = dd->zoom;
+    snapshot->zoom_origin = dd->zoom_origin;
+    snapshot->display_debug_info = dd->display_debug_info;
+
+    snapshot->is_selecting_outside_ic = dd->is_selecting_outside_ic;
+    snapshot->n_outside_matches = 0;
+    if(!dd->is_selecting_outside_ic) { return; }
+
+    snapshot->outside_ic_selected = dd->outside_ic_selected;
+    memcpy(snapshot->outside_query, dd->outside_query, SEARCH_MAX_QUERY);
+
+    if(dd->n_outside_matches > snapshot->matches_capacity) {
+        snapshot->matches_capacity = dd->n_outside_matches;
+        snapshot->outside_matches = (uint32*) realloc(snapshot->outside_matches,
+                                                      dd->n_outside_matches * sizeof(uint32));
+    }
+    memcpy(snapshot->outside_matches, dd->outside_matches,
+           dd->n_outside_matches * sizeof(uint32));
+    snapshot->n_outside_matches = dd->n_outside_matches;
+
+    snapshot->slot_suggestions = dd->slot_suggestions;
+    snapshot->slot_suggestions.ic = snapshot_ic(snapshot, ic_list, dd->slot_suggestions.ic);
+}
+
+// NOTE(erick): Called by the main thread only. The snapshot being written is
+//  its own until it is published, whatever the render thread is doing.
+void publish_snapshot(RenderThread* render, DrawData* dd, ICList ic_list,
+                      Selection* selection, DrcState* drc,
+                      NetHighlight* net_highlight) {
+    FrameSnapshot* snapshot = render->snapshots + render->writing;
+
+    if(ic_list.count > snapshot->ics_capacity) {
+        snapshot->ics_capacity = ic_list.count;
+        snapshot->ics = (IC*) realloc(snapshot->ics, ic_list.count * sizeof(IC));
+    }
+    memcpy(snapshot->ics, ic_list.data, ic_list.count * sizeof(IC));
+    snapshot->n_ics = ic_list.count;
+
+    ICGroup* group = &selection->group;
+    if(group->count > snapshot->group_capacity) {
+        snapshot->group_capacity = group->count;
+        snapshot->group_ics = (IC**) realloc(snapshot->group_ics,
+                                             group->count * sizeof(IC*));
+    }
+    for(usize i = 0; i < group->count; i++) {
+        snapshot->group_ics[i] = snapshot_ic(snapshot, ic_list, group->ics[i]);
+    }
+
+    snapshot->selection = *selection;
+    snapshot->selection.selected_ic = snapshot_ic(snapshot, ic_list, selection->selected_ic);
+    snapshot->selection.group.ics = snapshot->group_ics;
+    snapshot->selection.group.capacity = snapshot->group_capacity;
+
+    copy_drc_violations(snapshot, drc);
+    copy_net_highlight(snapshot, ic_list, net_highlight);
+    copy_view(snapshot, dd, ic_list);
+
+    uint previous = __atomic_exchange_n(&render->latest, render->writing | SNAPSHOT_FRESH,
+                                        __ATOMIC_ACQ_REL);
+    render->writing = previous & SNAPSHOT_INDEX;
+
+    if(render->is_threaded) { sem_post(&render->published); }
+}
+
+// NOTE(erick): NULL when nothing was published since the last one was taken.
+static FrameSnapshot* take_latest_snapshot(RenderThread* render) {
+    if(!(__atomic_load_n(&render->latest, __ATOMIC_ACQUIRE) & SNAPSHOT_FRESH)) {
+        return NULL;
+    }
+
+    // NOTE(erick): Only the main thread changes latest in between, and it can
+    //  only make it fresh again.
+    uint previous = __atomic_exchange_n(&render->latest, render->reading,
+                                        __ATOMIC_ACQ_REL);
+    render->reading = previous & SNAPSHOT_INDEX;
+    render->has_snapshot = true;
+
+    return render->snapshots + render->reading;
+}
+
+static bool same_drawing(IC* a, IC* b) {
+    return a->location.column == b->location.column &&
+        a->location.row == b->location.row &&
+        a->location.orientation == b->location.orientation &&
+        a->n_pins == b->n_pins && a->pins == b->pins &&
+        a->name == b->name && a->code == b->code;
+}
+
+// NOTE(erick): Snapshots may be skipped, so the tiles are made stale by
+//  comparing with the last snapshot drawn instead of following the journal.
+//  A reload gives the ICs it changes new strings and pins, which makes them
+//  differ too.
+static void invalidate_changed_ics(RenderThread* render, FrameSnapshot* snapshot) {
+    DrawData* dd = &render->dd;
+
+    if(snapshot->n_ics > render->drawn_capacity) {
+        render->drawn_capacity = snapshot->n_ics;
+        render->drawn = (IC*) realloc(render->drawn, snapshot->n_ics * sizeof(IC));
+        render->drawn_footprints = (SDL_Rect*) realloc(render->drawn_footprints,
+                                                       snapshot->n_ics * sizeof(SDL_Rect));
+    }
+
+    for(usize ic_index = 0; ic_index < render->n_drawn || ic_index < snapshot->n_ics;
+        ic_index++) {
+        bool was_drawn = ic_index < render->n_drawn;
+        IC* ic = ic_index < snapshot->n_ics ? snapshot->ics + ic_index : NULL;
+
+        if(was_drawn && ic && same_drawing(render->drawn + ic_index, ic)) { continue; }
+
+        if(was_drawn) { invalidate_footprint(dd, render->drawn_footprints[ic_index]); }
+        if(ic) {
+            SDL_Rect footprint = footprint_of_ic(dd, ic);
+            invalidate_footprint(dd, footprint);
+
+            render->drawn[ic_index] = *ic;
+            render->drawn_footprints[ic_index] = footprint;
+        }
+    }
+    render->n_drawn = snapshot->n_ics;
+}
+
+static void draw_snapshot(RenderThread* render, FrameSnapshot* snapshot) {
+    DrawData* dd = &render->dd;
+
+    profile_frame_boundary();
+    dd->dt = profile_frame_ms() / 1000.0;
+
+    invalidate_changed_ics(render, snapshot);
+
+    dd->zoom = snapshot->zoom;
+    dd->zoom_origin = snapshot->zoom_origin;
+    dd->display_debug_info = snapshot->display_debug_info;
+    dd->is_selecting_outside_ic = snapshot->is_selecting_outside_ic;
+    dd->outside_ic_selected = snapshot->outside_ic_selected;
+    memcpy(dd->outside_query, snapshot->outside_query, SEARCH_MAX_QUERY);
+    dd->outside_matches = snapshot->outside_matches;
+    dd->n_outside_matches = snapshot->n_outside_matches;
+    dd->slot_suggestions = snapshot->slot_suggestions;
+
+    ICList ic_list = {.data = snapshot->ics, .count = snapshot->n_ics};
+
+    // NOTE(erick): Profiled per tile, inside.
+    update_canvas_tiles(dd, ic_list);
+
+    profile_begin(PROFILE_DRAW_CANVAS_TO_FRAMEBUFFER);
+    draw_canvas_to_framebuffer(dd);
+    profile_end(PROFILE_DRAW_CANVAS_TO_FRAMEBUFFER);
+
+    draw_selection(dd, snapshot->selection);
+    draw_group(dd, &snapshot->selection);
+    draw_drc_violations(dd, &snapshot->drc);
+    draw_net_highlight(dd, &snapshot->net_highlight);
+
+    if(dd->is_selecting_outside_ic) {
+        draw_slot_suggestions(dd);
+        draw_outside_ics_list(dd, ic_list);
+    }
+
+    if(dd->display_debug_info) {
+        draw_debug_info(dd);
+    }
+
+    draw_outside_ics_count(dd, ic_list);
+
+    profile_begin(PROFILE_SWAP_BUFFERS);
+    swap_buffers(dd);
+    profile_end(PROFILE_SWAP_BUFFERS);
+}
+
+// NOTE(erick): For drawing on the calling thread. Without anything new, the
+//  last snapshot is drawn again.
+void render_latest_snapshot(RenderThread* render) {
+    take_latest_snapshot(render);
+    if(!render->has_snapshot) { return; }
+
+    draw_snapshot(render, render->snapshots + render->reading);
+}
+
+static void wait_while_paused(RenderThread* render) {
+    pthread_mutex_lock(&render->lock);
+
+    render->is_paused = true;
+    pthread_cond_broadcast(&render->pause_changed);
+    while(render->pause_requested) {
+        pthread_cond_wait(&render->pause_changed, &render->lock);
+    }
+    render->is_paused = false;
+
+    pthread_mutex_unlock(&render->lock);
+}
+
+static void* render_loop(void* data) {
+    RenderThread* render = (RenderThread*) data;
+
+    // NOTE(erick): The renderer is made here, since it may only be used from
+    //  the thread it was made on.
+    init_SDL_renderer(&render->dd);
+
+    while(true) {
+        // NOTE(erick): On demand, nothing is drawn until something changes. The
+        //  other policies draw every frame once there is something to draw.
+        bool on_demand = render->pacer.policy == FRAME_POLICY_ON_DEMAND;
+        if(on_demand || !render->has_snapshot) {
+            while(sem_wait(&render->published) != 0 && errno == EINTR) { }
+        }
+        while(sem_trywait(&render->published) == 0) { }
+
+        if(__atomic_load_n(&render->quit, __ATOMIC_ACQUIRE)) { break; }
+
+        // NOTE(erick): Read before taking the snapshot, so whatever was
+        //  published before the pause was asked for is drawn before pausing.
+        bool pausing = __atomic_load_n(&render->pause_requested, __ATOMIC_ACQUIRE);
+
+        FrameSnapshot* snapshot = take_latest_snapshot(render);
+        if(snapshot || (!on_demand && render->has_snapshot)) {
+            draw_snapshot(render, render->snapshots + render->reading);
+            wait_for_next_frame(&render->pacer);
+        }
+
+        if(pausing) { wait_while_paused(render); }
+    }
+
+    draw_saving_screen(&render->dd);
+    swap_buffers(&render->dd);
+
+    return NULL;
+}
+
+bool start_render_thread(RenderThread* render) {
+    if(sem_init(&render->published, 0, 0) != 0) { return false; }
+    pthread_mutex_init(&render->lock, NULL);
+    pthread_cond_init(&render->pause_changed, NULL);
+
+    render->is_threaded = true;
+    if(pthread_create(&render->thread, NULL, render_loop, render) != 0) {
+        render->is_threaded = false;
+        sem_destroy(&render->published);
+        pthread_mutex_destroy(&render->lock);
+        pthread_cond_destroy(&render->pause_changed);
+        return false;
+    }
+
+    return true;
+}
+
+// NOTE(erick): Leaves "Saving..." on the screen. Afterwards the DrawData of the
+//  render thread may be used for printing, which never touches the renderer.
+void stop_render_thread(RenderThread* render) {
+    if(!render->is_threaded) {
+        draw_saving_screen(&render->dd);
+        swap_buffers(&render->dd);
+        return;
+    }
+
+    __atomic_store_n(&render->quit, true, __ATOMIC_RELEASE);
+    sem_post(&render->published);
+    pthread_join(render->thread, NULL);
+
+    render->is_threaded = false;
+}
+
+// NOTE(erick): Returns once the render thread drew everything published so far
+//  and is waiting. Until the resume it touches nothing of the list.
+void pause_render_thread(RenderThread* render) {
+    if(!render->is_threaded) { return; }
+
+    pthread_mutex_lock(&render->lock);
+    __atomic_store_n(&render->pause_requested, true, __ATOMIC_RELEASE);
+    sem_post(&render->published);
+
+    while(!render->is_paused) {
+        pthread_cond_wait(&render->pause_changed, &render->lock);
+    }
+    pthread_mutex_unlock(&render->lock);
+}
+
+void resume_render_thread(RenderThread* render) {
+    if(!render->is_threaded) { return; }
+
+    pthread_mutex_lock(&render->lock);
+    __atomic_store_n(&render->pause_requested, false, __ATOMIC_RELEASE);
+    pthread_cond_broadcast(&render->pause_changed);
+    pthread_mutex_unlock(&render->lock);
+}
@@ -0,0 +1,104 @@
+#ifndef RENDER_THREAD_H
+#define RENDER_THREAD_H 1
+
+#include <pthread.h>
+#include <semaphore.h>
+
+#include "ICs.h"
+#include "draw.h"
+#include "drc.h"
+#include "nets.h"
+#include "pacing.h"
+
+// NOTE(erick): Drawing on a thread of its own. The main thread handles the
+//  input and owns the model. Whenever something changed it copies what the
+//  frame shows into a FrameSnapshot and publishes it, and the render thread
+//  draws the newest one it finds, skipping the ones it was too slow for. A slow
+//  frame never holds the input back.
+//
+// There are three snapshots: the one being drawn, the one published and the
+//  one being written. Publishing swaps the written one with the published one
+//  and taking the newest swaps the published one with the drawn one, each with
+//  a single atomic exchange, so neither side ever waits for the other.
+//
+// The snapshots have their own copies of the ICs, but the strings and pins are
+//  still the list's. Only a reload frees those, so it pauses the render thread
+//  while it runs.
+
+#define SNAPSHOT_INDEX 3
+// NOTE(erick): Set while the published snapshot was not taken yet.
+#define SNAPSHOT_FRESH 4
+
+typedef struct {
+    // NOTE(erick): Everything below points into ics, not into the list.
+    IC* ics;
+    usize n_ics;
+    usize ics_capacity;
+
+    Selection selection;
+    IC** group_ics;
+    usize group_capacity;
+
+    // NOTE(erick): Only the violations of the strips, not their pins.
+    DrcState drc;
+
+    NetHighlight net_highlight;
+    Net net;
+    NetPin* net_pins;
+    uint net_pins_capacity;
+
+    // NOTE(erick): The view and the outside IC picker, as in DrawData.
+    float zoom;
+    Vec2 zoom_origin;
+    bool display_debug_info;
+    bool is_selecting_outside_ic;
+    uint outside_ic_selected;
+    char outside_query[SEARCH_MAX_QUERY];
+    uint32* outside_matches;
+    uint n_outside_matches;
+    uint matches_capacity;
+    SlotSuggestions slot_suggestions;
+} FrameSnapshot;
+
+typedef struct {
+    FrameSnapshot snapshots[3];
+    // NOTE(erick): writing belongs to the main thread, reading to the one that
+    //  draws. latest is the published one, shared between them.
+    uint writing;
+    uint reading;
+    uint latest;
+    bool has_snapshot;
+
+    // NOTE(erick): Only the thread that draws touches these. drawn is the ICs
+    //  of the last snapshot drawn, to know which tiles are stale, and
+    //  drawn_footprints what they covered. Their strings may be gone after a
+    //  reload, so they are never measured again.
+    DrawData dd;
+    IC* drawn;
+    SDL_Rect* drawn_footprints;
+    usize n_drawn;
+    usize drawn_capacity;
+    FramePacer pacer;
+
+    bool is_threaded;
+    pthread_t thread;
+    sem_t published;
+
+    pthread_mutex_t lock;
+    pthread_cond_t pause_changed;
+    bool pause_requested;
+    bool is_paused;
+    bool quit;
+} RenderThread;
+
+void init_render_thread(RenderThread*, DrawData*, FramePacer);
+bool start_render_thread(RenderThread*);
+void stop_render_thread(RenderThread*);
+void pause_render_thread(RenderThread*);
+void resume_render_thread(RenderThread*);
+
+void publish_snapshot(RenderThread*, DrawData*, ICList, Selection*, DrcState*,
+                      NetHighlight*);
+void render_latest_snapshot(RenderThread*);
+
+#endif
@@ -0,0 +1,160 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "replay.h"
+
+FILE* open_recording(char* filename) {
+    FILE* result = fopen(filename, "w");
+    if(!result) { return NULL; }
+
+    fprintf(result, "# bread_placer input recording\n");
+    fprintf(result, "# <time_ms> <down|up> <keycode> <modifiers>\n");
+
+    return result;
+}
+
+// NOTE(erick): Events are written as they happen so a crash still leaves a
+//  usable recording behind.
+void record_key_event(FILE* file, uint32 time_ms, bool pressed, int32 key,
+                      uint16 modifiers) {
+    if(!file) { return; }
+
+    fprintf(file, "%u %s %d %u\n", time_ms, pressed ? "down" : "up", key, modifiers);
+    fflush(file);
+}
+
+void close_recording(FILE* file) {
+    if(file) { fclose(file); }
+}
+
+static void add_recorded_event(InputRecording* recording, RecordedEvent event) {
+    if(recording->count == recording->capacity) {
+        recording->capacity = recording->capacity ? recording->capacity * 2 : 64;
+        recording->events = realloc(recording->events,
+                                    recording->capacity * sizeof(RecordedEvent));
+    }
+
+    recording->events[recording->count] = event;
+    recording->count++;
+}
+
+bool load_recording(char* filename, InputRecording* recording) {
+    FILE* file = fopen(filename, "r");
+    if(!file) {
+        fprintf(stderr, "Could not open recording [%s].\n", filename);
+        return false;
+    }
+
+    memset(recording, 0, sizeof(InputRecording));
+
+    uint line_number = 0;
+    char line[256];
+    while(fgets(line, sizeof(line), file)) {
+        line_number++;
+        if(line[0] == '#' || line[0] == '\n') { continue; }
+
+        uint time_ms;
+        char direction[8];
+        int key;
+        uint modifiers;
+
+        int read = sscanf(line, "%u %7s %d %u", &time_ms, direction, &key, &modifiers);
+        if(read != 4 ||
+           (strcmp(direction, "down") != 0 && strcmp(direction, "up") != 0)) {
+            fprintf(stderr, "Invalid line (%d) in recording [%s].\n",
+                    line_number, filename);
+            fclose(file);
+            return false;
+        }
+
+        RecordedEvent event = {.time_ms = time_ms,
+                               .pressed = strcmp(direction, "down") == 0,
+                               .key = key,
+                               .modifiers = (uint16) modifiers};
+        add_recorded_event(recording, event);
+    }
+
+    fclose(file);
+    return true;
+}
+
+// NOTE(erick): Returns the next event whose time is not after now_ms, or NULL.
+//  Pass UINT32_MAX to get events regardless of their time.
+RecordedEvent* next_due_event(InputRecording* recording, uint32 now_ms) {
+    if(recording->next_event == recording->count) { return NULL; }
+
+    RecordedEvent* result = recording->events + recording->next_event;
+    if(result->time_ms > now_ms) { return NULL; }
+
+    recording->next_event++;
+    return result;
+}
+
+bool next_event_time(InputRecording* recording, uint32* time_ms) {
+    if(recording->next_event == recording->count) { return false; }
+
+    *time_ms = recording->events[recording->next_event].time_ms;
+    return true;
+}
+
+bool replay_finished(InputRecording* recording) {
+    return recording->next_event == recording->count;
+}
+
+void add_frame_time(FrameTimes* times, float frame_ms) {
+    if(times->count == times->capacity) {
+        times->capacity = times->capacity ? times->capacity * 2 : 1024;
+        times->frame_ms = realloc(times->frame_ms, times->capacity * sizeof(float));
+    }
+
+    times->frame_ms[times->count] = frame_ms;
+    times->count++;
+}
+
+static int compare_floats(const void* a, const void* b) {
+    float fa = *(const float*) a;
+    float fb = *(const float*) b;
+
+    return (fa > fb) - (fa < fb);
+}
+
+void print_replay_report(FILE* file, FrameTimes* times, double total_seconds) {
+    float p50 = 0.0f;
+    float p99 = 0.0f;
+    float max = 0.0f;
+    double mean = 0.0;
+
+    if(times->count) {
+        float* sorted = (float*) malloc(times->count * sizeof(float));
+        memcpy(sorted, times->frame_ms, times->count * sizeof(float));
+        qsort(sorted, times->count, sizeof(float), compare_floats);
+
+        for(usize i = 0; i < times->count; i++) { mean += sorted[i]; }
+        mean /= times->count;
+
+        p50 = sorted[(usize) (0.50 * (times->count - 1) + 0.5)];
+        p99 = sorted[(usize) (0.99 * (times->count - 1) + 0.5)];
+        max = sorted[times->count - 1];
+
+        free(sorted);
+    }
+
+    fprintf(file, "{\"replay\":{\"frames\":%zu,\"total_seconds\":%.6f,"
+            "\"mean_frame_ms\":%.4f,\"p50_frame_ms\":%.4f,"
+            "\"p99_frame_ms\":%.4f,\"max_frame_ms\":%.4f}}\n",
+            times->count, total_seconds, mean, p50, p99, max);
+}
+
+bool write_frame_times(char* filename, FrameTimes* times) {
+    FILE* file = fopen(filename, "w");
+    if(!file) { return false; }
+
+    fprintf(file, "frame,ms\n");
+    for(usize i = 0; i < times->count; i++) {
+        fprintf(file, "%zu,%.4f\n", i, times->frame_ms[i]);
+    }
+
+    fclose(file);
+    return true;
+}
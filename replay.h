@@ -0,0 +1,46 @@
+#ifndef REPLAY_H
+#define REPLAY_H 1
+
+#include <stdio.h>
+
+#include "ICs.h"
+
+// NOTE(erick): A recording is a text file with one key event per line:
+//      <milliseconds since start> <down|up> <keycode> <modifiers>
+//  Lines starting with '#' are comments.
+
+typedef struct {
+    uint32 time_ms;
+    bool pressed;
+    int32 key;
+    uint16 modifiers;
+} RecordedEvent;
+
+typedef struct {
+    RecordedEvent* events;
+    usize count;
+    usize capacity;
+
+    usize next_event;
+} InputRecording;
+
+typedef struct {
+    float* frame_ms;
+    usize count;
+    usize capacity;
+} FrameTimes;
+
+FILE* open_recording(char*);
+void record_key_event(FILE*, uint32, bool, int32, uint16);
+void close_recording(FILE*);
+
+bool load_recording(char*, InputRecording*);
+RecordedEvent* next_due_event(InputRecording*, uint32);
+bool next_event_time(InputRecording*, uint32*);
+bool replay_finished(InputRecording*);
+
+void add_frame_time(FrameTimes*, float);
+void print_replay_report(FILE*, FrameTimes*, double);
+bool write_frame_times(char*, FrameTimes*);
+
+#endif
@@ -0,0 +1,209 @@
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include "router.h"
+
+int strip_x(StripLocation strip) {
+    int x = (strip.column - 1) * ROUTER_COLUMN_HOLES;
+    return strip.side == DRC_LEFT ? x - 1 : x + 4;
+}
+
+int rail_x(uint column, PinType type) {
+    StripLocation strip = {.column = column, .row = 1,
+                           .side = type == VCC ? DRC_LEFT : DRC_RIGHT};
+    int x = strip_x(strip);
+
+    return type == VCC ? x - ROUTER_RAIL_HOLES : x + ROUTER_RAIL_HOLES;
+}
+
+uint strip_distance(StripLocation a, StripLocation b) {
+    int dx = strip_x(a) - strip_x(b);
+    int dy = (int) a.row - (int) b.row;
+
+    return abs(dx) + abs(dy);
+}
+
+uint jumper_length_mm(uint span) {
+    // NOTE(erick): Rounded up, a short jumper can still be bent to fit.
+    uint span_mm = (span * ROUTER_HOLE_PITCH_UM + 999) / 1000;
+    return span_mm + 2 * ROUTER_LEAD_MM;
+}
+
+static bool same_strip(StripLocation a, StripLocation b) {
+    return a.column == b.column && a.row == b.row && a.side == b.side;
+}
+
+static void add_jumper(JumperList* list, Jumper jumper) {
+    if(list->count == list->capacity) {
+        list->capacity = list->capacity ? list->capacity * 2 : 64;
+        list->jumpers = (Jumper*) realloc(list->jumpers,
+                                          list->capacity * sizeof(Jumper));
+    }
+
+    list->jumpers[list->count++] = jumper;
+}
+
+// NOTE(erick): Prim's algorithm on the complete graph of the strips. Nets are
+//  small, so the O(n^2) version with no heap is the fast one.
+static void route_net(JumperList* list, char* label, StripLocation* strips,
+                      uint n_strips, uint* best_distance, uint* best_from) {
+    if(n_strips < 2) { return; }
+
+    for(uint i = 1; i < n_strips; i++) {
+        best_distance[i] = strip_distance(strips[0], strips[i]);
+        best_from[i] = 0;
+    }
+
+    // NOTE(erick): A strip is in the tree when its distance is UINT_MAX.
+    best_distance[0] = UINT_MAX;
+
+    for(uint added = 1; added < n_strips; added++) {
+        uint next = 0;
+        uint next_distance = UINT_MAX;
+        for(uint i = 1; i < n_strips; i++) {
+            if(best_distance[i] < next_distance) {
+                next = i;
+                next_distance = best_distance[i];
+            }
+        }
+
+        Jumper jumper = {.label = label,
+                         .from = strips[best_from[next]],
+                         .to = strips[next],
+                         .span = next_distance,
+                         .length_mm = jumper_length_mm(next_distance)};
+        add_jumper(list, jumper);
+
+        best_distance[next] = UINT_MAX;
+        for(uint i = 1; i < n_strips; i++) {
+            if(best_distance[i] == UINT_MAX) { continue; }
+
+            uint distance = strip_distance(strips[next], strips[i]);
+            if(distance < best_distance[i]) {
+                best_distance[i] = distance;
+                best_from[i] = next;
+            }
+        }
+    }
+}
+
+JumperList route_jumpers(ICList ic_list) {
+    JumperList result = {};
+    NetList nets = build_net_list(ic_list);
+
+    StripLocation* strips = (StripLocation*) malloc((nets.n_pins + 1) * sizeof(StripLocation));
+    uint* best_distance = (uint*) malloc((nets.n_pins + 1) * sizeof(uint));
+    uint* best_from = (uint*) malloc((nets.n_pins + 1) * sizeof(uint));
+
+    for(usize net_index = 0; net_index < nets.count; net_index++) {
+        Net* net = nets.nets + net_index;
+
+        uint n_strips = 0;
+        for(uint i = 0; i < net->n_pins; i++) {
+            IC* ic = net->pins[i].ic;
+
+            StripLocation strip = {.column = ic->location.column};
+            if(!pin_strip(ic, ic->location, net->pins[i].pin_index,
+                          &strip.row, &strip.side)) {
+                result.n_unplaced_pins++;
+                continue;
+            }
+
+            // NOTE(erick): Pins sharing a strip are a DRC matter, here they
+            //  only need one end of a wire.
+            bool is_new = true;
+            for(uint j = 0; j < n_strips; j++) {
+                if(same_strip(strips[j], strip)) {
+                    is_new = false;
+                    break;
+                }
+            }
+
+            if(is_new) { strips[n_strips++] = strip; }
+        }
+
+        if(n_strips >= 2) {
+            route_net(&result, net->label, strips, n_strips, best_distance, best_from);
+            result.n_nets++;
+        }
+    }
+
+    free(best_from);
+    free(best_distance);
+    free(strips);
+    free_net_list(&nets);
+
+    return result;
+}
+
+void free_jumpers(JumperList* list) {
+    free(list->jumpers);
+    memset(list, 0, sizeof(JumperList));
+}
+
+// NOTE(erick): Short jumpers go in first so they lie flat under the long
+//  ones. Ties go top to bottom, left to right.
+static int compare_assembly_order(const void* a, const void* b) {
+    Jumper* jumper_a = (Jumper*) a;
+    Jumper* jumper_b = (Jumper*) b;
+
+    if(jumper_a->span != jumper_b->span) {
+        return jumper_a->span < jumper_b->span ? -1 : 1;
+    }
+
+    uint row_a = jumper_a->from.row < jumper_a->to.row ? jumper_a->from.row : jumper_a->to.row;
+    uint row_b = jumper_b->from.row < jumper_b->to.row ? jumper_b->from.row : jumper_b->to.row;
+    if(row_a != row_b) { return row_a < row_b ? -1 : 1; }
+
+    if(jumper_a->from.column != jumper_b->from.column) {
+        return jumper_a->from.column < jumper_b->from.column ? -1 : 1;
+    }
+
+    return strcmp(jumper_a->label, jumper_b->label);
+}
+
+static const char* side_name(DrcSide side) {
+    return side == DRC_LEFT ? "left" : "right";
+}
+
+void print_assembly_order(FILE* output, JumperList* list) {
+    qsort(list->jumpers, list->count, sizeof(Jumper), compare_assembly_order);
+
+    fprintf(output, "Assembly order:\n");
+    for(usize i = 0; i < list->count; i++) {
+        Jumper* jumper = list->jumpers + i;
+        fprintf(output, "%4zu. %3u holes %4u mm  %-12s column %u row %2u %-5s -> "
+                "column %u row %2u %s\n",
+                i + 1, jumper->span, jumper->length_mm, jumper->label,
+                jumper->from.column, jumper->from.row, side_name(jumper->from.side),
+                jumper->to.column, jumper->to.row, side_name(jumper->to.side));
+    }
+}
+
+// NOTE(erick): The jumpers are in assembly order, so equal lengths are
+//  already together.
+void print_cut_list(FILE* output, JumperList* list) {
+    qsort(list->jumpers, list->count, sizeof(Jumper), compare_assembly_order);
+
+    uint total_mm = 0;
+    fprintf(output, "Cut list:\n");
+    for(usize i = 0; i < list->count; ) {
+        uint length_mm = list->jumpers[i].length_mm;
+        uint count = 0;
+        while(i < list->count && list->jumpers[i].length_mm == length_mm) {
+            count++;
+            i++;
+        }
+
+        fprintf(output, "%4u x %4u mm\n", count, length_mm);
+        total_mm += count * length_mm;
+    }
+
+    fprintf(output, "%zu jumpers on %u nets, %u mm of wire.\n",
+            list->count, list->n_nets, total_mm);
+    if(list->n_unplaced_pins) {
+        fprintf(output, "%u pins are on ICs outside the board and were not routed.\n",
+                list->n_unplaced_pins);
+    }
+}
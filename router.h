@@ -0,0 +1,65 @@
+#ifndef ROUTER_H
+#define ROUTER_H 1
+
+#include <stdio.h>
+
+#include "ICs.h"
+#include "drc.h"
+#include "nets.h"
+
+// NOTE(erick): Jumper wires between strips. Pins of a net on the same strip
+//  are already connected, so every net is reduced to its strips and those are
+//  joined by a minimum spanning tree. Distances are in holes (0.1") along the
+//  board, Manhattan since jumpers are laid flat.
+//
+// The board is modelled as 5-hole strips on each side of a 3-hole channel,
+//  with the IC pins on the holes next to the channel. A jumper uses a free
+//  hole, so crossing the channel takes 5 holes. Columns are ROUTER_COLUMN_HOLES
+//  apart.
+
+#define ROUTER_COLUMN_HOLES 14
+// NOTE(erick): Every column has its VCC rail past the outer end of the left
+//  strips and its GND rail past the outer end of the right ones.
+#define ROUTER_RAIL_HOLES 5
+#define ROUTER_HOLE_PITCH_UM 2540
+// NOTE(erick): Each end of a jumper is bent down into the board.
+#define ROUTER_LEAD_MM 6
+
+typedef struct {
+    uint column;
+    uint row;
+    DrcSide side;
+} StripLocation;
+
+typedef struct {
+    char* label;
+    StripLocation from;
+    StripLocation to;
+
+    uint span;
+    uint length_mm;
+} Jumper;
+
+typedef struct {
+    Jumper* jumpers;
+    usize count;
+    usize capacity;
+
+    uint n_nets;
+    // NOTE(erick): Pins of ICs that are not on the board. Their nets are
+    //  routed without them.
+    uint n_unplaced_pins;
+} JumperList;
+
+int strip_x(StripLocation);
+int rail_x(uint, PinType);
+uint strip_distance(StripLocation, StripLocation);
+uint jumper_length_mm(uint);
+
+JumperList route_jumpers(ICList);
+void free_jumpers(JumperList*);
+
+void print_cut_list(FILE*, JumperList*);
+void print_assembly_order(FILE*, JumperList*);
+
+#endif
@@ -0,0 +1,308 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "search.h"
+
+static char to_lower(char c) {
+    if(c >= 'A' && c <= 'Z') { return c - 'A' + 'a'; }
+    return c;
+}
+
+// NOTE(erick): The length is in the top byte so n-grams of different lengths
+//  never collide and no key is 0.
+static uint32 ngram_key(char* text, usize length) {
+    uint32 key = length << 24;
+    for(usize i = 0; i < length; i++) {
+        key |= (uint8) text[i] << (8 * (length - 1 - i));
+    }
+
+    return key;
+}
+
+static uint ngram_hash(uint32 key) {
+    return key * 2654435761u;
+}
+
+static NgramPosting* find_posting(SearchIndex* index, uint32 key) {
+    if(!index->capacity) { return NULL; }
+
+    uint mask = index->capacity - 1;
+    for(uint slot = ngram_hash(key) & mask; ; slot = (slot + 1) & mask) {
+        NgramPosting* posting = index->postings + slot;
+        if(posting->key == key) { return posting; }
+        if(posting->key == 0) { return NULL; }
+    }
+}
+
+static void grow_index(SearchIndex* index) {
+    NgramPosting* old_postings = index->postings;
+    uint old_capacity = index->capacity;
+
+    index->capacity = old_capacity ? old_capacity * 2 : 1024;
+    index->postings = (NgramPosting*) calloc(index->capacity, sizeof(NgramPosting));
+
+    uint mask = index->capacity - 1;
+    for(uint i = 0; i < old_capacity; i++) {
+        if(!old_postings[i].key) { continue; }
+
+        uint slot = ngram_hash(old_postings[i].key) & mask;
+        while(index->postings[slot].key) { slot = (slot + 1) & mask; }
+        index->postings[slot] = old_postings[i];
+    }
+
+    free(old_postings);
+}
+
+static NgramPosting* find_or_add_posting(SearchIndex* index, uint32 key) {
+    NgramPosting* posting = find_posting(index, key);
+    if(posting) { return posting; }
+
+    // NOTE(erick): At most half full.
+    if(2 * (index->count + 1) > index->capacity) { grow_index(index); }
+
+    uint mask = index->capacity - 1;
+    uint slot = ngram_hash(key) & mask;
+    while(index->postings[slot].key) { slot = (slot + 1) & mask; }
+
+    posting = index->postings + slot;
+    posting->key = key;
+    index->count++;
+
+    return posting;
+}
+
+static void reserve_posting(NgramPosting* posting) {
+    if(posting->count == posting->capacity) {
+        posting->capacity = posting->capacity ? posting->capacity * 2 : 4;
+        posting->ics = (uint32*) realloc(posting->ics, posting->capacity * sizeof(uint32));
+    }
+}
+
+// NOTE(erick): ICs are added in list order, so the lists stay sorted and a
+//  repeated n-gram of the same IC is always the last entry.
+static void add_ngram(SearchIndex* index, uint32 key, uint32 ic_index) {
+    NgramPosting* posting = find_or_add_posting(index, key);
+    if(posting->count && posting->ics[posting->count - 1] == ic_index) { return; }
+
+    reserve_posting(posting);
+    posting->ics[posting->count++] = ic_index;
+}
+
+static uint lower_bound(NgramPosting* posting, uint32 ic_index) {
+    uint begin = 0;
+    uint end = posting->count;
+    while(begin < end) {
+        uint middle = begin + (end - begin) / 2;
+        if(posting->ics[middle] < ic_index) {
+            begin = middle + 1;
+        } else {
+            end = middle;
+        }
+    }
+
+    return begin;
+}
+
+// NOTE(erick): For ICs that change after the build, in any order.
+static void insert_ngram(SearchIndex* index, uint32 key, uint32 ic_index) {
+    NgramPosting* posting = find_or_add_posting(index, key);
+
+    uint at = lower_bound(posting, ic_index);
+    if(at < posting->count && posting->ics[at] == ic_index) { return; }
+
+    reserve_posting(posting);
+    memmove(posting->ics + at + 1, posting->ics + at,
+            (posting->count - at) * sizeof(uint32));
+    posting->ics[at] = ic_index;
+    posting->count++;
+}
+
+// NOTE(erick): Empty postings are kept. They match nothing.
+static void remove_ngram(SearchIndex* index, uint32 key, uint32 ic_index) {
+    NgramPosting* posting = find_posting(index, key);
+    if(!posting) { return; }
+
+    uint at = lower_bound(posting, ic_index);
+    if(at == posting->count || posting->ics[at] != ic_index) { return; }
+
+    memmove(posting->ics + at, posting->ics + at + 1,
+            (posting->count - at - 1) * sizeof(uint32));
+    posting->count--;
+}
+
+static usize append_lower(char* destination, char* text) {
+    usize length = 0;
+    for(; text[length]; length++) {
+        destination[length] = to_lower(text[length]);
+    }
+    destination[length] = '\n';
+
+    return length + 1;
+}
+
+static usize ic_text_size(IC* ic) {
+    usize text_size = strlen(ic->name) + strlen(ic->code) + 3;
+    for(uint pin_index = 0; pin_index < ic->n_pins; pin_index++) {
+        text_size += strlen(ic->pins[pin_index].label) + 1;
+    }
+
+    return text_size;
+}
+
+static usize append_ic_text(char* destination, IC* ic) {
+    usize offset = 0;
+    offset += append_lower(destination + offset, ic->name);
+    offset += append_lower(destination + offset, ic->code);
+    for(uint pin_index = 0; pin_index < ic->n_pins; pin_index++) {
+        offset += append_lower(destination + offset, ic->pins[pin_index].label);
+    }
+    destination[offset++] = '\0';
+
+    return offset;
+}
+
+void build_search_index(SearchIndex* index, ICList ic_list) {
+    memset(index, 0, sizeof(SearchIndex));
+    index->ics = ic_list.data;
+    index->n_ics = ic_list.count;
+
+    usize text_size = 0;
+    for(usize ic_index = 0; ic_index < ic_list.count; ic_index++) {
+        text_size += ic_text_size(ic_list.data + ic_index);
+    }
+
+    index->text = (char*) malloc(text_size + 1);
+    index->text_offsets = (usize*) malloc((ic_list.count + 1) * sizeof(usize));
+
+    usize offset = 0;
+    for(usize ic_index = 0; ic_index < ic_list.count; ic_index++) {
+        IC* ic = ic_list.data + ic_index;
+        char* ic_text = index->text + offset;
+        index->text_offsets[ic_index] = offset;
+
+        offset += append_ic_text(ic_text, ic);
+
+        for(char* c = ic_text; *c; c++) {
+            for(usize length = 1; length <= 3; length++) {
+                if(c[length - 1] == '\n' || c[length - 1] == '\0') { break; }
+                add_ngram(index, ngram_key(c, length), ic_index);
+            }
+        }
+    }
+
+    index->text_size = offset;
+}
+
+// NOTE(erick): The count ICs from first changed in place. Their old n-grams
+//  are taken out and the new ones put in. The new strings go at the end of the
+//  text and the old ones are left there, unused, until the next build.
+void update_search_index(SearchIndex* index, ICList ic_list, usize first, usize count) {
+    usize text_size = index->text_size;
+    for(usize ic_index = first; ic_index < first + count; ic_index++) {
+        char* ic_text = index->text + index->text_offsets[ic_index];
+
+        for(char* c = ic_text; *c; c++) {
+            for(usize length = 1; length <= 3; length++) {
+                if(c[length - 1] == '\n' || c[length - 1] == '\0') { break; }
+                remove_ngram(index, ngram_key(c, length), ic_index);
+            }
+        }
+
+        text_size += ic_text_size(ic_list.data + ic_index);
+    }
+
+    index->text = (char*) realloc(index->text, text_size + 1);
+
+    for(usize ic_index = first; ic_index < first + count; ic_index++) {
+        char* ic_text = index->text + index->text_size;
+        index->text_offsets[ic_index] = index->text_size;
+
+        index->text_size += append_ic_text(ic_text, ic_list.data + ic_index);
+
+        for(char* c = ic_text; *c; c++) {
+            for(usize length = 1; length <= 3; length++) {
+                if(c[length - 1] == '\n' || c[length - 1] == '\0') { break; }
+                insert_ngram(index, ngram_key(c, length), ic_index);
+            }
+        }
+    }
+}
+
+void free_search_index(SearchIndex* index) {
+    for(uint i = 0; i < index->capacity; i++) {
+        free(index->postings[i].ics);
+    }
+
+    free(index->postings);
+    free(index->text);
+    free(index->text_offsets);
+    memset(index, 0, sizeof(SearchIndex));
+}
+
+// NOTE(erick): Both lists are sorted. The result goes over the first one.
+static uint intersect(uint32* a, uint a_count, uint32* b, uint b_count) {
+    uint result = 0;
+    uint j = 0;
+
+    for(uint i = 0; i < a_count; i++) {
+        while(j < b_count && b[j] < a[i]) { j++; }
+        if(j == b_count) { break; }
+
+        if(b[j] == a[i]) { a[result++] = a[i]; }
+    }
+
+    return result;
+}
+
+// NOTE(erick): Writes the list indices of the matching outside ICs, in list
+//  order, to results, which must have room for every IC. Returns how many.
+uint search_outside_ics(SearchIndex* index, char* query, uint32* results) {
+    char lower_query[SEARCH_MAX_QUERY];
+    usize query_length = 0;
+    for(; query[query_length] && query_length + 1 < SEARCH_MAX_QUERY; query_length++) {
+        lower_query[query_length] = to_lower(query[query_length]);
+    }
+    lower_query[query_length] = '\0';
+
+    uint n_results = 0;
+    if(query_length == 0) {
+        for(usize ic_index = 0; ic_index < index->n_ics; ic_index++) {
+            if(index->ics[ic_index].location.column == 0) { results[n_results++] = ic_index; }
+        }
+
+        return n_results;
+    }
+
+    // NOTE(erick): Starts from the rarest n-gram of the query.
+    usize ngram_length = query_length < 3 ? query_length : 3;
+    NgramPosting* rarest = NULL;
+    for(usize i = 0; i + ngram_length <= query_length; i++) {
+        NgramPosting* posting = find_posting(index, ngram_key(lower_query + i, ngram_length));
+        if(!posting) { return 0; }
+
+        if(!rarest || posting->count < rarest->count) { rarest = posting; }
+    }
+
+    memcpy(results, rarest->ics, rarest->count * sizeof(uint32));
+    uint n_candidates = rarest->count;
+
+    for(usize i = 0; i + ngram_length <= query_length && n_candidates; i++) {
+        NgramPosting* posting = find_posting(index, ngram_key(lower_query + i, ngram_length));
+        if(posting == rarest) { continue; }
+
+        n_candidates = intersect(results, n_candidates, posting->ics, posting->count);
+    }
+
+    // NOTE(erick): Having every n-gram does not mean having the query, and
+    //  they may come from different strings of the IC.
+    for(uint i = 0; i < n_candidates; i++) {
+        uint32 ic_index = results[i];
+        if(index->ics[ic_index].location.column != 0) { continue; }
+
+        if(strstr(index->text + index->text_offsets[ic_index], lower_query)) {
+            results[n_results++] = ic_index;
+        }
+    }
+
+    return n_results;
+}
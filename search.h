@@ -0,0 +1,46 @@
+#ifndef SEARCH_H
+#define SEARCH_H 1
+
+#include "ICs.h"
+
+// NOTE(erick): Case insensitive substring search over the name, the code and
+//  the pin labels of the ICs. Every n-gram of up to three characters of those
+//  strings maps to the sorted list of the ICs that have it, so a query only
+//  looks at the ICs that have all of its trigrams (or its one bigram or
+//  character, when shorter). The candidates are checked against a lower case
+//  copy of their strings. The index covers every IC, placed or not, since
+//  none of the indexed strings change when an IC moves; whether an IC is
+//  outside is checked on the candidates of each query.
+
+#define SEARCH_MAX_QUERY 64
+
+typedef struct {
+    uint32 key;
+
+    uint32* ics;
+    uint count;
+    uint capacity;
+} NgramPosting;
+
+typedef struct {
+    IC* ics;
+    usize n_ics;
+
+    // NOTE(erick): The strings of IC i, lower case and separated by line
+    //  breaks, start at text + text_offsets[i].
+    char* text;
+    usize text_size;
+    usize* text_offsets;
+
+    // NOTE(erick): Open addressing, a key of 0 is an empty slot.
+    NgramPosting* postings;
+    uint capacity;
+    uint count;
+} SearchIndex;
+
+void build_search_index(SearchIndex*, ICList);
+void update_search_index(SearchIndex*, ICList, usize, usize);
+void free_search_index(SearchIndex*);
+uint search_outside_ics(SearchIndex*, char*, uint32*);
+
+#endif
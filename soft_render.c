@@ -0,0 +1,348 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "soft_render.h"
+
+// NOTE(erick): Glyph quads of one text, all from the same atlas. Text with
+//  glyphs the atlas can't hold is rendered by SDL_ttf up front instead and
+//  only its coverage is kept.
+typedef struct {
+    GlyphAtlas* atlas;
+    int first_vertex;
+    int n_vertices;
+
+    uint8* coverage;
+    int coverage_w;
+    int coverage_h;
+    SDL_Rect dest;
+    bool flip;
+    SDL_Color color;
+} TextRun;
+
+typedef struct {
+    SoftCanvas* canvas;
+    RenderBatch* batch;
+    TextRun* runs;
+    usize n_runs;
+
+    uint32 clear_value;
+    int y0;
+    int y1;
+} RenderBand;
+
+SoftCanvas new_soft_canvas(int width, int height) {
+    SoftCanvas result;
+
+    result.width = width;
+    result.height = height;
+    result.pitch = width * 4;
+    result.pixels = (uint8*) malloc((usize) result.pitch * height);
+
+    return result;
+}
+
+void free_soft_canvas(SoftCanvas* canvas) {
+    free(canvas->pixels);
+    canvas->pixels = NULL;
+}
+
+uint soft_render_threads() {
+    long n_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if(n_cpus < 1) { return 1; }
+    if(n_cpus > SOFT_MAX_THREADS) { return SOFT_MAX_THREADS; }
+
+    return (uint) n_cpus;
+}
+
+static uint32 pack_color(SDL_Color color) {
+    uint8 bytes[4] = {color.r, color.g, color.b, color.a};
+    uint32 result;
+    memcpy(&result, bytes, sizeof(result));
+
+    return result;
+}
+
+static int floor_to_int(float value) {
+    int result = (int) value;
+    return value < result ? result - 1 : result;
+}
+
+static void fill_span(uint32* row, int count, uint32 value) {
+#ifdef __SSE2__
+    __m128i wide = _mm_set1_epi32((int) value);
+    while(count >= 16) {
+        _mm_storeu_si128((__m128i*) (row + 0), wide);
+        _mm_storeu_si128((__m128i*) (row + 4), wide);
+        _mm_storeu_si128((__m128i*) (row + 8), wide);
+        _mm_storeu_si128((__m128i*) (row + 12), wide);
+        row += 16;
+        count -= 16;
+    }
+
+    while(count >= 4) {
+        _mm_storeu_si128((__m128i*) row, wide);
+        row += 4;
+        count -= 4;
+    }
+#endif
+
+    while(count--) { *row++ = value; }
+}
+
+static void blend_pixel(uint8* dest, SDL_Color color, uint alpha) {
+    uint inverse = 255 - alpha;
+
+    dest[0] = (uint8) ((color.r * alpha + dest[0] * inverse + 127) / 255);
+    dest[1] = (uint8) ((color.g * alpha + dest[1] * inverse + 127) / 255);
+    dest[2] = (uint8) ((color.b * alpha + dest[2] * inverse + 127) / 255);
+    dest[3] = (uint8) (alpha + (dest[3] * inverse + 127) / 255);
+}
+
+static void fill_rect(RenderBand* band, SDL_Rect rect, SDL_Color color) {
+    SoftCanvas* canvas = band->canvas;
+
+    int x0 = rect.x < 0 ? 0 : rect.x;
+    int x1 = rect.x + rect.w > canvas->width ? canvas->width : rect.x + rect.w;
+    int y0 = rect.y < band->y0 ? band->y0 : rect.y;
+    int y1 = rect.y + rect.h > band->y1 ? band->y1 : rect.y + rect.h;
+    if(x0 >= x1 || y0 >= y1) { return; }
+
+    uint32 value = pack_color(color);
+    for(int y = y0; y < y1; y++) {
+        uint8* row = canvas->pixels + y * canvas->pitch + x0 * 4;
+
+        if(color.a == 0xff) {
+            fill_span((uint32*) row, x1 - x0, value);
+        } else {
+            for(int x = x0; x < x1; x++, row += 4) { blend_pixel(row, color, color.a); }
+        }
+    }
+}
+
+// NOTE(erick): Quads are axis aligned (text is only ever rotated by 180
+//  degrees), so we walk the pixel centers inside the quad and pick the
+//  nearest texel. At scale 1 this copies the glyph exactly.
+static void draw_glyph_quad(RenderBand* band, GlyphAtlas* atlas, SDL_Vertex* quad) {
+    SoftCanvas* canvas = band->canvas;
+    int size = atlas->size;
+
+    SDL_FPoint p0 = quad[0].position;
+    SDL_FPoint p1 = quad[2].position;
+    if(p1.x <= p0.x || p1.y <= p0.y) { return; }
+
+    float u0 = quad[0].tex_coord.x * size;
+    float v0 = quad[0].tex_coord.y * size;
+    float du = (quad[2].tex_coord.x * size - u0) / (p1.x - p0.x);
+    float dv = (quad[2].tex_coord.y * size - v0) / (p1.y - p0.y);
+
+    int x0 = floor_to_int(p0.x + 0.5f);
+    int x1 = floor_to_int(p1.x + 0.5f);
+    int y0 = floor_to_int(p0.y + 0.5f);
+    int y1 = floor_to_int(p1.y + 0.5f);
+
+    if(x0 < 0) { x0 = 0; }
+    if(x1 > canvas->width) { x1 = canvas->width; }
+    if(y0 < band->y0) { y0 = band->y0; }
+    if(y1 > band->y1) { y1 = band->y1; }
+
+    SDL_Color color = quad[0].color;
+    for(int y = y0; y < y1; y++) {
+        int texel_y = floor_to_int(v0 + (y + 0.5f - p0.y) * dv);
+        if(texel_y < 0 || texel_y >= size) { continue; }
+
+        uint8* coverage_row = atlas->coverage + texel_y * size;
+        uint8* row = canvas->pixels + y * canvas->pitch + x0 * 4;
+
+        for(int x = x0; x < x1; x++, row += 4) {
+            int texel_x = floor_to_int(u0 + (x + 0.5f - p0.x) * du);
+            if(texel_x < 0 || texel_x >= size) { continue; }
+
+            uint alpha = coverage_row[texel_x] * color.a / 255;
+            if(!alpha) { continue; }
+
+            blend_pixel(row, color, alpha);
+        }
+    }
+}
+
+// NOTE(erick): The coverage is stretched to dest, nearest texel, like
+//  draw_glyph_quad does, but in integers since there are no quads.
+static void draw_text_coverage(RenderBand* band, TextRun* run) {
+    SoftCanvas* canvas = band->canvas;
+    SDL_Rect dest = run->dest;
+    if(dest.w <= 0 || dest.h <= 0) { return; }
+
+    int x0 = dest.x < 0 ? 0 : dest.x;
+    int x1 = dest.x + dest.w > canvas->width ? canvas->width : dest.x + dest.w;
+    int y0 = dest.y < band->y0 ? band->y0 : dest.y;
+    int y1 = dest.y + dest.h > band->y1 ? band->y1 : dest.y + dest.h;
+
+    for(int y = y0; y < y1; y++) {
+        int texel_y = (int) ((2 * (int64) (y - dest.y) + 1) * run->coverage_h / (2 * dest.h));
+        if(run->flip) { texel_y = run->coverage_h - 1 - texel_y; }
+
+        uint8* coverage_row = run->coverage + texel_y * run->coverage_w;
+        uint8* row = canvas->pixels + y * canvas->pitch + x0 * 4;
+
+        for(int x = x0; x < x1; x++, row += 4) {
+            int texel_x = (int) ((2 * (int64) (x - dest.x) + 1) * run->coverage_w / (2 * dest.w));
+            if(run->flip) { texel_x = run->coverage_w - 1 - texel_x; }
+
+            uint alpha = coverage_row[texel_x] * run->color.a / 255;
+            if(!alpha) { continue; }
+
+            blend_pixel(row, run->color, alpha);
+        }
+    }
+}
+
+// NOTE(erick): Renders the text with SDL_ttf into the coverage of the run.
+static bool rasterize_text_run(TextRun* run, GlyphAtlas* atlas, char* text) {
+    SDL_Color white = {.r = 0xff, .g = 0xff, .b = 0xff, .a = 0xff};
+    SDL_Surface* surf = render_text_surface(atlas, text, white);
+    if(!surf) { return false; }
+
+    run->coverage_w = surf->w;
+    run->coverage_h = surf->h;
+    run->coverage = (uint8*) malloc((usize) surf->w * surf->h);
+
+    for(int y = 0; y < surf->h; y++) {
+        uint32* src = (uint32*) ((uint8*) surf->pixels + y * surf->pitch);
+        uint8* dest = run->coverage + y * surf->w;
+
+        for(int x = 0; x < surf->w; x++) {
+            dest[x] = (uint8) (src[x] >> 24);
+        }
+    }
+
+    SDL_FreeSurface(surf);
+    return true;
+}
+
+static void* render_band(void* arg) {
+    RenderBand* band = (RenderBand*) arg;
+    SoftCanvas* canvas = band->canvas;
+    RenderBatch* batch = band->batch;
+
+    for(int y = band->y0; y < band->y1; y++) {
+        fill_span((uint32*) (canvas->pixels + y * canvas->pitch), canvas->width,
+                  band->clear_value);
+    }
+
+    for(uint layer = 0; layer < BATCH_LAYER_COUNT; layer++) {
+        for(uint i = 0; i < batch->n_buckets[layer]; i++) {
+            RectBucket* bucket = batch->buckets[layer] + i;
+
+            for(usize rect_index = 0; rect_index < bucket->count; rect_index++) {
+                fill_rect(band, bucket->rects[rect_index], bucket->color);
+            }
+        }
+    }
+
+    SDL_Vertex* vertices = batch->glyph_vertices.vertices;
+    for(usize run_index = 0; run_index < band->n_runs; run_index++) {
+        TextRun* run = band->runs + run_index;
+        if(run->coverage) {
+            draw_text_coverage(band, run);
+            continue;
+        }
+
+        for(int v = 0; v < run->n_vertices; v += 4) {
+            draw_glyph_quad(band, run->atlas, vertices + run->first_vertex + v);
+        }
+    }
+
+    return NULL;
+}
+
+// NOTE(erick): Clears the canvas and draws the batch, which is left empty.
+//  Text with glyphs the atlas can't hold is rendered by SDL_ttf, on the
+//  calling thread since SDL_ttf is not thread safe.
+void soft_render_batch(SoftCanvas* canvas, RenderBatch* batch, SDL_Color clear_color,
+                       uint n_threads) {
+    if(n_threads < 1) { n_threads = 1; }
+    if(n_threads > SOFT_MAX_THREADS) { n_threads = SOFT_MAX_THREADS; }
+
+    // NOTE(erick): The quads are built up front, the bands only read them.
+    GlyphVertices* vertices = &batch->glyph_vertices;
+    vertices->n_vertices = 0;
+    vertices->n_indices = 0;
+
+    TextRun* runs = (TextRun*) malloc((batch->n_texts + 1) * sizeof(TextRun));
+    usize n_runs = 0;
+    for(usize i = 0; i < batch->n_texts; i++) {
+        BatchedText* batched = batch->texts + i;
+        char* text = batch->text_arena + batched->text_offset;
+
+        TextRun* run = runs + n_runs;
+        memset(run, 0, sizeof(TextRun));
+        run->atlas = batched->atlas;
+        run->first_vertex = vertices->n_vertices;
+
+        if(!cache_glyphs(batched->atlas, text)) {
+            if(!rasterize_text_run(run, batched->atlas, text)) {
+                fprintf(stderr, "Could not render the text [%s]: %s\n", text,
+                        TTF_GetError());
+                continue;
+            }
+
+            run->dest = batched->dest;
+            run->flip = batched->rotation > 90.0 && batched->rotation < 270.0;
+            run->color = batched->color;
+            n_runs++;
+            continue;
+        }
+
+        n_runs++;
+
+        append_text_vertices(batched->atlas, text, batched->dest, batched->rotation,
+                             batched->color, vertices);
+        run->n_vertices = vertices->n_vertices - run->first_vertex;
+    }
+
+    RenderBand bands[SOFT_MAX_THREADS];
+    pthread_t threads[SOFT_MAX_THREADS];
+
+    int band_height = (canvas->height + n_threads - 1) / n_threads;
+    for(uint i = 0; i < n_threads; i++) {
+        RenderBand* band = bands + i;
+        band->canvas = canvas;
+        band->batch = batch;
+        band->runs = runs;
+        band->n_runs = n_runs;
+        band->clear_value = pack_color(clear_color);
+        band->y0 = i * band_height;
+        band->y1 = band->y0 + band_height;
+        if(band->y0 > canvas->height) { band->y0 = canvas->height; }
+        if(band->y1 > canvas->height) { band->y1 = canvas->height; }
+    }
+
+    // NOTE(erick): The calling thread takes the first band.
+    uint n_started = 0;
+    for(uint i = 1; i < n_threads; i++) {
+        if(pthread_create(threads + i, NULL, render_band, bands + i) != 0) { break; }
+        n_started++;
+    }
+
+    render_band(bands + 0);
+
+    // NOTE(erick): Bands whose thread could not be started are done here.
+    for(uint i = n_started + 1; i < n_threads; i++) {
+        render_band(bands + i);
+    }
+
+    for(uint i = 1; i <= n_started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    for(usize i = 0; i < n_runs; i++) { free(runs[i].coverage); }
+    free(runs);
+    clear_batch(batch);
+}
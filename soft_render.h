@@ -0,0 +1,32 @@
+#ifndef SOFT_RENDER_H
+#define SOFT_RENDER_H 1
+
+#include "ICs.h"
+#include "batch.h"
+
+// NOTE(erick): A CPU renderer for the batches draw.c records. It knows filled
+//  rects and text from the glyph atlases (coverage only, no GPU texture), which
+//  is everything the sheet uses. The image is split in horizontal bands
+//  rendered by different threads. Every pixel is written by one thread, in the
+//  batch order, and blending is integer only, so the output is the same on
+//  every run.
+
+// NOTE(erick): Pixels are RGBA, one byte per channel, in that order in memory
+//  (SDL_PIXELFORMAT_RGBA32).
+typedef struct {
+    uint8* pixels;
+    int width;
+    int height;
+    // NOTE(erick): In bytes.
+    int pitch;
+} SoftCanvas;
+
+#define SOFT_MAX_THREADS 32
+
+SoftCanvas new_soft_canvas(int, int);
+void free_soft_canvas(SoftCanvas*);
+
+uint soft_render_threads();
+void soft_render_batch(SoftCanvas*, RenderBatch*, SDL_Color, uint);
+
+#endif
@@ -0,0 +1,218 @@
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "suggest.h"
+#include "router.h"
+
+typedef struct {
+    char* label;
+
+    // NOTE(erick): Extents of the pins of the IC on this net, relative to
+    //  the IC, by orientation.
+    int min_x[2];
+    int max_x[2];
+    int min_dy[2];
+    int max_dy[2];
+
+    // NOTE(erick): Extents of the placed pins on this net.
+    bool has_placed;
+    int placed_min_x;
+    int placed_max_x;
+    int placed_min_y;
+    int placed_max_y;
+} SuggestNet;
+
+static int grown_extent(int min, int max, int new_min, int new_max) {
+    if(new_min > min) { new_min = min; }
+    if(new_max < max) { new_max = max; }
+
+    return (new_max - new_min) - (max - min);
+}
+
+static int hole_x(uint column, DrcSide side) {
+    StripLocation strip = {.column = column, .row = 1, .side = side};
+    return strip_x(strip);
+}
+
+static void add_suggestion(SlotSuggestions* suggestions, BreadboardLocation location,
+                           uint cost) {
+    uint i = suggestions->count;
+    if(i == SUGGEST_MAX) {
+        if(cost >= suggestions->slots[SUGGEST_MAX - 1].cost) { return; }
+        i--;
+    } else {
+        suggestions->count++;
+    }
+
+    while(i > 0 && suggestions->slots[i - 1].cost > cost) {
+        suggestions->slots[i] = suggestions->slots[i - 1];
+        i--;
+    }
+
+    SlotSuggestion suggestion = {.location = location, .cost = cost};
+    suggestions->slots[i] = suggestion;
+}
+
+// NOTE(erick): The cost of a slot is a part that depends only on the column
+//  and orientation (x extents and rails) plus one that depends only on the
+//  row and orientation (y extents), so the nets are gone through once per
+//  column and once per row instead of once per slot.
+void suggest_slots(ICList ic_list, IC* ic, SlotSuggestions* suggestions) {
+    memset(suggestions, 0, sizeof(SlotSuggestions));
+    suggestions->ic = ic;
+
+    uint height = ic->n_pins / 2;
+    if(!height || height > 64) { return; }
+
+    SuggestNet* nets = (SuggestNet*) malloc((ic->n_pins + 1) * sizeof(SuggestNet));
+    uint n_nets = 0;
+
+    // NOTE(erick): The x of the power pins is summed per orientation.
+    int rail_distance[3][2] = {};
+
+    for(uint pin_index = 0; pin_index < ic->n_pins; pin_index++) {
+        Pin* pin = ic->pins + pin_index;
+        if(pin->type == NOT_CONNECTED) { continue; }
+
+        SuggestNet* net = NULL;
+        if(pin->type == NON_SPECIAL) {
+            for(uint i = 0; i < n_nets; i++) {
+                if(strcmp(nets[i].label, pin->label) == 0) { net = nets + i; }
+            }
+
+            // NOTE(erick): Each orientation takes its extents from its own
+            //  pins only, so they start empty.
+            if(!net) {
+                net = nets + n_nets++;
+                memset(net, 0, sizeof(SuggestNet));
+                net->label = pin->label;
+                for(uint orientation = UP; orientation <= DOWN; orientation++) {
+                    net->min_x[orientation] = net->min_dy[orientation] = INT_MAX;
+                    net->max_x[orientation] = net->max_dy[orientation] = INT_MIN;
+                }
+            }
+        }
+
+        for(uint orientation = UP; orientation <= DOWN; orientation++) {
+            BreadboardLocation location = {.column = 1,
+                                           .row = orientation == UP ? 1 : height,
+                                           .orientation = orientation};
+            uint row;
+            DrcSide side;
+            pin_strip(ic, location, pin_index, &row, &side);
+
+            int x = hole_x(1, side) - hole_x(1, DRC_LEFT);
+            int dy = row - 1;
+
+            if(pin->type != NON_SPECIAL) {
+                for(uint column = 1; column <= 3; column++) {
+                    rail_distance[column - 1][orientation] +=
+                        abs(hole_x(column, side) - rail_x(column, pin->type));
+                }
+                continue;
+            }
+
+            if(x < net->min_x[orientation]) { net->min_x[orientation] = x; }
+            if(x > net->max_x[orientation]) { net->max_x[orientation] = x; }
+            if(dy < net->min_dy[orientation]) { net->min_dy[orientation] = dy; }
+            if(dy > net->max_dy[orientation]) { net->max_dy[orientation] = dy; }
+        }
+    }
+
+    uint64 column_rows[3] = {};
+    for(usize ic_index = 0; ic_index < ic_list.count; ic_index++) {
+        IC* placed = ic_list.data + ic_index;
+        if(placed == ic || placed->location.column == 0) { continue; }
+
+        for(uint row = 1; row <= 64; row++) {
+            if(row_is_inside_ic(placed, row)) {
+                column_rows[placed->location.column - 1] |= 1ull << (row - 1);
+            }
+        }
+
+        for(uint pin_index = 0; pin_index < placed->n_pins; pin_index++) {
+            Pin* pin = placed->pins + pin_index;
+            if(pin->type != NON_SPECIAL) { continue; }
+
+            for(uint i = 0; i < n_nets; i++) {
+                SuggestNet* net = nets + i;
+                if(strcmp(net->label, pin->label) != 0) { continue; }
+
+                uint row;
+                DrcSide side;
+                if(!pin_strip(placed, placed->location, pin_index, &row, &side)) { break; }
+
+                int x = hole_x(placed->location.column, side);
+                if(!net->has_placed) {
+                    net->has_placed = true;
+                    net->placed_min_x = net->placed_max_x = x;
+                    net->placed_min_y = net->placed_max_y = row;
+                }
+
+                if(x < net->placed_min_x) { net->placed_min_x = x; }
+                if(x > net->placed_max_x) { net->placed_max_x = x; }
+                if((int) row < net->placed_min_y) { net->placed_min_y = row; }
+                if((int) row > net->placed_max_y) { net->placed_max_y = row; }
+                break;
+            }
+        }
+    }
+
+    int x_cost[3][2];
+    int y_cost[2][65] = {};
+    for(uint orientation = UP; orientation <= DOWN; orientation++) {
+        for(uint column = 1; column <= 3; column++) {
+            x_cost[column - 1][orientation] = rail_distance[column - 1][orientation];
+        }
+
+        for(uint i = 0; i < n_nets; i++) {
+            SuggestNet* net = nets + i;
+            if(!net->has_placed) { continue; }
+
+            for(uint column = 1; column <= 3; column++) {
+                int base_x = hole_x(column, DRC_LEFT);
+                x_cost[column - 1][orientation] +=
+                    grown_extent(net->placed_min_x, net->placed_max_x,
+                                 base_x + net->min_x[orientation],
+                                 base_x + net->max_x[orientation]);
+            }
+
+            for(uint min_row = 1; min_row + height - 1 <= 64; min_row++) {
+                y_cost[orientation][min_row] +=
+                    grown_extent(net->placed_min_y, net->placed_max_y,
+                                 min_row + net->min_dy[orientation],
+                                 min_row + net->max_dy[orientation]);
+            }
+        }
+    }
+
+    uint64 rows = height == 64 ? ~0ull : (1ull << height) - 1;
+    for(uint column = 1; column <= 3; column++) {
+        for(uint min_row = 1; min_row + height - 1 <= 64; min_row++) {
+            if(column_rows[column - 1] & (rows << (min_row - 1))) { continue; }
+
+            for(uint orientation = UP; orientation <= DOWN; orientation++) {
+                BreadboardLocation location = {
+                    .column = column,
+                    .row = orientation == UP ? min_row : min_row + height - 1,
+                    .orientation = orientation};
+
+                add_suggestion(suggestions, location,
+                               x_cost[column - 1][orientation] + y_cost[orientation][min_row]);
+            }
+        }
+    }
+
+    free(nets);
+}
+
+bool place_suggested_ic(ICList ic_list, SlotSuggestions* suggestions) {
+    if(!suggestions->ic || suggestions->current >= suggestions->count) { return false; }
+
+    IC* ic = suggestions->ic;
+    record_placement_change(ic_list, ic);
+    ic->location = suggestions->slots[suggestions->current].location;
+
+    return true;
+}
@@ -0,0 +1,30 @@
+#ifndef SUGGEST_H
+#define SUGGEST_H 1
+
+#include "ICs.h"
+
+// NOTE(erick): Where an outside IC would best go. Every slot (column, row and
+//  orientation) it fits in is scored by how much it grows the half-perimeter
+//  of the nets it shares with the placed ICs plus how far its VCC and GND
+//  pins are from their rails, all in holes on the board model of router.h.
+
+#define SUGGEST_MAX 5
+
+typedef struct {
+    BreadboardLocation location;
+    uint cost;
+} SlotSuggestion;
+
+typedef struct {
+    IC* ic;
+
+    // NOTE(erick): Cheapest first.
+    SlotSuggestion slots[SUGGEST_MAX];
+    uint count;
+    uint current;
+} SlotSuggestions;
+
+void suggest_slots(ICList, IC*, SlotSuggestions*);
+bool place_suggested_ic(ICList, SlotSuggestions*);
+
+#endif
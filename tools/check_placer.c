@@ -0,0 +1,159 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include "bread_placer.h"
+#include "placer.h"
+#include "workload.h"
+
+// NOTE(erick): Checks place_exact against brute force. Each board is a small
+//  generated list, every placement of it on the board is tried and the best
+//  wire length found that way must be the one place_exact reports, and the
+//  placement it leaves must have that wire length too.
+
+#define CHECK_MAX_ICS 3
+#define CHECK_TIME_LIMIT 60.0
+
+static void print_usage(char* program_name) {
+    fprintf(stderr, "Usage: %s [options]\n", program_name);
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "\t--boards <n>  Number of boards (default 20)\n");
+    fprintf(stderr, "\t--ics <n>     ICs on each board, 1 to %d (default 2)\n", CHECK_MAX_ICS);
+    fprintf(stderr, "\t--seed <n>    Seed of the first board (default 1)\n");
+}
+
+static bool overlaps(IC* a, IC* b) {
+    if(a->location.column != b->location.column) { return false; }
+
+    uint a_min = a->location.orientation == UP ? a->location.row : a->location.row - a->n_pins / 2 + 1;
+    uint b_min = b->location.orientation == UP ? b->location.row : b->location.row - b->n_pins / 2 + 1;
+
+    return a_min < b_min + b->n_pins / 2 && b_min < a_min + a->n_pins / 2;
+}
+
+// NOTE(erick): Tries every column, orientation and row of the IC at depth that
+//  does not overlap the ones before it, then the next IC.
+static void search_every_placement(ICList ic_list, usize depth, uint* best,
+                                   uint64* n_placements) {
+    if(depth == ic_list.count) {
+        uint wire_length = placement_wire_length(ic_list);
+        if(wire_length < *best) { *best = wire_length; }
+        (*n_placements)++;
+        return;
+    }
+
+    IC* ic = ic_list.data + depth;
+    uint height = ic->n_pins / 2;
+
+    for(uint column = 1; column <= 3; column++) {
+        for(uint orientation = UP; orientation <= DOWN; orientation++) {
+            for(uint min_row = 1; min_row + height - 1 <= 64; min_row++) {
+                ic->location.column = column;
+                ic->location.orientation = orientation;
+                ic->location.row = orientation == UP ? min_row : min_row + height - 1;
+
+                bool is_free = true;
+                for(usize earlier = 0; earlier < depth; earlier++) {
+                    if(overlaps(ic_list.data + earlier, ic)) {
+                        is_free = false;
+                        break;
+                    }
+                }
+
+                if(is_free) { search_every_placement(ic_list, depth + 1, best, n_placements); }
+            }
+        }
+    }
+}
+
+// NOTE(erick): Goes through the parser so the ICs are exactly what the editor
+//  would see.
+static ICList generated_list(uint n_ics, uint64 seed) {
+    WorkloadParams params = default_workload_params();
+    params.n_ics = n_ics;
+    params.occupancy = 0.0f;
+    params.seed = seed;
+
+    Workload workload = generate_workload(&params);
+
+    FILE* file = tmpfile();
+    if(!file) {
+        fprintf(stderr, "Could not create temporary file.\n");
+        exit(1);
+    }
+    write_ics_list(file, &workload);
+    rewind(file);
+    free_workload(&workload);
+
+    ProjectContext context = new_project_context(stderr);
+    ICList result;
+    int error = read_ic_list_file(&context, file, &result);
+    fclose(file);
+    if(error) { exit(error); }
+
+    return result;
+}
+
+int main(int args_count, char** args_values) {
+    uint n_boards = 20;
+    uint n_ics = 2;
+    uint64 first_seed = 1;
+
+    for(int arg_index = 1; arg_index < args_count; arg_index++) {
+        char* arg = args_values[arg_index];
+        bool has_value = arg_index + 1 < args_count;
+
+        if(strcmp(arg, "--boards") == 0 && has_value) {
+            n_boards = (uint) strtoul(args_values[++arg_index], NULL, 10);
+        } else if(strcmp(arg, "--ics") == 0 && has_value) {
+            n_ics = (uint) strtoul(args_values[++arg_index], NULL, 10);
+        } else if(strcmp(arg, "--seed") == 0 && has_value) {
+            first_seed = strtoull(args_values[++arg_index], NULL, 10);
+        } else {
+            print_usage(args_values[0]);
+            exit(1);
+        }
+    }
+
+    if(n_ics < 1 || n_ics > CHECK_MAX_ICS) {
+        print_usage(args_values[0]);
+        exit(1);
+    }
+
+    ProjectContext context = new_project_context(stderr);
+    uint n_failed = 0;
+
+    for(uint board = 0; board < n_boards; board++) {
+        uint64 seed = first_seed + board;
+        ICList list = generated_list(n_ics, seed);
+
+        uint best = UINT_MAX;
+        uint64 n_placements = 0;
+        search_every_placement(list, 0, &best, &n_placements);
+
+        ExactPlacement placement;
+        bool found = place_exact(&context, list, CHECK_TIME_LIMIT, &placement);
+        uint placed_length = found ? placement_wire_length(list) : UINT_MAX;
+
+        bool matches = found && placement.optimal && placement.wire_length == best &&
+            placed_length == best;
+        if(!found && best == UINT_MAX) { matches = true; }
+
+        if(matches) {
+            fprintf(stderr, "Board %llu: wire length %u over %llu placements.\n",
+                    (unsigned long long) seed, best, (unsigned long long) n_placements);
+        } else {
+            fprintf(stderr, "Board %llu: brute force found %u, place_exact reported %u"
+                    " (%s) and left %u.\n", (unsigned long long) seed, best,
+                    placement.wire_length, placement.optimal ? "optimal" : "not optimal",
+                    placed_length);
+            n_failed++;
+        }
+
+        free_ic_list(&list);
+    }
+
+    fprintf(stderr, "%u of %u boards match.\n", n_boards - n_failed, n_boards);
+    return n_failed ? 3 : 0;
+}
@@ -0,0 +1,285 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include "bread_placer.h"
+#include "router.h"
+#include "suggest.h"
+#include "workload.h"
+
+// NOTE(erick): Checks suggest_slots against scoring every free slot on its
+//  own: the IC is put in the slot and the nets it shares with the placed ICs
+//  are measured before and after. Every suggestion must cost what scoring its
+//  slot gives and no free slot may be cheaper than the first suggestion. A
+//  board made so that the only good slot is DOWN is checked first.
+
+#define CHECK_MAX_OUTSIDE 8
+
+static void print_usage(char* program_name) {
+    fprintf(stderr, "Usage: %s [options]\n", program_name);
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "\t--boards <n>  Number of generated boards (default 20)\n");
+    fprintf(stderr, "\t--ics <n>     ICs on each board (default 30)\n");
+    fprintf(stderr, "\t--seed <n>    Seed of the first board (default 1)\n");
+}
+
+static ICList read_list(FILE* file) {
+    rewind(file);
+
+    ProjectContext context = new_project_context(stderr);
+    ICList result;
+    int error = read_ic_list_file(&context, file, &result);
+    fclose(file);
+    if(error) { exit(error); }
+
+    return result;
+}
+
+static FILE* temporary_file() {
+    FILE* result = tmpfile();
+    if(!result) {
+        fprintf(stderr, "Could not create temporary file.\n");
+        exit(1);
+    }
+
+    return result;
+}
+
+static int hole_x(uint column, DrcSide side) {
+    StripLocation strip = {.column = column, .row = 1, .side = side};
+    return strip_x(strip);
+}
+
+typedef struct {
+    bool empty;
+    int min_x;
+    int max_x;
+    int min_y;
+    int max_y;
+} Box;
+
+static void grow_box(Box* box, int x, int y) {
+    if(box->empty) {
+        Box first = {false, x, x, y, y};
+        *box = first;
+    }
+
+    if(x < box->min_x) { box->min_x = x; }
+    if(x > box->max_x) { box->max_x = x; }
+    if(y < box->min_y) { box->min_y = y; }
+    if(y > box->max_y) { box->max_y = y; }
+}
+
+static int half_perimeter(Box* box) {
+    return (box->max_x - box->min_x) + (box->max_y - box->min_y);
+}
+
+static void add_placed_pins(ICList ic_list, IC* ic, char* label, Box* box) {
+    for(usize ic_index = 0; ic_index < ic_list.count; ic_index++) {
+        IC* placed = ic_list.data + ic_index;
+        if(placed == ic || placed->location.column == 0) { continue; }
+
+        for(uint pin_index = 0; pin_index < placed->n_pins; pin_index++) {
+            Pin* pin = placed->pins + pin_index;
+            if(pin->type != NON_SPECIAL || strcmp(pin->label, label) != 0) { continue; }
+
+            uint row;
+            DrcSide side;
+            if(!pin_strip(placed, placed->location, pin_index, &row, &side)) { continue; }
+
+            grow_box(box, hole_x(placed->location.column, side), row);
+        }
+    }
+}
+
+static uint slot_cost(ICList ic_list, IC* ic, BreadboardLocation location) {
+    int cost = 0;
+
+    for(uint pin_index = 0; pin_index < ic->n_pins; pin_index++) {
+        Pin* pin = ic->pins + pin_index;
+        if(pin->type == NOT_CONNECTED) { continue; }
+
+        uint row;
+        DrcSide side;
+        pin_strip(ic, location, pin_index, &row, &side);
+
+        if(pin->type != NON_SPECIAL) {
+            cost += abs(hole_x(location.column, side) - rail_x(location.column, pin->type));
+            continue;
+        }
+
+        // NOTE(erick): Each net is measured at its first pin on the IC.
+        bool is_first = true;
+        for(uint earlier = 0; earlier < pin_index; earlier++) {
+            Pin* other = ic->pins + earlier;
+            if(other->type == NON_SPECIAL && strcmp(other->label, pin->label) == 0) {
+                is_first = false;
+            }
+        }
+        if(!is_first) { continue; }
+
+        Box placed = {.empty = true};
+        add_placed_pins(ic_list, ic, pin->label, &placed);
+        if(placed.empty) { continue; }
+
+        Box grown = placed;
+        for(uint other_index = 0; other_index < ic->n_pins; other_index++) {
+            Pin* other = ic->pins + other_index;
+            if(other->type != NON_SPECIAL || strcmp(other->label, pin->label) != 0) { continue; }
+
+            pin_strip(ic, location, other_index, &row, &side);
+            grow_box(&grown, hole_x(location.column, side), row);
+        }
+
+        cost += half_perimeter(&grown) - half_perimeter(&placed);
+    }
+
+    return cost;
+}
+
+static bool is_free_slot(ICList ic_list, IC* ic, uint column, uint min_row) {
+    for(usize ic_index = 0; ic_index < ic_list.count; ic_index++) {
+        IC* placed = ic_list.data + ic_index;
+        if(placed == ic || placed->location.column != column) { continue; }
+
+        for(uint row = min_row; row < min_row + ic->n_pins / 2; row++) {
+            if(row_is_inside_ic(placed, row)) { return false; }
+        }
+    }
+
+    return true;
+}
+
+// NOTE(erick): Returns whether the suggestions for the IC are right, after
+//  saying what is wrong with them.
+static bool check_ic(ICList ic_list, IC* ic, char* board) {
+    SlotSuggestions suggestions;
+    suggest_slots(ic_list, ic, &suggestions);
+
+    for(uint i = 0; i < suggestions.count; i++) {
+        SlotSuggestion* suggestion = suggestions.slots + i;
+        uint expected = slot_cost(ic_list, ic, suggestion->location);
+
+        if(suggestion->cost != expected) {
+            BreadboardLocation location = suggestion->location;
+            fprintf(stderr, "%s: IC [%s] at {%u, %u, %s} was scored %u, it costs %u.\n",
+                    board, ic->name, location.column, location.row,
+                    location.orientation == UP ? "UP" : "DOWN", suggestion->cost, expected);
+            return false;
+        }
+    }
+
+    uint height = ic->n_pins / 2;
+    for(uint column = 1; column <= 3; column++) {
+        for(uint min_row = 1; min_row + height - 1 <= 64; min_row++) {
+            if(!is_free_slot(ic_list, ic, column, min_row)) { continue; }
+
+            for(uint orientation = UP; orientation <= DOWN; orientation++) {
+                BreadboardLocation location = {
+                    .column = column,
+                    .row = orientation == UP ? min_row : min_row + height - 1,
+                    .orientation = orientation};
+
+                uint cost = slot_cost(ic_list, ic, location);
+                if(!suggestions.count || cost < suggestions.slots[0].cost) {
+                    fprintf(stderr, "%s: IC [%s] at {%u, %u, %s} costs %u, the best"
+                            " suggestion %u.\n", board, ic->name, location.column,
+                            location.row, orientation == UP ? "UP" : "DOWN", cost,
+                            suggestions.count ? suggestions.slots[0].cost : UINT_MAX);
+                    return false;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+// NOTE(erick): U1 is on the bottom of column 3 pointing DOWN, so its pin 1 is
+//  on the right strips. Only U2 pointing DOWN puts its pin 1 there too.
+static bool check_down_slot() {
+    FILE* file = temporary_file();
+    for(uint ic_index = 0; ic_index < 2; ic_index++) {
+        fprintf(file, "IC 8\nName U%u\nCode 555\nPins\n*1 NET_A\n", ic_index + 1);
+        for(uint pin = 2; pin <= 8; pin++) { fprintf(file, "*%u N.C.\n", pin); }
+        fprintf(file, "\n");
+    }
+
+    ICList list = read_list(file);
+    BreadboardLocation location = {.column = 3, .row = 64, .orientation = DOWN};
+    list.data[0].location = location;
+
+    bool result = check_ic(list, list.data + 1, "DOWN board");
+
+    SlotSuggestions suggestions;
+    suggest_slots(list, list.data + 1, &suggestions);
+    BreadboardLocation best = suggestions.slots[0].location;
+    if(result && (!suggestions.count || best.column != 3 || best.row != 60 ||
+                  best.orientation != DOWN)) {
+        fprintf(stderr, "DOWN board: the best suggestion is {%u, %u, %s}, not {3, 60, DOWN}.\n",
+                best.column, best.row, best.orientation == UP ? "UP" : "DOWN");
+        result = false;
+    }
+
+    free_ic_list(&list);
+    return result;
+}
+
+int main(int args_count, char** args_values) {
+    uint n_boards = 20;
+    uint n_ics = 30;
+    uint64 first_seed = 1;
+
+    for(int arg_index = 1; arg_index < args_count; arg_index++) {
+        char* arg = args_values[arg_index];
+        bool has_value = arg_index + 1 < args_count;
+
+        if(strcmp(arg, "--boards") == 0 && has_value) {
+            n_boards = (uint) strtoul(args_values[++arg_index], NULL, 10);
+        } else if(strcmp(arg, "--ics") == 0 && has_value) {
+            n_ics = (uint) strtoul(args_values[++arg_index], NULL, 10);
+        } else if(strcmp(arg, "--seed") == 0 && has_value) {
+            first_seed = strtoull(args_values[++arg_index], NULL, 10);
+        } else {
+            print_usage(args_values[0]);
+            exit(1);
+        }
+    }
+
+    uint n_failed = check_down_slot() ? 0 : 1;
+
+    for(uint board = 0; board < n_boards; board++) {
+        WorkloadParams params = default_workload_params();
+        params.n_ics = n_ics;
+        params.occupancy = 0.5f;
+        params.seed = first_seed + board;
+
+        Workload workload = generate_workload(&params);
+        FILE* file = temporary_file();
+        write_ics_list(file, &workload);
+        ICList list = read_list(file);
+        place_workload(&workload, list);
+        free_workload(&workload);
+
+        char name[32];
+        snprintf(name, sizeof(name), "Board %llu", (unsigned long long) params.seed);
+
+        bool matches = true;
+        uint n_checked = 0;
+        for(usize ic_index = 0; ic_index < list.count && n_checked < CHECK_MAX_OUTSIDE;
+            ic_index++) {
+            IC* ic = list.data + ic_index;
+            if(ic->location.column != 0) { continue; }
+
+            if(!check_ic(list, ic, name)) { matches = false; }
+            n_checked++;
+        }
+
+        if(!matches) { n_failed++; }
+        free_ic_list(&list);
+    }
+
+    fprintf(stderr, "%u of %u boards match.\n", n_boards + 1 - n_failed, n_boards + 1);
+    return n_failed ? 3 : 0;
+}
@@ -0,0 +1,181 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bread_placer.h"
+#include "workload.h"
+
+static void print_usage(char* program_name) {
+    fprintf(stderr, "Usage: %s [options] output_base\n", program_name);
+    fprintf(stderr, "Writes output_base.ics_list and output_base.icprj\n");
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "\t--ics <n>             Number of ICs (default 100)\n");
+    fprintf(stderr, "\t--pins <distribution> Pin counts and weights, e.g. 8:2,14:4,16:3\n");
+    fprintf(stderr, "\t--fanout <f>          Average pins per signal net (default 3)\n");
+    fprintf(stderr, "\t--occupancy <f>       Fraction of board rows in use (default 0.75)\n");
+    fprintf(stderr, "\t--outside <f>         Fraction of pins marked with '#' (default 0.1)\n");
+    fprintf(stderr, "\t--nc <f>              Fraction of N.C. pins (default 0.02)\n");
+    fprintf(stderr, "\t--seed <n>            Random seed (default 1)\n");
+    fprintf(stderr, "\t--verify              Parse the output back before exiting\n");
+}
+
+static float parse_fraction(char* text, char* program_name) {
+    char* end;
+    float result = strtof(text, &end);
+    if(*end || result < 0.0f || result > 1.0f) {
+        print_usage(program_name);
+        exit(1);
+    }
+
+    return result;
+}
+
+static FILE* open_output(char* base, const char* extension) {
+    char* filename = (char*) malloc(strlen(base) + strlen(extension) + 1);
+    sprintf(filename, "%s%s", base, extension);
+
+    FILE* result = fopen(filename, "w");
+    if(!result) {
+        fprintf(stderr, "Could not open [%s] for writing.\n", filename);
+        exit(2);
+    }
+
+    free(filename);
+    return result;
+}
+
+// NOTE(erick): Reads the project file into a list of ICs that all start
+//  outside and checks every IC ends up where the workload put it.
+static void verify_project(ProjectContext* context, char* prj_filename, ICList* list,
+                           Workload* workload) {
+    for(usize ic_index = 0; ic_index < list->count; ic_index++) {
+        BreadboardLocation outside = {};
+        list->data[ic_index].location = outside;
+    }
+
+    int error = read_project_file(context, prj_filename, list);
+    if(error) { exit(error); }
+
+    for(usize ic_index = 0; ic_index < list->count; ic_index++) {
+        BreadboardLocation expected = workload->ics[ic_index].location;
+        BreadboardLocation actual = list->data[ic_index].location;
+
+        if(expected.column != actual.column || expected.row != actual.row ||
+           expected.orientation != actual.orientation) {
+            fprintf(stderr, "Verification failed: IC %zu has the wrong location in [%s].\n",
+                    ic_index, prj_filename);
+            exit(3);
+        }
+    }
+}
+
+// NOTE(erick): Runs the files through the same code the editor uses and exits
+//  with its exit code on any error, so getting to the end means they are fine.
+//  Project files in the format from before the ids are checked too, with one
+//  written next to the others and removed afterwards.
+static void verify_output(char* base, Workload* workload) {
+    char* ics_filename = (char*) malloc(strlen(base) + strlen(".ics_list") + 1);
+    char* prj_filename = (char*) malloc(strlen(base) + strlen(".icprj") + 1);
+    char* legacy_filename = (char*) malloc(strlen(base) + strlen(".legacy.icprj") + 1);
+    sprintf(ics_filename, "%s.ics_list", base);
+    sprintf(prj_filename, "%s.icprj", base);
+    sprintf(legacy_filename, "%s.legacy.icprj", base);
+
+    ProjectContext context = new_project_context(stderr);
+
+    FILE* ics_file = fopen(ics_filename, "r");
+    if(!ics_file) {
+        fprintf(stderr, "Could not open [%s] for verification.\n", ics_filename);
+        exit(3);
+    }
+
+    ICList list;
+    int error = read_ic_list_file(&context, ics_file, &list);
+    fclose(ics_file);
+    if(error) { exit(error); }
+
+    if(list.count != workload->n_ics) {
+        fprintf(stderr, "Verification failed: parsed %zu ICs, expected %u.\n",
+                list.count, workload->n_ics);
+        exit(3);
+    }
+
+    verify_project(&context, prj_filename, &list, workload);
+
+    FILE* legacy_file = open_output(base, ".legacy.icprj");
+    write_legacy_project(legacy_file, workload);
+    fclose(legacy_file);
+
+    verify_project(&context, legacy_filename, &list, workload);
+    remove(legacy_filename);
+
+    fprintf(stderr, "Verified %zu ICs.\n", list.count);
+
+    free_ic_list(&list);
+    free(ics_filename);
+    free(prj_filename);
+    free(legacy_filename);
+}
+
+int main(int args_count, char** args_values) {
+    WorkloadParams params = default_workload_params();
+    char* output_base = NULL;
+    bool verify = false;
+
+    for(int arg_index = 1; arg_index < args_count; arg_index++) {
+        char* arg = args_values[arg_index];
+        bool has_value = arg_index + 1 < args_count;
+
+        if(strcmp(arg, "--ics") == 0 && has_value) {
+            params.n_ics = (uint) strtoul(args_values[++arg_index], NULL, 10);
+        } else if(strcmp(arg, "--pins") == 0 && has_value) {
+            if(!parse_pin_distribution(args_values[++arg_index], &params)) {
+                fprintf(stderr, "Invalid pin distribution [%s]\n", args_values[arg_index]);
+                exit(1);
+            }
+        } else if(strcmp(arg, "--fanout") == 0 && has_value) {
+            params.net_fanout = strtof(args_values[++arg_index], NULL);
+        } else if(strcmp(arg, "--occupancy") == 0 && has_value) {
+            params.occupancy = parse_fraction(args_values[++arg_index], args_values[0]);
+        } else if(strcmp(arg, "--outside") == 0 && has_value) {
+            params.outside_ratio = parse_fraction(args_values[++arg_index], args_values[0]);
+        } else if(strcmp(arg, "--nc") == 0 && has_value) {
+            params.not_connected_ratio = parse_fraction(args_values[++arg_index],
+                                                        args_values[0]);
+        } else if(strcmp(arg, "--seed") == 0 && has_value) {
+            params.seed = strtoull(args_values[++arg_index], NULL, 10);
+        } else if(strcmp(arg, "--verify") == 0) {
+            verify = true;
+        } else if(arg[0] != '-' && !output_base) {
+            output_base = arg;
+        } else {
+            print_usage(args_values[0]);
+            exit(1);
+        }
+    }
+
+    if(!output_base) {
+        print_usage(args_values[0]);
+        exit(1);
+    }
+
+    Workload workload = generate_workload(&params);
+
+    FILE* ics_file = open_output(output_base, ".ics_list");
+    write_ics_list(ics_file, &workload);
+    fclose(ics_file);
+
+    FILE* prj_file = open_output(output_base, ".icprj");
+    write_project(prj_file, &workload);
+    fclose(prj_file);
+
+    fprintf(stderr, "Generated %u ICs (%u placed) on %u nets.\n",
+            workload.n_ics, workload.n_placed, workload.n_nets);
+
+    if(verify) {
+        verify_output(output_base, &workload);
+    }
+
+    free_workload(&workload);
+    return 0;
+}
@@ -0,0 +1,21 @@
+#ifndef TYPES_H
+#define TYPES_H 1
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef intptr_t isize;
+typedef int8_t   int8;
+typedef int16_t  int16;
+typedef int32_t  int32;
+typedef int64_t  int64;
+
+typedef size_t       usize;
+typedef uint8_t      uint8;
+typedef uint16_t     uint16;
+typedef uint32_t     uint32;
+typedef uint64_t     uint64;
+typedef unsigned int uint;
+
+#endif
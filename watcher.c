@@ -0,0 +1,173 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+
+#include <SDL2/SDL.h>
+
+#include "bread_placer.h"
+#include "watcher.h"
+
+// NOTE(erick): Waits for the reload posted before to be handed back, so the
+//  changes are worked out against the version the list has.
+static void post_changes(IcsListWatcher* watcher) {
+    pthread_mutex_lock(&watcher->lock);
+    while(watcher->is_pending && !watcher->quit) {
+        pthread_cond_wait(&watcher->finished, &watcher->lock);
+    }
+
+    IcsListReload* reload = (IcsListReload*) calloc(1, sizeof(IcsListReload));
+    if(watcher->quit ||
+       !diff_ics_list_file(&watcher->context, watcher->filename, &watcher->snapshot,
+                           reload)) {
+        pthread_mutex_unlock(&watcher->lock);
+        free(reload);
+        return;
+    }
+
+    SDL_Event event = {};
+    event.type = watcher->event_type;
+    event.user.data1 = reload;
+
+    // NOTE(erick): SDL_PushEvent is safe to call from any thread. When it
+    //  fails the snapshot stays where it was, so the next change of the file
+    //  brings this one along.
+    if(SDL_PushEvent(&event) == 1) {
+        watcher->is_pending = true;
+    } else {
+        fprintf(stderr, "Could not post the reload of [%s].\n", watcher->filename);
+        free_ics_list_reload(reload);
+        free(reload);
+    }
+
+    pthread_mutex_unlock(&watcher->lock);
+}
+
+static void* watch_ics_list(void* data) {
+    IcsListWatcher* watcher = (IcsListWatcher*) data;
+
+    struct pollfd fds[2] = {{.fd = watcher->inotify_fd, .events = POLLIN},
+                            {.fd = watcher->wake_fds[0], .events = POLLIN}};
+
+    char buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    while(true) {
+        if(poll(fds, 2, -1) < 0) {
+            if(errno == EINTR) { continue; }
+            break;
+        }
+        if(fds[1].revents) { break; }
+
+        ssize_t length = read(watcher->inotify_fd, buffer, sizeof(buffer));
+        if(length < 0 && errno == EINTR) { continue; }
+        if(length <= 0) { break; }
+
+        bool file_changed = false;
+        for(char* at = buffer; at < buffer + length; ) {
+            struct inotify_event* event = (struct inotify_event*) at;
+            if(event->len && strcmp(event->name, watcher->basename) == 0) {
+                file_changed = true;
+            }
+
+            at += sizeof(struct inotify_event) + event->len;
+        }
+
+        if(file_changed) { post_changes(watcher); }
+    }
+
+    return NULL;
+}
+
+static void free_watcher(IcsListWatcher* watcher) {
+    if(watcher->inotify_fd >= 0) { close(watcher->inotify_fd); }
+    if(watcher->wake_fds[0] >= 0) { close(watcher->wake_fds[0]); }
+    if(watcher->wake_fds[1] >= 0) { close(watcher->wake_fds[1]); }
+    pthread_mutex_destroy(&watcher->lock);
+    pthread_cond_destroy(&watcher->finished);
+
+    free_ics_list_snapshot(&watcher->snapshot);
+    free(watcher->directory);
+    memset(watcher, 0, sizeof(IcsListWatcher));
+}
+
+static bool give_up(IcsListWatcher* watcher) {
+    free_watcher(watcher);
+    return false;
+}
+
+bool start_ics_list_watcher(IcsListWatcher* watcher, char* filename) {
+    memset(watcher, 0, sizeof(IcsListWatcher));
+    watcher->filename = filename;
+    watcher->context = new_project_context(stderr);
+    watcher->inotify_fd = -1;
+    watcher->wake_fds[0] = watcher->wake_fds[1] = -1;
+    pthread_mutex_init(&watcher->lock, NULL);
+    pthread_cond_init(&watcher->finished, NULL);
+
+    char* slash = strrchr(filename, '/');
+    if(slash) {
+        usize directory_len = slash == filename ? 1 : (usize) (slash - filename);
+        watcher->directory = str_n_alloc_cpy(filename, directory_len);
+        watcher->basename = slash + 1;
+    } else {
+        watcher->directory = cpystr(".");
+        watcher->basename = filename;
+    }
+
+    watcher->event_type = SDL_RegisterEvents(1);
+    if(watcher->event_type == (uint32) -1) { return give_up(watcher); }
+
+    if(!snapshot_ics_list_file(filename, &watcher->snapshot)) { return give_up(watcher); }
+
+    watcher->inotify_fd = inotify_init1(IN_CLOEXEC);
+    if(watcher->inotify_fd < 0) { return give_up(watcher); }
+
+    if(inotify_add_watch(watcher->inotify_fd, watcher->directory,
+                         IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        return give_up(watcher);
+    }
+
+    if(pipe(watcher->wake_fds) != 0) { return give_up(watcher); }
+
+    if(pthread_create(&watcher->thread, NULL, watch_ics_list, watcher) != 0) {
+        return give_up(watcher);
+    }
+
+    return true;
+}
+
+// NOTE(erick): Hands a reload posted by the watcher back. When it was applied
+//  the list has the new version of the file, otherwise it still has the one
+//  the reload was worked out against. The reload still has to be freed.
+void finish_ics_list_reload(IcsListWatcher* watcher, IcsListReload* reload, bool applied) {
+    pthread_mutex_lock(&watcher->lock);
+
+    if(applied) {
+        IcsListSnapshot old = watcher->snapshot;
+        watcher->snapshot = reload->snapshot;
+        reload->snapshot = old;
+    }
+
+    watcher->is_pending = false;
+    pthread_cond_signal(&watcher->finished);
+    pthread_mutex_unlock(&watcher->lock);
+}
+
+// NOTE(erick): Reloads still in the event queue are left there.
+void stop_ics_list_watcher(IcsListWatcher* watcher) {
+    pthread_mutex_lock(&watcher->lock);
+    watcher->quit = true;
+    pthread_cond_signal(&watcher->finished);
+    pthread_mutex_unlock(&watcher->lock);
+
+    char wake = 0;
+    if(write(watcher->wake_fds[1], &wake, 1) != 1) {
+        fprintf(stderr, "Could not stop watching [%s].\n", watcher->filename);
+        return;
+    }
+
+    pthread_join(watcher->thread, NULL);
+    free_watcher(watcher);
+}
@@ -0,0 +1,52 @@
+#ifndef WATCHER_H
+#define WATCHER_H 1
+
+#include <pthread.h>
+
+#include "ICs.h"
+#include "reload.h"
+
+// NOTE(erick): Watches the ics_list file with inotify from a thread of its
+//  own. The directory is watched instead of the file, since editors usually
+//  save by writing a new file and renaming it over the old one. Every time the
+//  file is written the thread reads it, works out what changed (see reload.h)
+//  and posts an SDL event with the IcsListReload, so the main loop only has to
+//  merge the parsed ICs in.
+//
+// The changes are worked out against the version of the file the list has.
+//  Only one reload is posted at a time and the receiver hands it back with
+//  finish_ics_list_reload, saying whether it was applied. Only then the
+//  snapshot moves to the new version, and the changes made in the meantime are
+//  worked out against it.
+
+typedef struct {
+    char* filename;
+    char* directory;
+    char* basename;
+
+    // NOTE(erick): Only the thread uses it, the messages go to stderr.
+    ProjectContext context;
+
+    int inotify_fd;
+    // NOTE(erick): Writing to it wakes the thread up to quit.
+    int wake_fds[2];
+
+    // NOTE(erick): lock guards everything below.
+    pthread_mutex_t lock;
+    pthread_cond_t finished;
+    // NOTE(erick): The version of the file the list has.
+    IcsListSnapshot snapshot;
+    bool is_pending;
+    bool quit;
+
+    // NOTE(erick): SDL user event type. Its data1 is an IcsListReload the
+    //  receiver hands back and then frees.
+    uint32 event_type;
+    pthread_t thread;
+} IcsListWatcher;
+
+bool start_ics_list_watcher(IcsListWatcher*, char*);
+void finish_ics_list_reload(IcsListWatcher*, IcsListReload*, bool);
+void stop_ics_list_watcher(IcsListWatcher*);
+
+#endif
@@ -0,0 +1,324 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bread_placer.h"
+#include "workload.h"
+
+// NOTE(erick): We carry our own generator instead of rand() so the same seed
+//  gives the same files on every machine and libc.
+typedef struct {
+    uint64 state;
+} Random;
+
+static uint64 next_random(Random* random) {
+    // NOTE(erick): splitmix64.
+    uint64 z = (random->state += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+
+    return z ^ (z >> 31);
+}
+
+static uint random_below(Random* random, uint limit) {
+    return (uint) (next_random(random) % limit);
+}
+
+static float random_unit(Random* random) {
+    return (float) (next_random(random) >> 40) / (float) (1 << 24);
+}
+
+static const char* codes_8[]  = {"NE555", "LM358", "24LC256", "ATtiny85"};
+static const char* codes_14[] = {"74HC00", "74HC04", "74HC08", "74HC14",
+                                 "74HC32", "74HC74", "74HC86"};
+static const char* codes_16[] = {"74HC138", "74HC161", "74HC595", "CD4051"};
+static const char* codes_20[] = {"74HC245", "74HC273", "74HC574"};
+
+#define sizeof_array(array) (sizeof(array)/sizeof(array[0]))
+
+static const char* code_for(Random* random, uint n_pins) {
+    switch(n_pins) {
+    case 8:  return codes_8[random_below(random, sizeof_array(codes_8))];
+    case 14: return codes_14[random_below(random, sizeof_array(codes_14))];
+    case 16: return codes_16[random_below(random, sizeof_array(codes_16))];
+    case 20: return codes_20[random_below(random, sizeof_array(codes_20))];
+    default: return "GENERIC";
+    }
+}
+
+WorkloadParams default_workload_params() {
+    WorkloadParams result = {};
+
+    result.n_ics = 100;
+
+    result.n_pin_classes = 4;
+    result.pin_counts[0] = 8;  result.pin_weights[0] = 2.0f;
+    result.pin_counts[1] = 14; result.pin_weights[1] = 4.0f;
+    result.pin_counts[2] = 16; result.pin_weights[2] = 3.0f;
+    result.pin_counts[3] = 20; result.pin_weights[3] = 1.0f;
+
+    result.net_fanout = 3.0f;
+    result.occupancy = 0.75f;
+    result.outside_ratio = 0.1f;
+    result.not_connected_ratio = 0.02f;
+
+    result.seed = 1;
+
+    return result;
+}
+
+// NOTE(erick): The format is a comma separated list of pins[:weight], e.g.
+//  "8:2,14:4,16" . The weight defaults to 1.
+bool parse_pin_distribution(char* text, WorkloadParams* params) {
+    uint n_classes = 0;
+    char* cursor = text;
+
+    while(*cursor) {
+        if(n_classes == MAX_PIN_CLASSES) { return false; }
+
+        char* end;
+        long pins = strtol(cursor, &end, 10);
+        if(end == cursor || pins < 2 || pins > 128 || pins % 2) { return false; }
+        cursor = end;
+
+        float weight = 1.0f;
+        if(*cursor == ':') {
+            cursor++;
+            weight = strtof(cursor, &end);
+            if(end == cursor || weight <= 0.0f) { return false; }
+            cursor = end;
+        }
+
+        params->pin_counts[n_classes] = (uint) pins;
+        params->pin_weights[n_classes] = weight;
+        n_classes++;
+
+        if(*cursor == ',') {
+            cursor++;
+        } else if(*cursor) {
+            return false;
+        }
+    }
+
+    if(!n_classes) { return false; }
+
+    params->n_pin_classes = n_classes;
+    return true;
+}
+
+static uint pick_pin_count(Random* random, WorkloadParams* params) {
+    float total = 0.0f;
+    for(uint i = 0; i < params->n_pin_classes; i++) {
+        total += params->pin_weights[i];
+    }
+
+    float choice = random_unit(random) * total;
+    for(uint i = 0; i < params->n_pin_classes; i++) {
+        if(choice < params->pin_weights[i]) { return params->pin_counts[i]; }
+        choice -= params->pin_weights[i];
+    }
+
+    return params->pin_counts[params->n_pin_classes - 1];
+}
+
+static uint64 rows_mask(uint first_row, uint height) {
+    uint64 mask = height >= 64 ? ~0ull : ((1ull << height) - 1);
+    return mask << (first_row - 1);
+}
+
+static void place_ics(Random* random, Workload* workload, float occupancy) {
+    uint rows_to_fill = (uint) (occupancy * 3 * 64 + 0.5f);
+    uint rows_filled = 0;
+    uint64 used_rows[3] = {0, 0, 0};
+
+    uint* order = (uint*) malloc(workload->n_ics * sizeof(uint));
+    for(uint i = 0; i < workload->n_ics; i++) { order[i] = i; }
+
+    for(uint i = workload->n_ics; i > 1; i--) {
+        uint j = random_below(random, i);
+        uint tmp = order[i - 1];
+        order[i - 1] = order[j];
+        order[j] = tmp;
+    }
+
+    for(uint i = 0; i < workload->n_ics && rows_filled < rows_to_fill; i++) {
+        WorkloadIC* ic = workload->ics + order[i];
+        uint height = ic->n_pins / 2;
+
+        if(height > 64) { continue; }
+        if(rows_filled + height > rows_to_fill) { continue; }
+
+        // NOTE(erick): Random probing is good enough while the board is not
+        //  close to full. When it is, the remaining ICs just stay outside.
+        for(uint attempt = 0; attempt < 64; attempt++) {
+            uint column = 1 + random_below(random, 3);
+            uint first_row = 1 + random_below(random, 64 - height + 1);
+            uint64 mask = rows_mask(first_row, height);
+
+            if(used_rows[column - 1] & mask) { continue; }
+
+            used_rows[column - 1] |= mask;
+            rows_filled += height;
+
+            ic->location.column = column;
+            if(random_below(random, 2)) {
+                ic->location.orientation = DOWN;
+                ic->location.row = first_row + height - 1;
+            } else {
+                ic->location.orientation = UP;
+                ic->location.row = first_row;
+            }
+
+            workload->n_placed++;
+            break;
+        }
+    }
+
+    free(order);
+}
+
+Workload generate_workload(WorkloadParams* params) {
+    Workload result = {};
+    Random random = {.state = params->seed};
+
+    result.n_ics = params->n_ics;
+    result.ics = (WorkloadIC*) calloc(result.n_ics, sizeof(WorkloadIC));
+
+    uint signal_pins = 0;
+    for(uint ic_index = 0; ic_index < result.n_ics; ic_index++) {
+        WorkloadIC* ic = result.ics + ic_index;
+
+        ic->n_pins = pick_pin_count(&random, params);
+        ic->code = code_for(&random, ic->n_pins);
+        ic->labels = (int32*) malloc(ic->n_pins * sizeof(int32));
+        ic->goes_outside = (bool*) malloc(ic->n_pins * sizeof(bool));
+
+        // NOTE(erick): Signal pins are numbered later, once we know how many
+        //  nets there are.
+        for(uint pin = 0; pin < ic->n_pins; pin++) {
+            if(pin == ic->n_pins - 1) {
+                ic->labels[pin] = LABEL_VCC;
+            } else if(pin == ic->n_pins / 2 - 1) {
+                ic->labels[pin] = LABEL_GND;
+            } else if(random_unit(&random) < params->not_connected_ratio) {
+                ic->labels[pin] = LABEL_NOT_CONNECTED;
+            } else {
+                ic->labels[pin] = 0;
+                signal_pins++;
+            }
+
+            ic->goes_outside[pin] = random_unit(&random) < params->outside_ratio;
+        }
+    }
+
+    float fanout = params->net_fanout < 1.0f ? 1.0f : params->net_fanout;
+    result.n_nets = (uint) (signal_pins / fanout + 0.5f);
+    if(!result.n_nets) { result.n_nets = 1; }
+
+    for(uint ic_index = 0; ic_index < result.n_ics; ic_index++) {
+        WorkloadIC* ic = result.ics + ic_index;
+
+        for(uint pin = 0; pin < ic->n_pins; pin++) {
+            if(ic->labels[pin] == 0) {
+                ic->labels[pin] = (int32) random_below(&random, result.n_nets);
+            }
+        }
+    }
+
+    place_ics(&random, &result, params->occupancy);
+
+    return result;
+}
+
+void free_workload(Workload* workload) {
+    for(uint ic_index = 0; ic_index < workload->n_ics; ic_index++) {
+        free(workload->ics[ic_index].labels);
+        free(workload->ics[ic_index].goes_outside);
+    }
+
+    free(workload->ics);
+    workload->ics = NULL;
+    workload->n_ics = 0;
+}
+
+void write_ics_list(FILE* file, Workload* workload) {
+    for(uint ic_index = 0; ic_index < workload->n_ics; ic_index++) {
+        WorkloadIC* ic = workload->ics + ic_index;
+
+        fprintf(file, "IC %u\n", ic->n_pins);
+        fprintf(file, "Name U%u\n", ic_index + 1);
+        fprintf(file, "Code %s\n", ic->code);
+        fprintf(file, "Pins\n");
+
+        for(uint pin = 0; pin < ic->n_pins; pin++) {
+            char marker = ic->goes_outside[pin] ? '#' : '*';
+            int32 label = ic->labels[pin];
+
+            switch(label) {
+            case LABEL_VCC:
+                fprintf(file, "%c%u VCC\n", marker, pin + 1);
+                break;
+            case LABEL_GND:
+                fprintf(file, "%c%u GND\n", marker, pin + 1);
+                break;
+            case LABEL_NOT_CONNECTED:
+                fprintf(file, "%c%u N.C.\n", marker, pin + 1);
+                break;
+            default:
+                fprintf(file, "%c%u NET_%d\n", marker, pin + 1, label);
+            }
+        }
+
+        fprintf(file, "\n");
+    }
+}
+
+// NOTE(erick): The ids are the ones the editor gives the ICs write_ics_list
+//  wrote, so the file is what saving the project would write.
+void write_project(FILE* file, Workload* workload) {
+    ICList list = {};
+    list.data = (IC*) calloc(workload->n_ics ? workload->n_ics : 1, sizeof(IC));
+    list.count = workload->n_ics;
+    list.capacity = workload->n_ics;
+
+    char name[16];
+    for(uint ic_index = 0; ic_index < workload->n_ics; ic_index++) {
+        IC* ic = list.data + ic_index;
+
+        snprintf(name, sizeof(name), "U%u", ic_index + 1);
+        ic->name = strdup(name);
+        ic->code = (char*) workload->ics[ic_index].code;
+        ic->n_pins = workload->ics[ic_index].n_pins;
+    }
+
+    assign_ic_ids(&list);
+
+    for(uint ic_index = 0; ic_index < workload->n_ics; ic_index++) {
+        BreadboardLocation location = workload->ics[ic_index].location;
+
+        fprintf(file, "@%016llx: {%d, %d, %d}\n", (unsigned long long) list.data[ic_index].id,
+                location.column, location.row, location.orientation);
+        free(list.data[ic_index].name);
+    }
+
+    free(list.data);
+}
+
+// NOTE(erick): The format from before the ids, a line per IC keyed by its
+//  position in the ics_list file. The editor still reads it.
+void write_legacy_project(FILE* file, Workload* workload) {
+    for(uint ic_index = 0; ic_index < workload->n_ics; ic_index++) {
+        BreadboardLocation location = workload->ics[ic_index].location;
+
+        fprintf(file, "%d: {%d, %d, %d}\n", ic_index, location.column,
+                location.row, location.orientation);
+    }
+}
+
+void place_workload(Workload* workload, ICList list) {
+    usize count = list.count < workload->n_ics ? list.count : workload->n_ics;
+
+    for(usize ic_index = 0; ic_index < count; ic_index++) {
+        list.data[ic_index].location = workload->ics[ic_index].location;
+    }
+}
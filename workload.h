@@ -0,0 +1,64 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H 1
+
+#include <stdio.h>
+
+#include "ICs.h"
+
+#define MAX_PIN_CLASSES 8
+
+// NOTE(erick): Pin labels are generated as numbers. Non-negative values are
+//  signal nets (NET_<n>), the negative ones are the special labels.
+#define LABEL_VCC           -1
+#define LABEL_GND           -2
+#define LABEL_NOT_CONNECTED -3
+
+typedef struct {
+    uint n_ics;
+
+    // NOTE(erick): Pin-count distribution. Each IC picks one of the pin counts
+    //  with probability proportional to its weight.
+    uint n_pin_classes;
+    uint pin_counts[MAX_PIN_CLASSES];
+    float pin_weights[MAX_PIN_CLASSES];
+
+    // NOTE(erick): Average number of pins on each signal net.
+    float net_fanout;
+    // NOTE(erick): Fraction of the 3 * 64 board rows covered by placed ICs.
+    float occupancy;
+    // NOTE(erick): Fraction of pins marked with '#' (goes outside).
+    float outside_ratio;
+    // NOTE(erick): Fraction of signal pins labeled N.C.
+    float not_connected_ratio;
+
+    uint64 seed;
+} WorkloadParams;
+
+typedef struct {
+    uint n_pins;
+    int32* labels;
+    bool* goes_outside;
+    const char* code;
+
+    BreadboardLocation location;
+} WorkloadIC;
+
+typedef struct {
+    WorkloadIC* ics;
+    uint n_ics;
+    uint n_nets;
+    uint n_placed;
+} Workload;
+
+WorkloadParams default_workload_params();
+bool parse_pin_distribution(char*, WorkloadParams*);
+
+Workload generate_workload(WorkloadParams*);
+void free_workload(Workload*);
+
+void write_ics_list(FILE*, Workload*);
+void write_project(FILE*, Workload*);
+void write_legacy_project(FILE*, Workload*);
+void place_workload(Workload*, ICList);
+
+#endif